@@ -0,0 +1,164 @@
+// AnnuityFactorCache Class Implementation
+
+#include "AnnuityFactorCache.h"
+#include "AnnuityMath.h"
+#include <bit>
+#include <functional>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+/*
+    Hash Key
+
+    Programmer's Note:
+        - splitmix64 finalizer over the rate bits combined with the term; spreads the
+          near-identical bit patterns of neighbouring rates across the table.
+
+    Simpler Terms:
+        Turns a rate and term into a table position.
+ */
+uint64_t hashKey(uint64_t rateBits, int32_t payments) {
+    uint64_t x = rateBits ^ (static_cast<uint64_t>(static_cast<uint32_t>(payments)) * 0x9E3779B97F4A7C15ull);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/*
+    Compute Factor
+
+    Programmer's Note:
+        - annuity_math::paymentFactor, the factor Mortgage itself multiplies by.
+
+    Simpler Terms:
+        The payment for each dollar borrowed, worked out from scratch.
+ */
+double computeFactor(double monthlyRate, int payments) {
+    return annuity_math::paymentFactor(monthlyRate, payments);
+}
+
+} // namespace
+
+/*
+    Constructor
+
+    Programmer's Note:
+        - Allocates the whole table up front; capacity is rounded up to a power of two.
+
+    Simpler Terms:
+        Creates an empty cache with room for a fixed number of rate/term pairs.
+ */
+AnnuityFactorCache::AnnuityFactorCache(size_t capacity) {
+    capacity = bit_ceil(capacity < MAX_PROBES ? MAX_PROBES : capacity);
+    mask = capacity - 1;
+    slots = make_unique<Slot[]>(capacity);
+}
+
+/*
+    Stripe
+
+    Programmer's Note:
+        - Each thread always uses the same counter stripe, chosen from its thread id.
+
+    Simpler Terms:
+        Picks which set of counters this thread updates.
+ */
+AnnuityFactorCache::CounterStripe& AnnuityFactorCache::stripe() {
+    thread_local const size_t index = hash<thread::id>{}(this_thread::get_id()) % STRIPES;
+    return stripes[index];
+}
+
+/*
+    Payment Factor
+
+    Programmer's Note:
+        - Probes up to MAX_PROBES slots. A READY slot with the same key is a hit; an EMPTY
+          slot ends the search and is claimed (CAS EMPTY -> BUSY) for the new entry.
+        - A slot another thread is still filling (BUSY) is skipped; at worst the factor
+          is computed twice, never read half-written.
+
+    Simpler Terms:
+        Looks the factor up, and stores it for next time if it wasn't there yet.
+ */
+double AnnuityFactorCache::paymentFactor(double monthlyRate, int payments) {
+    const uint64_t rateBits = bit_cast<uint64_t>(monthlyRate);
+    const size_t start = static_cast<size_t>(hashKey(rateBits, payments));
+
+    for (size_t probe = 0; probe < MAX_PROBES; ++probe) {
+        Slot& slot = slots[(start + probe) & mask];
+        uint32_t state = slot.state.load(memory_order_acquire);
+
+        if (state == READY) {
+            if (slot.rate_bits == rateBits && slot.payments == payments) {
+                stripe().hits.fetch_add(1, memory_order_relaxed);
+                return slot.factor;
+            }
+            continue;
+        }
+
+        if (state == EMPTY && slot.state.compare_exchange_strong(state, BUSY, memory_order_acquire)) {
+            const double factor = computeFactor(monthlyRate, payments);
+            slot.rate_bits = rateBits;
+            slot.payments = payments;
+            slot.factor = factor;
+            slot.state.store(READY, memory_order_release);
+
+            entry_count.fetch_add(1, memory_order_relaxed);
+            stripe().misses.fetch_add(1, memory_order_relaxed);
+            return factor;
+        }
+        // BUSY (or lost the race to claim it): keep probing
+    }
+
+    // No free slot within reach: compute without caching
+    CounterStripe& counters = stripe();
+    counters.misses.fetch_add(1, memory_order_relaxed);
+    counters.rejected.fetch_add(1, memory_order_relaxed);
+    return computeFactor(monthlyRate, payments);
+}
+
+/*
+    Stats
+
+    Programmer's Note:
+        - Sums the counter stripes.
+
+    Simpler Terms:
+        Reports hits, misses and size.
+ */
+AnnuityFactorCache::Stats AnnuityFactorCache::stats() const {
+    Stats result{};
+    for (const CounterStripe& counters : stripes) {
+        result.hits += counters.hits.load(memory_order_relaxed);
+        result.misses += counters.misses.load(memory_order_relaxed);
+        result.rejected += counters.rejected.load(memory_order_relaxed);
+    }
+    result.entries = entry_count.load(memory_order_relaxed);
+    result.capacity = mask + 1;
+    result.memory_bytes = (mask + 1) * sizeof(Slot) + sizeof(*this);
+    return result;
+}
+
+/*
+    Clear
+
+    Programmer's Note:
+        - Resets every slot and counter; callers must ensure no lookups are running.
+
+    Simpler Terms:
+        Forgets everything the cache remembered.
+ */
+void AnnuityFactorCache::clear() {
+    for (size_t i = 0; i <= mask; ++i) {
+        slots[i].state.store(EMPTY, memory_order_relaxed);
+    }
+    for (CounterStripe& counters : stripes) {
+        counters.hits.store(0, memory_order_relaxed);
+        counters.misses.store(0, memory_order_relaxed);
+        counters.rejected.store(0, memory_order_relaxed);
+    }
+    entry_count.store(0, memory_order_relaxed);
+}
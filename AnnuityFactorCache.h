@@ -0,0 +1,103 @@
+// AnnuityFactorCache Class Specification
+
+#ifndef ANNUITY_FACTOR_CACHE_H
+#define ANNUITY_FACTOR_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/*
+    Class: AnnuityFactorCache
+
+    Programmer's Note:
+        - Memoizes the payment factor  r * F / (F - 1),  F = (1 + r)^n  per (monthly rate, n),
+          so pricing a loan becomes one lookup and one multiply: payment = principal * factor.
+        - Fixed-capacity open-addressing table (power of two, linear probing); memory never
+          grows after construction. When a probe sequence is full the factor is computed
+          and returned without being stored.
+        - Lock-free and safe to share between threads: a slot is claimed with one CAS and
+          published with a release store; readers never block and never see half-written
+          entries. Entries are never removed, except by clear(), which must not run
+          concurrently with lookups.
+        - Hit/miss counters are striped across cache lines to avoid contention.
+        - The factor is annuity_math::paymentFactor, so principal * factor is exactly
+          Mortgage::getMonthlyPayment().
+
+    Simpler Terms:
+        Remembers the "payment per dollar borrowed" for each rate and term,
+        so loans that share a rate and term don't repeat the expensive math.
+ */
+class AnnuityFactorCache {
+public:
+    /*
+        Cache Statistics
+
+        Programmer's Note:
+            - Snapshot of the counters; values from concurrent threads may be slightly stale.
+
+        Simpler Terms:
+            How often the cache helped, and how big it is.
+     */
+    struct Stats {
+        std::uint64_t hits;             // Lookups answered from the table
+        std::uint64_t misses;           // Lookups that computed the factor
+        std::uint64_t rejected;         // Misses that could not be stored (probe sequence full)
+        std::size_t entries;            // Stored (rate, term) pairs
+        std::size_t capacity;           // Maximum number of entries
+        std::size_t memory_bytes;       // Memory used by the table
+    };
+
+    explicit AnnuityFactorCache(std::size_t capacity = 4096);   // Rounded up to a power of two
+
+    AnnuityFactorCache(const AnnuityFactorCache&) = delete;
+    AnnuityFactorCache& operator=(const AnnuityFactorCache&) = delete;
+
+    /*
+        Lookups
+
+        Programmer's Note:
+            - monthlyRate is a decimal monthly rate (annual percentage / 100 / 12, as Mortgage stores it).
+            - n == 0 gives a factor of 0 and r == 0 gives 1 / n, matching Mortgage::getMonthlyPayment().
+
+        Simpler Terms:
+            Get the payment per dollar borrowed, or the payment for a whole loan.
+     */
+    [[nodiscard]] double paymentFactor(double monthlyRate, int payments);
+
+    [[nodiscard]] double monthlyPayment(double principal, double monthlyRate, int payments) {
+        return principal * paymentFactor(monthlyRate, payments);
+    }
+
+    [[nodiscard]] Stats stats() const;
+    void clear();   // Empties the table and counters (not safe during concurrent lookups)
+
+private:
+    static constexpr std::size_t MAX_PROBES = 16;   // Slots examined before giving up
+    static constexpr std::size_t STRIPES = 16;      // Counter stripes
+
+    enum SlotState : std::uint32_t { EMPTY = 0, BUSY = 1, READY = 2 };
+
+    struct Slot {
+        std::atomic<std::uint32_t> state{EMPTY};
+        std::int32_t payments = 0;
+        std::uint64_t rate_bits = 0;
+        double factor = 0.0;
+    };
+
+    struct alignas(64) CounterStripe {
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> misses{0};
+        std::atomic<std::uint64_t> rejected{0};
+    };
+
+    std::size_t mask;                           // capacity - 1
+    std::unique_ptr<Slot[]> slots;
+    CounterStripe stripes[STRIPES];
+    std::atomic<std::size_t> entry_count{0};
+
+    CounterStripe& stripe();
+};
+
+#endif // ANNUITY_FACTOR_CACHE_H
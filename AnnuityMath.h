@@ -0,0 +1,111 @@
+// Annuity Math Specification
+
+#ifndef ANNUITY_MATH_H
+#define ANNUITY_MATH_H
+
+#include "ConstexprMath.h"
+#include <cmath>
+
+/*
+    Namespace: annuity_math
+
+    Programmer's Note:
+        - The payment factor  r / (1 - (1 + r)^-n)  is the level monthly payment per dollar
+          borrowed at monthly rate r over n payments (the textbook r F / (F - 1), F = (1 + r)^n).
+          Mortgage::getMonthlyPayment(), the batch kernels, AnnuityFactorCache and the inverse
+          solvers all price through this namespace.
+        - n == 0 gives 0 (no payments). |r| < SMALL_RATE, r == 0 included, gives 1 / n: the
+          limit as r -> 0, an interest-free loan repaid in n equal parts.
+        - paymentFactor() is the run-time fast path. Evaluating r F / (F - 1) with
+          std::pow(1 + r, n) loses accuracy in two places. First, 1 + r is rounded before it
+          is raised to the n-th power, which puts up to n/2 ULP of error into F. Ordinary
+          loans end up 100-300 ULP off, and low rates far more. Second, F - 1 cancels when
+          F is close to 1. The fast path avoids both:
+            * G = pow(1 + r, -n) is corrected to first order for the rounding of 1 + r: with
+              e = r - ((1 + r) - 1), exactly that rounding error, the exact value is about
+              G (1 - n e). (The exact correction divides n e by 1 + r; leaving that out costs
+              under half an ULP, since n r is about ln(1 / G), and saves a division.)
+            * While G <= CANCELLATION_LIMIT, 1 - G loses at most three bits, so the factor
+              is r / (1 - G). That covers every loan at 2% and above for 10 years or more.
+            * Above the limit (low rates, short terms) 1 - G = -expm1(-n * log1p(r)) is
+              evaluated directly, at about twice the cost of pow.
+          The payment is within a few ULP of the exact one for the double r (5 at most in
+          mortgage_bench, against several hundred for the old formula on ordinary loans).
+          The common case costs one pow, a few flops and one branch, within a few percent
+          of the old formula; the special cases are only tested once that branch fails.
+        - paymentFactorExtended() evaluates the formula in double-double arithmetic (~106 bits)
+          from the exact sum 1 + r. The result is the correctly rounded factor unless the exact
+          value lies within ~1e-29 (relative) of a rounding boundary. monthlyPaymentExtended()
+          also multiplies by the principal in double-double, so the payment is rounded once.
+          Both are constexpr: compile-time loans use them. At run time they are the audit
+          mode, several times slower than the fast path.
+
+    Simpler Terms:
+        The "payment per dollar borrowed" behind every price the calculator gives: a fast
+        version that is right to the last digit or two, and a slower, exact one for checking.
+ */
+namespace annuity_math {
+
+inline constexpr double SMALL_RATE = 1e-100;         // Below this, (1 + r)^n - 1 == n * r to far beyond double precision
+inline constexpr double CANCELLATION_LIMIT = 0.875;  // Largest (1 + r)^-n priced as r / (1 - G)
+
+// Double-double factor; 'payments' must not be 0
+constexpr constexpr_math::DoubleDouble paymentFactorDoubleDouble(double monthlyRate, int payments) {
+    using namespace constexpr_math;
+
+    if (monthlyRate < SMALL_RATE && monthlyRate > -SMALL_RATE) {
+        return divide({ 1.0, 0.0 }, { static_cast<double>(payments), 0.0 });
+    }
+
+    const bool negative = payments < 0;
+    const unsigned exponent = negative ? 0u - static_cast<unsigned>(payments) : static_cast<unsigned>(payments);
+    const DoubleDouble power = powDoubleDouble(twoSum(1.0, monthlyRate), exponent);  // (1 + r)^|n|, exact base
+    if (!negative && power.hi >= 0x1p1000) {
+        return { monthlyRate, 0.0 };                // (1 + r)^-n is below double precision: the factor is r
+    }
+
+    const DoubleDouble growth = add(power, { -1.0, 0.0 });          // (1 + r)^|n| - 1, no cancellation
+    return negative ? divide({ -monthlyRate, 0.0 }, growth)          // r / (1 - (1 + r)^|n|)
+                    : divide(multiply({ monthlyRate, 0.0 }, power), growth);  // r F / (F - 1)
+}
+
+constexpr double paymentFactorExtended(double monthlyRate, int payments) {
+    if (payments == 0) {
+        return 0.0;
+    }
+    const constexpr_math::DoubleDouble factor = paymentFactorDoubleDouble(monthlyRate, payments);
+    return factor.hi + factor.lo;
+}
+
+constexpr double monthlyPaymentExtended(double principal, double monthlyRate, int payments) {
+    if (payments == 0) {
+        return 0.0;
+    }
+    const constexpr_math::DoubleDouble payment =
+        constexpr_math::multiply(paymentFactorDoubleDouble(monthlyRate, payments), { principal, 0.0 });
+    return payment.hi + payment.lo;
+}
+
+inline double paymentFactor(double monthlyRate, int payments) {
+    const double n = payments;
+    const double base = 1 + monthlyRate;
+    const double discount = std::pow(base, -n);        // (1 + r)^-n of the rounded base
+    if (discount <= CANCELLATION_LIMIT) {
+        // (1 + r)^-n == discount * (1 - drift) to first order, where drift = n * (rounding error of 1 + r)
+        const double drift = n * (monthlyRate - (base - 1));
+        return monthlyRate / ((1 - discount) + discount * drift);
+    }
+
+    // Low rates and short terms; n == 0 and |r| < SMALL_RATE also land here (discount == 1)
+    if (payments == 0) {
+        return 0.0;
+    }
+    if (std::fabs(monthlyRate) < SMALL_RATE) {
+        return 1.0 / payments;
+    }
+    return monthlyRate / -std::expm1(-n * std::log1p(monthlyRate));
+}
+
+} // namespace annuity_math
+
+#endif // ANNUITY_MATH_H
@@ -0,0 +1,362 @@
+// Adjustable-Rate Mortgage Engine Implementation
+
+#include "ArmEngine.h"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MORTGAGE_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr size_t TILE_PATHS = 256;      // Paths whose state is kept together (~17 KiB, fits L1)
+constexpr size_t LANE_GROUP = 32;       // Tiles are padded to a multiple of this many lanes
+
+/*
+    Reset Rules
+
+    Programmer's Note:
+        - isResetMonth: months are 1-based; the first reset is the month after the fixed period.
+        - nextResetMonth: first reset month after 'month', or lastMonth + 1 if none.
+        - resetRate: index + margin, then the periodic (or initial) cap, the lifetime cap,
+          and the floor, in that order.
+
+    Simpler Terms:
+        When the rate changes, and what it changes to.
+ */
+bool isResetMonth(const ArmTerms& terms, int month) {
+    return month > terms.initial_fixed_months
+        && (month - terms.initial_fixed_months - 1) % terms.reset_interval_months == 0;
+}
+
+int nextResetMonth(const ArmTerms& terms, int month, int lastMonth) {
+    int next = terms.initial_fixed_months + 1;
+    if (month >= next) {
+        next += ((month - next) / terms.reset_interval_months + 1) * terms.reset_interval_months;
+    }
+    return min(next, lastMonth + 1);
+}
+
+double resetRate(const ArmTerms& terms, double previousRate, double indexRate, bool firstReset) {
+    const double cap = firstReset ? terms.initial_cap_percent : terms.periodic_cap_percent;
+    double rate = min(max(indexRate + terms.margin_percent, previousRate - cap), previousRate + cap);
+    rate = min(rate, terms.initial_rate_percent + terms.lifetime_cap_percent);
+    return max(rate, terms.floor_percent);
+}
+
+// Percentage -> monthly decimal, exactly as Mortgage::setAnnualInterestRate does it
+double monthlyRate(double ratePercent) {
+    return ratePercent / 100.0 / 12.0;
+}
+
+/*
+    Validate
+
+    Programmer's Note:
+        - Checks the terms, the matrix shape and the output sizes before any work is done.
+
+    Simpler Terms:
+        Makes sure the loan rules and the tables are usable.
+ */
+bool validate(const ArmTerms& terms, const RatePathMatrix& paths, const ArmPathOutputs& out) {
+    if (terms.total_years_to_repay <= 0 || terms.initial_fixed_months < 0 || terms.reset_interval_months <= 0
+        || terms.initial_cap_percent < 0 || terms.periodic_cap_percent < 0 || terms.lifetime_cap_percent < 0) {
+        cerr << "ERROR: Invalid ARM terms (term, fixed period, reset interval and caps must be valid)." << endl;
+        return false;
+    }
+    if (paths.months < terms.total_years_to_repay * 12
+        || paths.index_rates.size() < static_cast<size_t>(paths.months) * paths.path_count) {
+        cerr << "ERROR: Rate path matrix does not cover the loan term." << endl;
+        return false;
+    }
+    if (out.total_interest.size() < paths.path_count || out.total_paid.size() < paths.path_count
+        || out.max_payment.size() < paths.path_count) {
+        cerr << "ERROR: ARM output arrays are smaller than the number of paths." << endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+    Struct: PathTile
+
+    Programmer's Note:
+        - Structure-of-arrays state for up to TILE_PATHS paths, 64-byte aligned.
+
+    Simpler Terms:
+        The running numbers for a group of rate scenarios.
+ */
+struct alignas(64) PathTile {
+    double balance[TILE_PATHS];
+    double rate_percent[TILE_PATHS];
+    double monthly_rate[TILE_PATHS];
+    double payment[TILE_PATHS];
+    double interest[TILE_PATHS];
+    double paid[TILE_PATHS];
+    double max_payment[TILE_PATHS];
+    int32_t remaining[TILE_PATHS];
+};
+
+/*
+    Amortize Months (Scalar)
+
+    Programmer's Note:
+        - The reference monthly step, for 'lanes' paths over 'months' months:
+              interest = r * balance;  balance -= payment - interest;  clamp at zero
+          exactly as Mortgage::outputPaymentSchedule does it.
+
+    Simpler Terms:
+        Pays the loan down month by month for every scenario in the group.
+ */
+void amortizeMonthsScalar(PathTile& tile, size_t lanes, int months) {
+    for (int month = 0; month < months; ++month) {
+        for (size_t i = 0; i < lanes; ++i) {
+            const double interest = tile.monthly_rate[i] * tile.balance[i];
+            tile.interest[i] += interest;
+            tile.balance[i] -= tile.payment[i] - interest;
+            if (tile.balance[i] < 0.0) tile.balance[i] = 0.0;
+            tile.paid[i] += tile.payment[i];
+        }
+    }
+}
+
+#ifdef MORTGAGE_X86_DISPATCH
+
+/*
+    Amortize Months (AVX2 / AVX-512)
+
+    Programmer's Note:
+        - Same step as the scalar loop, 4 or 8 paths per register. Four registers of paths
+          are advanced together so the month-to-month dependency chains overlap; the state
+          stays in registers for the whole stretch between two resets.
+        - 'lanes' is always a multiple of LANE_GROUP (32).
+
+    Simpler Terms:
+        Pays down 16 or 32 scenarios at a time using wide CPU registers.
+ */
+__attribute__((target("avx2,fma")))
+void amortizeMonthsAvx2(PathTile& tile, size_t lanes, int months) {
+    constexpr int VECTORS = 4;
+    const __m256d zero = _mm256_setzero_pd();
+
+    for (size_t i = 0; i < lanes; i += 4 * VECTORS) {
+        __m256d balance[VECTORS], rate[VECTORS], payment[VECTORS], interest[VECTORS], paid[VECTORS];
+        for (int v = 0; v < VECTORS; ++v) {
+            balance[v] = _mm256_load_pd(tile.balance + i + 4 * v);
+            rate[v] = _mm256_load_pd(tile.monthly_rate + i + 4 * v);
+            payment[v] = _mm256_load_pd(tile.payment + i + 4 * v);
+            interest[v] = _mm256_load_pd(tile.interest + i + 4 * v);
+            paid[v] = _mm256_load_pd(tile.paid + i + 4 * v);
+        }
+
+        for (int month = 0; month < months; ++month) {
+            for (int v = 0; v < VECTORS; ++v) {
+                const __m256d charge = _mm256_mul_pd(rate[v], balance[v]);
+                interest[v] = _mm256_add_pd(interest[v], charge);
+                balance[v] = _mm256_max_pd(_mm256_sub_pd(balance[v], _mm256_sub_pd(payment[v], charge)), zero);
+                paid[v] = _mm256_add_pd(paid[v], payment[v]);
+            }
+        }
+
+        for (int v = 0; v < VECTORS; ++v) {
+            _mm256_store_pd(tile.balance + i + 4 * v, balance[v]);
+            _mm256_store_pd(tile.interest + i + 4 * v, interest[v]);
+            _mm256_store_pd(tile.paid + i + 4 * v, paid[v]);
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+void amortizeMonthsAvx512(PathTile& tile, size_t lanes, int months) {
+    constexpr int VECTORS = 4;
+    const __m512d zero = _mm512_setzero_pd();
+
+    for (size_t i = 0; i < lanes; i += 8 * VECTORS) {
+        __m512d balance[VECTORS], rate[VECTORS], payment[VECTORS], interest[VECTORS], paid[VECTORS];
+        for (int v = 0; v < VECTORS; ++v) {
+            balance[v] = _mm512_load_pd(tile.balance + i + 8 * v);
+            rate[v] = _mm512_load_pd(tile.monthly_rate + i + 8 * v);
+            payment[v] = _mm512_load_pd(tile.payment + i + 8 * v);
+            interest[v] = _mm512_load_pd(tile.interest + i + 8 * v);
+            paid[v] = _mm512_load_pd(tile.paid + i + 8 * v);
+        }
+
+        for (int month = 0; month < months; ++month) {
+            for (int v = 0; v < VECTORS; ++v) {
+                const __m512d charge = _mm512_mul_pd(rate[v], balance[v]);
+                interest[v] = _mm512_add_pd(interest[v], charge);
+                balance[v] = _mm512_max_pd(_mm512_sub_pd(balance[v], _mm512_sub_pd(payment[v], charge)), zero);
+                paid[v] = _mm512_add_pd(paid[v], payment[v]);
+            }
+        }
+
+        for (int v = 0; v < VECTORS; ++v) {
+            _mm512_store_pd(tile.balance + i + 8 * v, balance[v]);
+            _mm512_store_pd(tile.interest + i + 8 * v, interest[v]);
+            _mm512_store_pd(tile.paid + i + 8 * v, paid[v]);
+        }
+    }
+}
+
+#endif // MORTGAGE_X86_DISPATCH
+
+void amortizeMonths(PathTile& tile, size_t lanes, int months, SimdLevel level) {
+#ifdef MORTGAGE_X86_DISPATCH
+    if (level == SimdLevel::Avx512) {
+        amortizeMonthsAvx512(tile, lanes, months);
+        return;
+    }
+    if (level == SimdLevel::Avx2) {
+        amortizeMonthsAvx2(tile, lanes, months);
+        return;
+    }
+#endif
+    amortizeMonthsScalar(tile, lanes, months);
+}
+
+/*
+    Evaluate Tile
+
+    Programmer's Note:
+        - Paths [first, first + count). Padding lanes carry a zero balance and rate, so they
+          price to a zero payment and never affect real lanes.
+        - Between resets the tile runs through amortizeMonths; at each reset every path's
+          rate is capped and floored and the whole tile is re-amortized in one batch call.
+
+    Simpler Terms:
+        Runs the loan under one group of rate scenarios from start to finish.
+ */
+void evaluateTile(const ArmTerms& terms, const RatePathMatrix& paths, const ArmPathOutputs& out,
+                  size_t first, size_t count, SimdLevel level) {
+    PathTile tile{};    // Zeroed: computeMonthlyPayments reads whole tiles
+    const int lastMonth = terms.total_years_to_repay * 12;
+    const size_t lanes = (count + LANE_GROUP - 1) / LANE_GROUP * LANE_GROUP;
+    const double initialMonthlyRate = monthlyRate(terms.initial_rate_percent);
+
+    for (size_t i = 0; i < lanes; ++i) {
+        const bool active = i < count;
+        tile.balance[i] = active ? terms.loan_amount : 0.0;
+        tile.rate_percent[i] = terms.initial_rate_percent;
+        tile.monthly_rate[i] = active ? initialMonthlyRate : 0.0;
+        tile.remaining[i] = lastMonth;
+        tile.interest[i] = 0.0;
+        tile.paid[i] = 0.0;
+    }
+    computeMonthlyPayments(tile.balance, tile.monthly_rate, tile.remaining, tile.payment, lanes, level);
+    copy(tile.payment, tile.payment + lanes, tile.max_payment);
+
+    bool firstReset = true;
+    for (int month = 1; month <= lastMonth;) {
+        if (isResetMonth(terms, month)) {
+            const double* index = paths.index_rates.data() + static_cast<size_t>(month - 1) * paths.path_count + first;
+            for (size_t i = 0; i < count; ++i) {
+                tile.rate_percent[i] = resetRate(terms, tile.rate_percent[i], index[i], firstReset);
+                tile.monthly_rate[i] = monthlyRate(tile.rate_percent[i]);
+            }
+            fill(tile.remaining, tile.remaining + lanes, lastMonth - month + 1);
+            computeMonthlyPayments(tile.balance, tile.monthly_rate, tile.remaining, tile.payment, lanes, level);
+            for (size_t i = 0; i < lanes; ++i) {
+                tile.max_payment[i] = max(tile.max_payment[i], tile.payment[i]);
+            }
+            firstReset = false;
+        }
+
+        const int segmentEnd = nextResetMonth(terms, month, lastMonth);
+        amortizeMonths(tile, lanes, segmentEnd - month, level);
+        month = segmentEnd;
+    }
+
+    copy(tile.interest, tile.interest + count, out.total_interest.begin() + static_cast<ptrdiff_t>(first));
+    copy(tile.paid, tile.paid + count, out.total_paid.begin() + static_cast<ptrdiff_t>(first));
+    copy(tile.max_payment, tile.max_payment + count, out.max_payment.begin() + static_cast<ptrdiff_t>(first));
+}
+
+} // namespace
+
+/*
+    Evaluate ARM Paths
+
+    Programmer's Note:
+        - Serial: tiles in order. Pool: one tile per task; each tile writes only its own
+          slice of the outputs, so no synchronization is needed.
+
+    Simpler Terms:
+        Runs the loan under every rate scenario, on one core or on all of them.
+ */
+bool evaluateArmPaths(const ArmTerms& terms, const RatePathMatrix& paths, const ArmPathOutputs& out,
+                      SimdLevel level) {
+    if (!validate(terms, paths, out)) {
+        return false;
+    }
+
+    level = min(level, detectSimdLevel());
+    for (size_t first = 0; first < paths.path_count; first += TILE_PATHS) {
+        evaluateTile(terms, paths, out, first, min(TILE_PATHS, paths.path_count - first), level);
+    }
+    return true;
+}
+
+bool evaluateArmPaths(const ArmTerms& terms, const RatePathMatrix& paths, const ArmPathOutputs& out,
+                      WorkStealingPool& pool, SimdLevel level) {
+    if (!validate(terms, paths, out)) {
+        return false;
+    }
+
+    level = min(level, detectSimdLevel());
+    const size_t tiles = (paths.path_count + TILE_PATHS - 1) / TILE_PATHS;
+    pool.parallelFor(tiles, 1, [&](size_t firstTile, size_t lastTile) {
+        for (size_t t = firstTile; t < lastTile; ++t) {
+            const size_t first = t * TILE_PATHS;
+            evaluateTile(terms, paths, out, first, min(TILE_PATHS, paths.path_count - first), level);
+        }
+    });
+    return true;
+}
+
+/*
+    Evaluate ARM Path (Reference)
+
+    Programmer's Note:
+        - Straightforward month-by-month loop for a single path; payments come from the
+          scalar kernel (std::pow, identical to Mortgage::getMonthlyPayment).
+
+    Simpler Terms:
+        Runs the loan under one rate scenario, the simple way.
+ */
+ArmPathResult evaluateArmPath(const ArmTerms& terms, const RatePathMatrix& paths, size_t path) {
+    const int lastMonth = terms.total_years_to_repay * 12;
+    double balance = terms.loan_amount;
+    double ratePercent = terms.initial_rate_percent;
+    double rate = monthlyRate(ratePercent);
+    int32_t remaining = lastMonth;
+    double payment = 0.0;
+    computeMonthlyPayments(&balance, &rate, &remaining, &payment, 1, SimdLevel::Scalar);
+
+    ArmPathResult result;
+    result.max_payment = payment;
+    bool firstReset = true;
+
+    for (int month = 1; month <= lastMonth; ++month) {
+        if (isResetMonth(terms, month)) {
+            const double index = paths.index_rates[static_cast<size_t>(month - 1) * paths.path_count + path];
+            ratePercent = resetRate(terms, ratePercent, index, firstReset);
+            rate = monthlyRate(ratePercent);
+            remaining = lastMonth - month + 1;
+            computeMonthlyPayments(&balance, &rate, &remaining, &payment, 1, SimdLevel::Scalar);
+            result.max_payment = max(result.max_payment, payment);
+            firstReset = false;
+        }
+
+        const double interest = rate * balance;
+        result.total_interest += interest;
+        balance -= payment - interest;
+        if (balance < 0.0) balance = 0.0;
+        result.total_paid += payment;
+    }
+    return result;
+}
@@ -0,0 +1,114 @@
+// Adjustable-Rate Mortgage Engine Specification
+
+#ifndef ARM_ENGINE_H
+#define ARM_ENGINE_H
+
+#include "PaymentKernels.h"
+#include "WorkStealingPool.h"
+#include <cstddef>
+#include <span>
+
+/*
+    Struct: ArmTerms
+
+    Programmer's Note:
+        - Hybrid ARM: initial_rate_percent for the first initial_fixed_months, then a reset
+          every reset_interval_months (5/1 = 60 and 12, 7/6 = 84 and 6).
+        - At each reset the new rate is index + margin, limited to +/- initial_cap_percent
+          of the previous rate at the first reset and +/- periodic_cap_percent afterwards,
+          then to at most initial_rate_percent + lifetime_cap_percent and at least
+          floor_percent.
+        - The payment is re-amortized at each reset: the remaining balance over the
+          remaining months at the new rate.
+        - A loan that never resets (initial_fixed_months >= term) is a fixed-rate loan; its
+          scalar payment is exactly Mortgage::getMonthlyPayment().
+
+    Simpler Terms:
+        The rules of an adjustable-rate loan: how long the starting rate lasts, how often
+        the rate changes afterwards, and how far it is allowed to move.
+ */
+struct ArmTerms {
+    double loan_amount = 0.0;
+    int total_years_to_repay = 30;
+    double initial_rate_percent = 0.0;
+    int initial_fixed_months = 60;
+    int reset_interval_months = 12;
+    double margin_percent = 2.75;
+    double initial_cap_percent = 2.0;
+    double periodic_cap_percent = 2.0;
+    double lifetime_cap_percent = 5.0;
+    double floor_percent = 2.75;
+};
+
+/*
+    Struct: RatePathMatrix
+
+    Programmer's Note:
+        - Simulated index rates (annual %), month-major: the value for month m (1-based)
+          on path p is index_rates[(m - 1) * path_count + p], so one month of every path
+          is contiguous and is read with vector loads.
+        - A reset in month m uses row m; callers wanting a lookback shift their rows.
+        - months must cover the loan term.
+
+    Simpler Terms:
+        A table of possible future interest rates: one row per month, one column per
+        simulated scenario.
+ */
+struct RatePathMatrix {
+    std::span<const double> index_rates;
+    std::size_t path_count = 0;
+    int months = 0;
+};
+
+/*
+    Struct: ArmPathOutputs / ArmPathResult
+
+    Programmer's Note:
+        - One entry per path: interest paid, total of all payments, and the largest
+          monthly payment (payment shock).
+        - ArmPathOutputs holds caller-owned arrays of at least path_count entries.
+
+    Simpler Terms:
+        What the loan costs under each simulated rate scenario.
+ */
+struct ArmPathOutputs {
+    std::span<double> total_interest;
+    std::span<double> total_paid;
+    std::span<double> max_payment;
+};
+
+struct ArmPathResult {
+    double total_interest = 0.0;
+    double total_paid = 0.0;
+    double max_payment = 0.0;
+};
+
+/*
+    Evaluate ARM Paths
+
+    Programmer's Note:
+        - Runs the loan under every path. Paths are processed in tiles of 256 whose state
+          (balance, rate, payment, interest) stays in L1; within a tile the months between
+          two resets run with 4 (AVX2) or 8 (AVX-512) paths per instruction, and each reset
+          re-amortizes the whole tile with the batch payment kernel.
+        - Monthly steps use the same operations, in the same order, as the scalar path, so
+          at SimdLevel::Scalar every result equals evaluateArmPath bit for bit; the vector
+          levels differ only by rounding (payment kernel, fused multiply-adds).
+        - The pool overload splits tiles across threads; results do not depend on the
+          thread count.
+        - Returns false (after printing an ERROR line) if the terms are invalid or the
+          matrix or outputs are too small.
+
+    Simpler Terms:
+        Works out the cost of an adjustable-rate loan under thousands of rate scenarios
+        at once.
+ */
+bool evaluateArmPaths(const ArmTerms& terms, const RatePathMatrix& paths, const ArmPathOutputs& out,
+                      SimdLevel level = detectSimdLevel());
+bool evaluateArmPaths(const ArmTerms& terms, const RatePathMatrix& paths, const ArmPathOutputs& out,
+                      WorkStealingPool& pool, SimdLevel level = detectSimdLevel());
+
+// Reference: one path, one month at a time (terms and matrix must be valid)
+ArmPathResult evaluateArmPath(const ArmTerms& terms, const RatePathMatrix& paths, std::size_t path);
+
+#endif // ARM_ENGINE_H
@@ -0,0 +1,420 @@
+// Batch Pricer Implementation
+
+#include "BatchPricer.h"
+#include "LoanTape.h"
+#include "Mortgage.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+constexpr size_t BLOCK_LOANS = 4096;        // Loans priced per block before writing results
+constexpr size_t READ_CHUNK = 1 << 20;      // Bytes read from the input stream at a time
+constexpr size_t MAX_FIXED_CHARS = 320;     // Longest "%.2f" double: sign, 309 digits, point, 2 decimals
+constexpr size_t MAX_CSV_QUOTE_CHARS = 2 * MAX_FIXED_CHARS + 2;   // Upper bound on one "payment,total\n" line
+constexpr size_t CSV_TEXT_BYTES = 256 << 10;    // CSV output buffer; written out whenever it runs low
+constexpr int64_t MAX_PAYMENTS = numeric_limits<int>::max();   // Longest term Mortgage can hold, in payments
+
+/*
+    Skip Spaces
+
+    Programmer's Note:
+        - Advances past blanks and tabs so "1000, 5, 30" parses like "1000,5,30".
+
+    Simpler Terms:
+        Ignores extra spaces around the numbers.
+ */
+const char* skipSpaces(const char* first, const char* last) {
+    while (first != last && (*first == ' ' || *first == '\t')) {
+        ++first;
+    }
+    return first;
+}
+
+/*
+    Append Quote CSV
+
+    Programmer's Note:
+        - Formats one quote with two decimal places using std::to_chars,
+          matching the fixed/setprecision(2) output of the interactive program.
+        - Each field gets MAX_FIXED_CHARS, enough for any double in fixed notation
+          (1e300 has 301 digits before the point), so the caller must leave
+          MAX_CSV_QUOTE_CHARS free. A field that still fails to format is written as "nan".
+
+    Simpler Terms:
+        Writes "payment,total" for one loan into the output buffer.
+ */
+char* appendFixed2(char* out, double value) {
+    const to_chars_result result = to_chars(out, out + MAX_FIXED_CHARS, value, chars_format::fixed, 2);
+    if (result.ec != errc()) {
+        memcpy(out, "nan", 3);
+        return out + 3;
+    }
+    return result.ptr;
+}
+
+char* appendQuoteCsv(char* out, const LoanQuote& quote) {
+    out = appendFixed2(out, quote.monthly_payment);
+    *out++ = ',';
+    out = appendFixed2(out, quote.total_payback);
+    *out++ = '\n';
+    return out;
+}
+
+/*
+    Class: BlockWriter
+
+    Programmer's Note:
+        - Collects parsed loans, prices them a block at a time, and writes the block
+          in the requested output format with a single stream write.
+        - Records flagged as malformed come out as NaN quotes so output rows stay aligned.
+
+    Simpler Terms:
+        Gathers loans into groups, prices each group, and saves the results in one go.
+ */
+class BlockWriter {
+public:
+    BlockWriter(ostream& out, BatchFormat format, PaymentPrecision precision, BatchStats& stats)
+        : out(out), format(format), precision(precision), stats(stats) {
+        records.reserve(BLOCK_LOANS);
+        valid.reserve(BLOCK_LOANS);
+        quotes.resize(BLOCK_LOANS);
+        text.resize(CSV_TEXT_BYTES);
+
+        if (format == BatchFormat::Csv) {
+            out << "monthly_payment,total_payback\n";
+        }
+    }
+
+    void add(const LoanRecord& record, bool isValid) {
+        records.push_back(isValid ? record : LoanRecord{});  // Rejected loans are never priced
+        valid.push_back(isValid);
+        if (records.size() == BLOCK_LOANS) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (records.empty()) {
+            return;
+        }
+
+        const size_t count = records.size();
+        priceLoans(records, span<LoanQuote>(quotes.data(), count), precision);
+
+        // Malformed and invalid records produce NaN quotes instead of whatever the placeholder priced to
+        for (size_t i = 0; i < count; ++i) {
+            if (!valid[i]) {
+                quotes[i] = { numeric_limits<double>::quiet_NaN(), numeric_limits<double>::quiet_NaN() };
+            }
+        }
+
+        size_t bytes = count * sizeof(LoanQuote);
+        if (format == BatchFormat::Binary) {
+            out.write(reinterpret_cast<const char*>(quotes.data()), static_cast<streamsize>(bytes));
+        } else {
+            // Ordinary quotes take ~25 bytes, so this is one write per block; huge amounts
+            // (up to ~640 bytes a line) just write the buffer out more often
+            bytes = 0;
+            char* cursor = text.data();
+            for (size_t i = 0; i < count; ++i) {
+                if (static_cast<size_t>(text.data() + text.size() - cursor) < MAX_CSV_QUOTE_CHARS) {
+                    bytes += writeText(cursor);
+                    cursor = text.data();
+                }
+                cursor = appendQuoteCsv(cursor, quotes[i]);
+            }
+            bytes += writeText(cursor);
+        }
+        perf_counters::add(perf_counters::Counter::BytesWritten, bytes);
+
+        stats.loans_priced += count;
+        records.clear();
+        valid.clear();
+    }
+
+private:
+    size_t writeText(const char* end) {
+        const size_t bytes = static_cast<size_t>(end - text.data());
+        out.write(text.data(), static_cast<streamsize>(bytes));
+        return bytes;
+    }
+
+    ostream& out;
+    BatchFormat format;
+    PaymentPrecision precision;
+    BatchStats& stats;
+    vector<LoanRecord> records;     // Loans waiting to be priced
+    vector<bool> valid;             // Whether each waiting loan parsed correctly
+    vector<LoanQuote> quotes;       // Reused result block
+    vector<char> text;              // Reused CSV output buffer
+};
+
+/*
+    Read CSV Loans
+
+    Programmer's Note:
+        - Reads the input in 1 MiB chunks and splits complete lines in place.
+        - A partial line at the end of a chunk is moved to the front and finished by the next read.
+
+    Simpler Terms:
+        Reads the loan file piece by piece and hands each line to the writer.
+ */
+void readCsvLoans(istream& in, BlockWriter& writer, BatchStats& stats) {
+    vector<char> buffer(READ_CHUNK);
+    size_t pending = 0;         // Bytes of an unfinished line carried over from the previous chunk
+    size_t lineNumber = 0;
+
+    auto handleLine = [&](const char* first, const char* last) {
+        ++lineNumber;
+        if (first == last || (last - first == 1 && *first == '\r')) {
+            return;  // Blank lines are ignored
+        }
+
+        LoanRecord record{};
+        if (parseLoanCsvLine(first, last, record)) {
+            const LoanCheck check = checkLoan(record);
+            if (check != LoanCheck::Valid) {
+                cerr << "WARNING: invalid loan record on line " << lineNumber << " ("
+                     << loanCheckName(check) << ")." << endl;
+                ++stats.invalid_records;
+            }
+            writer.add(record, check == LoanCheck::Valid);
+        } else if (lineNumber == 1 && looksLikeCsvHeader(first, last)) {
+            return;  // Column header line
+        } else {
+            cerr << "WARNING: malformed loan record on line " << lineNumber << "." << endl;
+            ++stats.malformed_records;
+            writer.add(record, false);
+        }
+    };
+
+    while (true) {
+        // Grow the buffer if a single line is longer than the chunk size
+        if (buffer.size() - pending < READ_CHUNK / 2) {
+            buffer.resize(buffer.size() * 2);
+        }
+
+        in.read(buffer.data() + pending, static_cast<streamsize>(buffer.size() - pending));
+        const size_t filled = pending + static_cast<size_t>(in.gcount());
+        if (filled == pending) {
+            break;  // End of input
+        }
+
+        const char* lineStart = buffer.data();
+        const char* end = buffer.data() + filled;
+        while (const char* newline = static_cast<const char*>(memchr(lineStart, '\n', end - lineStart))) {
+            handleLine(lineStart, newline);
+            lineStart = newline + 1;
+        }
+
+        pending = static_cast<size_t>(end - lineStart);
+        memmove(buffer.data(), lineStart, pending);
+    }
+
+    // The last line may not end with a newline
+    if (pending > 0) {
+        handleLine(buffer.data(), buffer.data() + pending);
+    }
+}
+
+/*
+    Read Binary Loans
+
+    Programmer's Note:
+        - Reads packed 24-byte LoanRecord structs a block at a time.
+        - A truncated record at the end of the input is reported and ignored.
+
+    Simpler Terms:
+        Reads loans stored as raw numbers instead of text.
+ */
+void readBinaryLoans(istream& in, BlockWriter& writer, BatchStats& stats) {
+    vector<LoanRecord> block(BLOCK_LOANS);
+    size_t loanNumber = 0;      // Records read before this block
+
+    while (true) {
+        in.read(reinterpret_cast<char*>(block.data()),
+                static_cast<streamsize>(block.size() * sizeof(LoanRecord)));
+        const size_t bytes = static_cast<size_t>(in.gcount());
+        const size_t count = bytes / sizeof(LoanRecord);
+
+        for (size_t i = 0; i < count; ++i) {
+            const LoanCheck check = checkLoan(block[i]);
+            if (check != LoanCheck::Valid) {
+                cerr << "WARNING: invalid binary loan record " << loanNumber + i + 1 << " ("
+                     << loanCheckName(check) << ")." << endl;
+                ++stats.invalid_records;
+            }
+            writer.add(block[i], check == LoanCheck::Valid);
+        }
+        loanNumber += count;
+
+        if (bytes % sizeof(LoanRecord) != 0) {
+            cerr << "WARNING: ignoring truncated loan record at end of binary input." << endl;
+            ++stats.malformed_records;
+        }
+
+        if (bytes < block.size() * sizeof(LoanRecord)) {
+            break;  // End of input
+        }
+    }
+}
+
+} // namespace
+
+/*
+    Parse CSV Line
+
+    Programmer's Note:
+        - Parses "amount,rate,years" with std::from_chars (no locale, no allocation).
+        - Returns false if any field is missing or followed by unexpected characters.
+
+    Simpler Terms:
+        Reads one line of the loan file into a LoanRecord, or reports that it couldn't.
+ */
+bool parseLoanCsvLine(const char* first, const char* last, LoanRecord& record) {
+    // Trim a trailing carriage return left by Windows line endings
+    if (first != last && last[-1] == '\r') {
+        --last;
+    }
+
+    first = skipSpaces(first, last);
+    auto [amountEnd, amountError] = from_chars(first, last, record.loan_amount);
+    if (amountError != errc() || (first = skipSpaces(amountEnd, last)) == last || *first != ',') {
+        return false;
+    }
+
+    first = skipSpaces(first + 1, last);
+    auto [rateEnd, rateError] = from_chars(first, last, record.annual_interest_rate);
+    if (rateError != errc() || (first = skipSpaces(rateEnd, last)) == last || *first != ',') {
+        return false;
+    }
+
+    first = skipSpaces(first + 1, last);
+    auto [yearsEnd, yearsError] = from_chars(first, last, record.total_years_to_repay);
+    if (yearsError != errc()) {
+        return false;
+    }
+
+    record.reserved = 0;
+    return skipSpaces(yearsEnd, last) == last;  // Nothing but spaces may follow the last field
+}
+
+/*
+    Looks Like Header
+
+    Programmer's Note:
+        - The first CSV line is treated as a column header when it contains letters
+          and fails to parse as a loan.
+
+    Simpler Terms:
+        Lets the loan file start with a title row such as "amount,rate,years".
+ */
+bool looksLikeCsvHeader(const char* first, const char* last) {
+    return any_of(first, last, [](char c) { return isalpha(static_cast<unsigned char>(c)) != 0; });
+}
+
+/*
+    Price Loans
+
+    Programmer's Note:
+        - Reuses one silent Mortgage object for the whole block, so no INFO lines are printed
+          and no object is constructed per loan.
+        - Total payback is computed as payment * number of payments, exactly what
+          getTotalPayback() returns, without evaluating the power factor a second time.
+        - Extended precision swaps in getMonthlyPaymentExtended(); everything else is the same.
+        - The payment count is formed in 64 bits; a term too long for an int number of payments
+          is quoted as NaN instead of overflowing. Stream input never gets that far: the
+          readers reject it with checkLoan().
+
+    Simpler Terms:
+        Works out the monthly payment and total payback for every loan in the list.
+ */
+void priceLoans(span<const LoanRecord> loans, span<LoanQuote> quotes, PaymentPrecision precision) {
+    perf_counters::ScopedTimer timer(perf_counters::Phase::Pricing);
+    perf_counters::add(perf_counters::Counter::LoansPriced, loans.size());
+    Mortgage loan(false);  // Silent: batch pricing must not log
+
+    for (size_t i = 0; i < loans.size(); ++i) {
+        const int64_t number_of_payments = static_cast<int64_t>(loans[i].total_years_to_repay) * 12;
+        if (number_of_payments > MAX_PAYMENTS) {
+            quotes[i] = { numeric_limits<double>::quiet_NaN(), numeric_limits<double>::quiet_NaN() };
+            continue;
+        }
+
+        loan.setLoanAmount(loans[i].loan_amount);
+        loan.setAnnualInterestRate(loans[i].annual_interest_rate);
+        loan.setTotalYearsToRepay(loans[i].total_years_to_repay);
+
+        const double monthly_payment = precision == PaymentPrecision::Extended
+            ? loan.getMonthlyPaymentExtended()
+            : loan.getMonthlyPayment();
+        quotes[i].monthly_payment = monthly_payment;
+        quotes[i].total_payback = monthly_payment * static_cast<double>(number_of_payments);
+    }
+}
+
+/*
+    Price Loans (Cached Factors)
+
+    Programmer's Note:
+        - Converts rate and term exactly as the Mortgage setters do, then prices each loan
+          as principal * cached payment factor.
+
+    Simpler Terms:
+        Same as priceLoans, but remembers the math for rates and terms it has seen before.
+ */
+void priceLoans(span<const LoanRecord> loans, span<LoanQuote> quotes, AnnuityFactorCache& cache) {
+    perf_counters::ScopedTimer timer(perf_counters::Phase::Pricing);
+    perf_counters::add(perf_counters::Counter::LoansPriced, loans.size());
+
+    for (size_t i = 0; i < loans.size(); ++i) {
+        const double annual_interest_rate = loans[i].annual_interest_rate / 100.0;   // Percentage -> decimal
+        const int64_t payments = static_cast<int64_t>(loans[i].total_years_to_repay) * 12;  // Years -> payments
+        if (payments > MAX_PAYMENTS) {
+            quotes[i] = { numeric_limits<double>::quiet_NaN(), numeric_limits<double>::quiet_NaN() };
+            continue;
+        }
+        const int number_of_payments = static_cast<int>(payments);
+
+        const double monthly_payment =
+            cache.monthlyPayment(loans[i].loan_amount, annual_interest_rate / 12.0, number_of_payments);
+        quotes[i].monthly_payment = monthly_payment;
+        quotes[i].total_payback = monthly_payment * number_of_payments;
+    }
+}
+
+/*
+    Price Loan Stream
+
+    Programmer's Note:
+        - Streams loans from 'in' to 'out' without holding the whole portfolio in memory.
+        - Output order matches input order, one quote per loan record.
+
+    Simpler Terms:
+        Reads every loan from a file, prices it, and writes the answers to another file.
+ */
+BatchStats priceLoanStream(istream& in, ostream& out, BatchFormat inputFormat, BatchFormat outputFormat,
+                           PaymentPrecision precision) {
+    perf_counters::ScopedTimer timer(perf_counters::Phase::BatchStream);
+    BatchStats stats;
+    BlockWriter writer(out, outputFormat, precision, stats);
+
+    if (inputFormat == BatchFormat::Binary) {
+        readBinaryLoans(in, writer, stats);
+    } else {
+        readCsvLoans(in, writer, stats);
+    }
+
+    writer.flush();
+    out.flush();
+    return stats;
+}
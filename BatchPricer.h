@@ -0,0 +1,115 @@
+// Batch Pricer Specification
+
+#ifndef BATCH_PRICER_H
+#define BATCH_PRICER_H
+
+#include "AnnuityFactorCache.h"
+#include "PaymentKernels.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+
+/*
+    Batch Pricing Records
+
+    Programmer's Note:
+        - LoanRecord is one loan read from a loan file (same units as the interactive prompts:
+          rate is a percentage, e.g., 4.75 for 4.75%).
+        - LoanQuote holds the two results the interactive program prints for every loan.
+        - In binary files a LoanRecord is stored as 24 bytes
+          (double amount, double rate, int32 years, int32 reserved) and
+          a LoanQuote as 16 bytes (double payment, double total payback), native byte order.
+
+    Simpler Terms:
+        One loan going in, and its monthly payment and total payback coming out.
+ */
+struct LoanRecord {
+    double loan_amount;             // Amount borrowed (principal)
+    double annual_interest_rate;    // Annual interest rate as a percentage
+    std::int32_t total_years_to_repay;   // Repayment period in years
+    std::int32_t reserved;          // Padding so binary records are 24 bytes
+};
+
+struct LoanQuote {
+    double monthly_payment;         // Result of Mortgage::getMonthlyPayment()
+    double total_payback;           // Result of Mortgage::getTotalPayback()
+};
+
+/*
+    Batch File Formats
+
+    Programmer's Note:
+        - Csv: one "amount,rate,years" line per loan on input (an optional header line is skipped),
+          one "monthly_payment,total_payback" line per loan on output.
+        - Binary: packed LoanRecord / LoanQuote structs, no header.
+
+    Simpler Terms:
+        Loans can be read and written as plain text or as raw numbers.
+ */
+enum class BatchFormat {
+    Csv,
+    Binary
+};
+
+/*
+    Batch Statistics
+
+    Programmer's Note:
+        - Returned by priceLoanStream so the caller can report what happened.
+        - Malformed CSV lines are counted, reported on cerr, and written out as "nan,nan"
+          so that output line i always belongs to input loan i.
+        - Records that parse but fail checkLoan() (negative amount or rate, term outside
+          1..100 years, ...) are counted separately and written out the same way.
+
+    Simpler Terms:
+        How many loans were priced and how many lines could not be read.
+ */
+struct BatchStats {
+    std::size_t loans_priced = 0;       // Number of loans written to the output
+    std::size_t malformed_records = 0;  // Number of input lines that could not be parsed
+    std::size_t invalid_records = 0;    // Number of records rejected by checkLoan()
+};
+
+/*
+    CSV Loan Parsing
+
+    Programmer's Note:
+        - parseLoanCsvLine reads one "amount,rate,years" line (no newline; a trailing '\r'
+          and spaces around fields are allowed) with std::from_chars. It checks syntax only:
+          a negative amount or rate parses fine (see LoanTape.h for validation).
+        - looksLikeCsvHeader is how the readers recognise a first line like "amount,rate,years".
+        - Shared by priceLoanStream and the bulk loan-tape reader so both accept the same lines.
+
+    Simpler Terms:
+        Turns one line of a loan file into a loan, and spots a title row.
+ */
+bool parseLoanCsvLine(const char* first, const char* last, LoanRecord& record);
+bool looksLikeCsvHeader(const char* first, const char* last);
+
+/*
+    Batch Pricing Functions
+
+    Programmer's Note:
+        - priceLoans prices an in-memory block of loans through one silent Mortgage object
+          (no constructor/destructor logging), giving the same numbers as the interactive path.
+        - The cache overload looks up each (rate, term) factor in a shared AnnuityFactorCache,
+          so portfolios with few distinct rate/term pairs skip std::pow almost entirely
+          (results identical to Mortgage, see AnnuityFactorCache.h).
+        - priceLoanStream streams loans from an input stream to an output stream in large blocks,
+          so memory use stays constant no matter how many loans the file holds.
+        - PaymentPrecision::Extended prices with Mortgage::getMonthlyPaymentExtended() instead
+          (correctly rounded audit mode, several times slower).
+
+    Simpler Terms:
+        Price a whole list of loans at once, either from memory or straight from a file.
+ */
+void priceLoans(std::span<const LoanRecord> loans, std::span<LoanQuote> quotes,
+                PaymentPrecision precision = PaymentPrecision::Fast);
+void priceLoans(std::span<const LoanRecord> loans, std::span<LoanQuote> quotes, AnnuityFactorCache& cache);
+
+BatchStats priceLoanStream(std::istream& in, std::ostream& out,
+                           BatchFormat inputFormat, BatchFormat outputFormat,
+                           PaymentPrecision precision = PaymentPrecision::Fast);
+
+#endif // BATCH_PRICER_H
@@ -0,0 +1,442 @@
+// Binary Schedule Format Implementation
+
+#include "BinarySchedule.h"
+#include "PerfCounters.h"
+#include "ScheduleWriter.h"
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MORTGAGE_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr char MAGIC[8] = { 'M', 'T', 'G', 'S', 'C', 'H', 'D', '1' };
+constexpr uint32_t VERSION = 1;
+constexpr double FIXED_POINT_SCALE = 10000.0;   // Ten-thousandths of a dollar
+
+// Rounds a byte offset up to the next 64-byte boundary
+constexpr uint64_t alignUp(uint64_t offset) {
+    return (offset + 63) & ~uint64_t{63};
+}
+
+/*
+    Class: OutputFile
+
+    Programmer's Note:
+        - A writable region of exactly 'size' bytes backed by the output file:
+          a shared mmap on POSIX, an in-memory buffer written out on close elsewhere.
+        - The file's blocks are reserved with posix_fallocate before it is mapped. A sparse
+          ftruncate alone would let a full disk surface as SIGBUS on the first store into
+          an unbacked page; now it is an error (error() holds the errno) before anything
+          is written. Where the file system cannot reserve blocks (EINVAL, EOPNOTSUPP) or
+          the mapping fails, the buffer is used and written out with write() on close, so
+          a full disk is still reported instead of killing the process.
+
+    Simpler Terms:
+        A block of memory that ends up as the contents of the output file.
+ */
+class OutputFile {
+public:
+    OutputFile(const string& filename, size_t size) : name(filename), bytes(size) {
+#ifdef MORTGAGE_HAVE_MMAP
+        descriptor = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (descriptor < 0) {
+            failure = errno;
+            return;
+        }
+        const int reserved = ::posix_fallocate(descriptor, 0, static_cast<off_t>(size));
+        if (reserved == 0) {
+            void* mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+            if (mapped != MAP_FAILED) {
+                base = static_cast<char*>(mapped);
+                return;
+            }
+        } else if (reserved != EINVAL && reserved != EOPNOTSUPP) {
+            failure = reserved;     // ENOSPC, EFBIG, ...: the file cannot hold the schedules
+            return;
+        }
+#endif
+        buffer.assign(size, 0);
+        base = buffer.data();
+    }
+
+    ~OutputFile() {
+        close();
+    }
+
+    [[nodiscard]] char* data() const { return base; }
+    [[nodiscard]] int error() const { return failure; }   // errno of the last failure, 0 if none
+
+    bool close() {
+        bool ok = base != nullptr;
+#ifdef MORTGAGE_HAVE_MMAP
+        if (base != nullptr && buffer.empty()) {
+            ok = ::munmap(base, bytes) == 0;
+        } else if (base != nullptr) {
+            for (size_t written = 0; ok && written < bytes;) {
+                const ssize_t result = ::write(descriptor, buffer.data() + written, bytes - written);
+                if (result <= 0 && !(result < 0 && errno == EINTR)) {
+                    failure = result < 0 ? errno : EIO;
+                    ok = false;
+                } else if (result > 0) {
+                    written += static_cast<size_t>(result);
+                }
+            }
+        }
+        if (descriptor >= 0 && ::close(descriptor) != 0) {
+            failure = errno;
+            ok = false;
+        }
+        descriptor = -1;
+#else
+        if (base != nullptr) {
+            ofstream outFile(name, ios::binary);
+            outFile.write(buffer.data(), static_cast<streamsize>(bytes));
+            ok = static_cast<bool>(outFile);
+        }
+#endif
+        base = nullptr;
+        buffer.clear();
+        return ok;
+    }
+
+private:
+    string name;
+    size_t bytes;
+    char* base = nullptr;
+    vector<char> buffer;    // Used when the file is not mapped
+    int failure = 0;
+#ifdef MORTGAGE_HAVE_MMAP
+    int descriptor = -1;
+#endif
+};
+
+/*
+    Store Column Value
+
+    Programmer's Note:
+        - Writes one value into a column in the file's encoding.
+        - A fixed-point value must be finite and scale to within int64 (|value| below about
+          9.2e14 dollars); llround is undefined outside that range, so such a value is
+          refused (false) instead.
+
+    Simpler Terms:
+        Saves one number into the file, if the file's format can hold it.
+ */
+[[nodiscard]] bool storeValue(char* column, uint64_t rowIndex, double value, ScheduleEncoding encoding) {
+    if (encoding == ScheduleEncoding::FixedPoint) {
+        const double scaled = value * FIXED_POINT_SCALE;
+        if (!(fabs(scaled) < 0x1p63)) {
+            return false;   // Also catches NaN
+        }
+        const int64_t fixed = llround(scaled);
+        memcpy(column + rowIndex * sizeof(int64_t), &fixed, sizeof(fixed));
+    } else {
+        memcpy(column + rowIndex * sizeof(double), &value, sizeof(value));
+    }
+    return true;
+}
+
+} // namespace
+
+/*
+    Write Binary Schedules
+
+    Programmer's Note:
+        - Pass 1 lays out the file from the loan terms; pass 2 computes each schedule
+          into a reusable row buffer and scatters it into the three mapped columns.
+
+    Simpler Terms:
+        Works out how big the file must be, then fills it loan by loan.
+ */
+bool writeBinarySchedules(const string& filename, span<const LoanRecord> loans, ScheduleEncoding encoding) {
+    perf_counters::ScopedTimer timer(perf_counters::Phase::ScheduleWrite);
+    BinaryScheduleHeader header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.encoding = static_cast<uint32_t>(encoding);
+    header.loan_count = loans.size();
+
+    for (const LoanRecord& record : loans) {
+        header.row_count += static_cast<uint64_t>(max(0, record.total_years_to_repay * 12));
+    }
+
+    const uint64_t columnBytes = header.row_count * 8;
+    header.loan_table_offset = sizeof(BinaryScheduleHeader);
+    header.interest_offset = alignUp(header.loan_table_offset + header.loan_count * sizeof(BinaryScheduleLoan));
+    header.principal_offset = alignUp(header.interest_offset + columnBytes);
+    header.balance_offset = alignUp(header.principal_offset + columnBytes);
+    const uint64_t fileSize = header.balance_offset + columnBytes;
+
+    OutputFile file(filename, static_cast<size_t>(fileSize));
+    char* base = file.data();
+    if (base == nullptr) {
+        cerr << "ERROR: Could not open file " << filename << " for writing";
+        if (file.error() != 0) {
+            cerr << " (" << strerror(file.error()) << ")";
+        }
+        cerr << "." << endl;
+        return false;
+    }
+
+    memcpy(base, &header, sizeof(header));
+
+    Mortgage loan(false);
+    vector<PaymentRow> rows;
+    uint64_t firstRow = 0;
+
+    for (size_t i = 0; i < loans.size(); ++i) {
+        loan.setLoanAmount(loans[i].loan_amount);
+        loan.setAnnualInterestRate(loans[i].annual_interest_rate);
+        loan.setTotalYearsToRepay(loans[i].total_years_to_repay);
+
+        const int payments = max(0, loan.getNumberOfPayments());
+        rows.resize(static_cast<size_t>(payments));
+        loan.fillPaymentSchedule(rows);
+
+        BinaryScheduleLoan entry{};
+        entry.first_row = firstRow;
+        entry.row_count = static_cast<uint32_t>(payments);
+        entry.total_years_to_repay = loans[i].total_years_to_repay;
+        entry.loan_amount = loans[i].loan_amount;
+        entry.annual_interest_rate = loans[i].annual_interest_rate;
+        entry.monthly_payment = loan.getMonthlyPayment();
+        entry.total_payback = loan.getTotalPayback();
+        memcpy(base + header.loan_table_offset + i * sizeof(BinaryScheduleLoan), &entry, sizeof(entry));
+
+        for (int k = 0; k < payments; ++k) {
+            if (!storeValue(base + header.interest_offset, firstRow + k, rows[k].interest, encoding)
+                || !storeValue(base + header.principal_offset, firstRow + k, rows[k].principal, encoding)
+                || !storeValue(base + header.balance_offset, firstRow + k, rows[k].remaining_balance, encoding)) {
+                cerr << "ERROR: Loan " << i + 1 << " has a schedule value the fixed-point encoding cannot hold;"
+                     << " file " << filename << " not written." << endl;
+                file.close();
+                remove(filename.c_str());
+                return false;
+            }
+        }
+        firstRow += static_cast<uint64_t>(payments);
+    }
+
+    if (!file.close()) {
+        cerr << "ERROR: Could not finish writing file " << filename;
+        if (file.error() != 0) {
+            cerr << " (" << strerror(file.error()) << ")";
+        }
+        cerr << "." << endl;
+        return false;
+    }
+
+    perf_counters::add(perf_counters::Counter::RowsGenerated, header.row_count);
+    perf_counters::add(perf_counters::Counter::BytesWritten, fileSize);
+    return true;
+}
+
+/*
+    Struct: BinaryScheduleReader::Mapping
+
+    Programmer's Note:
+        - Owns the read-only view of the file: an mmap on POSIX, a heap copy elsewhere.
+
+    Simpler Terms:
+        Keeps the opened file's bytes available to the reader.
+ */
+struct BinaryScheduleReader::Mapping {
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef MORTGAGE_HAVE_MMAP
+    ~Mapping() {
+        if (data != nullptr) {
+            ::munmap(const_cast<char*>(data), size);
+        }
+    }
+#else
+    vector<char> buffer;
+#endif
+};
+
+/*
+    Reader Constructor & Destructor
+
+    Programmer's Note:
+        - Maps the file and checks magic, version, encoding, and that every section lies
+          inside the file. isOpen() reports the outcome; problems are printed to cerr.
+        - Each section is checked as offset <= size and length <= size - offset, never
+          as a sum, so offsets or counts near 2^64 in a damaged file cannot wrap past
+          the check. The counts are bounded first, so the lengths cannot overflow either.
+
+    Simpler Terms:
+        Opens the file and makes sure it really is a schedule file.
+ */
+BinaryScheduleReader::BinaryScheduleReader(const string& filename) : mapping(make_unique<Mapping>()) {
+#ifdef MORTGAGE_HAVE_MMAP
+    const int descriptor = ::open(filename.c_str(), O_RDONLY);
+    struct stat info{};
+    if (descriptor >= 0 && ::fstat(descriptor, &info) == 0 && info.st_size > 0) {
+        void* mapped = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, descriptor, 0);
+        if (mapped != MAP_FAILED) {
+            mapping->data = static_cast<const char*>(mapped);
+            mapping->size = static_cast<size_t>(info.st_size);
+        }
+    }
+    if (descriptor >= 0) {
+        ::close(descriptor);
+    }
+#else
+    ifstream inFile(filename, ios::binary);
+    mapping->buffer.assign(istreambuf_iterator<char>(inFile), istreambuf_iterator<char>());
+    mapping->data = mapping->buffer.data();
+    mapping->size = mapping->buffer.size();
+#endif
+
+    if (mapping->data == nullptr || mapping->size < sizeof(BinaryScheduleHeader)) {
+        cerr << "ERROR: Could not open schedule file " << filename << "." << endl;
+        return;
+    }
+
+    const auto* candidate = reinterpret_cast<const BinaryScheduleHeader*>(mapping->data);
+    const uint64_t size = mapping->size;
+    const auto fits = [size](uint64_t offset, uint64_t bytes) { return offset <= size && bytes <= size - offset; };
+    const bool valid =
+        memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) == 0
+        && candidate->version == VERSION
+        && candidate->encoding <= static_cast<uint32_t>(ScheduleEncoding::FixedPoint)
+        && candidate->loan_count <= size / sizeof(BinaryScheduleLoan)
+        && candidate->row_count <= size / 8
+        && fits(candidate->loan_table_offset, candidate->loan_count * sizeof(BinaryScheduleLoan))
+        && fits(candidate->interest_offset, candidate->row_count * 8)
+        && fits(candidate->principal_offset, candidate->row_count * 8)
+        && fits(candidate->balance_offset, candidate->row_count * 8)
+        && candidate->interest_offset % 8 == 0
+        && candidate->principal_offset % 8 == 0
+        && candidate->balance_offset % 8 == 0
+        && candidate->loan_table_offset % 8 == 0;
+
+    if (!valid) {
+        cerr << "ERROR: " << filename << " is not a valid schedule file." << endl;
+        return;
+    }
+
+    header = candidate;
+    loans = reinterpret_cast<const BinaryScheduleLoan*>(mapping->data + header->loan_table_offset);
+}
+
+BinaryScheduleReader::~BinaryScheduleReader() = default;
+
+/*
+    Reader Accessors
+
+    Programmer's Note:
+        - loan() and row() expect a valid index (index < loanCount(),
+          1 <= paymentNumber <= row_count); a loan entry that points outside
+          the columns yields NaN values and empty spans.
+
+    Simpler Terms:
+        Look up a loan's summary or one month of its plan.
+ */
+bool BinaryScheduleReader::isOpen() const {
+    return header != nullptr;
+}
+
+ScheduleEncoding BinaryScheduleReader::encoding() const {
+    return static_cast<ScheduleEncoding>(header->encoding);
+}
+
+size_t BinaryScheduleReader::loanCount() const {
+    return header == nullptr ? 0 : static_cast<size_t>(header->loan_count);
+}
+
+const BinaryScheduleLoan& BinaryScheduleReader::loan(size_t index) const {
+    return loans[index];
+}
+
+double BinaryScheduleReader::value(uint64_t columnOffset, uint64_t rowIndex) const {
+    if (rowIndex >= header->row_count) {
+        return numeric_limits<double>::quiet_NaN();
+    }
+
+    const char* slot = mapping->data + columnOffset + rowIndex * 8;
+    if (encoding() == ScheduleEncoding::FixedPoint) {
+        int64_t fixed;
+        memcpy(&fixed, slot, sizeof(fixed));
+        return static_cast<double>(fixed) / FIXED_POINT_SCALE;
+    }
+
+    double stored;
+    memcpy(&stored, slot, sizeof(stored));
+    return stored;
+}
+
+PaymentRow BinaryScheduleReader::row(size_t index, int paymentNumber) const {
+    const BinaryScheduleLoan& entry = loans[index];
+    const uint64_t rowIndex = entry.first_row + static_cast<uint64_t>(paymentNumber - 1);
+
+    return { paymentNumber,
+             entry.monthly_payment,
+             value(header->interest_offset, rowIndex),
+             value(header->principal_offset, rowIndex),
+             value(header->balance_offset, rowIndex) };
+}
+
+span<const double> BinaryScheduleReader::column(uint64_t columnOffset, size_t index) const {
+    const BinaryScheduleLoan& entry = loans[index];
+    if (encoding() != ScheduleEncoding::Float64 || entry.first_row > header->row_count
+        || entry.row_count > header->row_count - entry.first_row) {
+        return {};
+    }
+
+    const auto* values = reinterpret_cast<const double*>(mapping->data + columnOffset);
+    return { values + entry.first_row, entry.row_count };
+}
+
+span<const double> BinaryScheduleReader::interestColumn(size_t index) const {
+    return column(header->interest_offset, index);
+}
+
+span<const double> BinaryScheduleReader::principalColumn(size_t index) const {
+    return column(header->principal_offset, index);
+}
+
+span<const double> BinaryScheduleReader::balanceColumn(size_t index) const {
+    return column(header->balance_offset, index);
+}
+
+/*
+    Write Schedule Text
+
+    Programmer's Note:
+        - Same banner, summary and rows as outputPaymentSchedule; the annual rate is
+          converted to a decimal and back exactly as the Mortgage setter does.
+
+    Simpler Terms:
+        Prints one loan of the binary file as the usual payment plan table.
+ */
+void writeScheduleText(const BinaryScheduleReader& reader, size_t index, ostream& out) {
+    const BinaryScheduleLoan& entry = reader.loan(index);
+    ScheduleWriter writer(out);
+
+    const double annual_interest_rate = entry.annual_interest_rate / 100.0;   // Percentage -> decimal, as in Mortgage
+    writer.writeBanner();
+    writer.writeSummary(entry.loan_amount, annual_interest_rate * 100, entry.total_years_to_repay,
+                        entry.monthly_payment, entry.total_payback);
+    writer.writeColumnHeaders();
+
+    for (uint32_t k = 1; k <= entry.row_count; ++k) {
+        writer.writeRow(reader.row(index, static_cast<int>(k)));
+    }
+    writer.flush();
+}
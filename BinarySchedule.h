@@ -0,0 +1,145 @@
+// Binary Schedule Format Specification
+
+#ifndef BINARY_SCHEDULE_H
+#define BINARY_SCHEDULE_H
+
+#include "BatchPricer.h"
+#include "Mortgage.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <span>
+#include <string>
+
+/*
+    Binary Schedule File Layout (version 1, native little-endian)
+
+    Programmer's Note:
+        - Header (64 bytes):
+              char     magic[8]            "MTGSCHD1"
+              uint32   version             1
+              uint32   encoding            ScheduleEncoding
+              uint64   loan_count
+              uint64   row_count           total rows over all loans
+              uint64   loan_table_offset   byte offset of the loan table
+              uint64   interest_offset     byte offset of the interest column
+              uint64   principal_offset    byte offset of the principal column
+              uint64   balance_offset      byte offset of the remaining-balance column
+        - Loan table: loan_count BinaryScheduleLoan entries (48 bytes each).
+          Loan i owns rows [first_row, first_row + row_count) of every column.
+        - Columns: row_count values each, 64-byte aligned, all rows of loan 0, then loan 1, ...
+          Float64 stores doubles; FixedPoint stores int64 ten-thousandths of a dollar.
+        - Payment numbers are implicit (row index within the loan + 1) and the level payment
+          is stored once per loan, so a row costs 24 bytes instead of ~70 bytes of text.
+
+    Simpler Terms:
+        A compact file that keeps every loan's payment plan as raw numbers, with an index
+        so any loan and month can be found without reading the rest of the file.
+ */
+enum class ScheduleEncoding : std::uint32_t {
+    Float64 = 0,        // Exact doubles (text conversion is byte-identical)
+    FixedPoint = 1      // int64, value * 10^4 rounded to nearest
+};
+
+struct BinaryScheduleHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t encoding;
+    std::uint64_t loan_count;
+    std::uint64_t row_count;
+    std::uint64_t loan_table_offset;
+    std::uint64_t interest_offset;
+    std::uint64_t principal_offset;
+    std::uint64_t balance_offset;
+};
+
+struct BinaryScheduleLoan {
+    std::uint64_t first_row;            // Index of the loan's first row in every column
+    std::uint32_t row_count;            // Number of payments
+    std::int32_t total_years_to_repay;  // Term in years
+    double loan_amount;                 // Principal
+    double annual_interest_rate;        // Rate as a percentage (as entered)
+    double monthly_payment;             // Level payment
+    double total_payback;               // monthly_payment * row_count
+};
+
+static_assert(sizeof(BinaryScheduleHeader) == 64, "header layout is part of the file format");
+static_assert(sizeof(BinaryScheduleLoan) == 48, "loan table layout is part of the file format");
+
+/*
+    Write Binary Schedules
+
+    Programmer's Note:
+        - Sizes the file up front, maps it, and writes every loan's schedule straight into
+          the mapped columns (one scratch row buffer, reused for all loans).
+        - Rows are computed by Mortgage::fillPaymentSchedule, so Float64 files hold exactly
+          the numbers outputPaymentSchedule prints.
+        - Returns false (after printing an ERROR line) if the file cannot be created or its
+          space reserved (a full disk), or if a FixedPoint value is non-finite or too large
+          for int64 ten-thousandths; in that case the partial file is removed.
+
+    Simpler Terms:
+        Saves the payment plans of many loans into one compact binary file.
+ */
+bool writeBinarySchedules(const std::string& filename, std::span<const LoanRecord> loans,
+                          ScheduleEncoding encoding = ScheduleEncoding::Float64);
+
+/*
+    Class: BinaryScheduleReader
+
+    Programmer's Note:
+        - Memory-maps a schedule file read-only and validates the header and offsets.
+        - Lookups are O(1): loan N's table entry, then month k's slot in each column.
+          Only the pages actually touched are read from disk.
+        - Float64 files expose zero-copy column spans per loan.
+        - On systems without mmap the file is read into memory instead.
+
+    Simpler Terms:
+        Opens a binary schedule file and jumps straight to any loan and month.
+ */
+class BinaryScheduleReader {
+public:
+    explicit BinaryScheduleReader(const std::string& filename);
+    ~BinaryScheduleReader();
+
+    BinaryScheduleReader(const BinaryScheduleReader&) = delete;
+    BinaryScheduleReader& operator=(const BinaryScheduleReader&) = delete;
+
+    [[nodiscard]] bool isOpen() const;                      // False if the file was missing or invalid
+    [[nodiscard]] ScheduleEncoding encoding() const;
+    [[nodiscard]] std::size_t loanCount() const;
+    [[nodiscard]] const BinaryScheduleLoan& loan(std::size_t index) const;
+
+    // Row k (1-based payment number) of loan 'index', decoded to dollars
+    [[nodiscard]] PaymentRow row(std::size_t index, int paymentNumber) const;
+
+    // Zero-copy columns of one loan (Float64 files only; empty otherwise)
+    [[nodiscard]] std::span<const double> interestColumn(std::size_t index) const;
+    [[nodiscard]] std::span<const double> principalColumn(std::size_t index) const;
+    [[nodiscard]] std::span<const double> balanceColumn(std::size_t index) const;
+
+private:
+    struct Mapping;
+    std::unique_ptr<Mapping> mapping;
+    const BinaryScheduleHeader* header = nullptr;
+    const BinaryScheduleLoan* loans = nullptr;
+
+    [[nodiscard]] double value(std::uint64_t columnOffset, std::uint64_t rowIndex) const;
+    [[nodiscard]] std::span<const double> column(std::uint64_t columnOffset, std::size_t index) const;
+};
+
+/*
+    Write Schedule Text
+
+    Programmer's Note:
+        - Converts one loan of a binary schedule file to the outputPaymentSchedule text layout.
+        - Byte-identical to outputPaymentSchedule for Float64 files; FixedPoint files can
+          differ in the last printed digit when a value sits on a rounding boundary.
+
+    Simpler Terms:
+        Turns one loan from the binary file back into the familiar text table.
+ */
+void writeScheduleText(const BinaryScheduleReader& reader, std::size_t index, std::ostream& out);
+
+#endif // BINARY_SCHEDULE_H
@@ -0,0 +1,117 @@
+// Constexpr Math Helpers
+
+#ifndef CONSTEXPR_MATH_H
+#define CONSTEXPR_MATH_H
+
+/*
+    Namespace: constexpr_math
+
+    Programmer's Note:
+        - std::pow is not usable in constant expressions, so compile-time pricing uses
+          powInt: binary exponentiation carried in double-double (hi + lo) arithmetic.
+        - Exact products come from Dekker/Veltkamp splitting instead of FMA (std::fma is not
+          constexpr either), so the result is the same on every compiler and target.
+        - For the bases and exponents of real loans (1 < base < 2, n <= 600) the result is
+          within 1 ULP of the exact power, i.e. within 2 ULP of std::pow.
+        - twoSum, add, divide and powDoubleDouble keep whole calculations in double-double
+          (~106 bits) for the extended-precision payment factor in AnnuityMath.h.
+
+    Simpler Terms:
+        A "raise to a whole-number power" that the compiler can work out
+        before the program even runs.
+ */
+namespace constexpr_math {
+
+struct DoubleDouble {
+    double hi;  // Leading part
+    double lo;  // Rounding error of hi
+};
+
+// Veltkamp split of a into two 26-bit halves whose sum is exactly a
+constexpr DoubleDouble split(double a) {
+    constexpr double factor = 134217729.0;  // 2^27 + 1
+    const double t = factor * a;
+    const double hi = t - (t - a);
+    return { hi, a - hi };
+}
+
+// a + b as an unevaluated sum, assuming |a| >= |b|
+constexpr DoubleDouble quickTwoSum(double a, double b) {
+    const double s = a + b;
+    return { s, b - (s - a) };
+}
+
+// a * b as an unevaluated sum (Dekker)
+constexpr DoubleDouble twoProduct(double a, double b) {
+    const double p = a * b;
+    const DoubleDouble as = split(a);
+    const DoubleDouble bs = split(b);
+    const double err = ((as.hi * bs.hi - p) + as.hi * bs.lo + as.lo * bs.hi) + as.lo * bs.lo;
+    return { p, err };
+}
+
+// Double-double product, keeping ~106 significant bits
+constexpr DoubleDouble multiply(DoubleDouble a, DoubleDouble b) {
+    DoubleDouble p = twoProduct(a.hi, b.hi);
+    p.lo += a.hi * b.lo + a.lo * b.hi;
+    return quickTwoSum(p.hi, p.lo);
+}
+
+// a + b as an unevaluated sum, any magnitudes (Knuth)
+constexpr DoubleDouble twoSum(double a, double b) {
+    const double s = a + b;
+    const double bPart = s - a;
+    return { s, (a - (s - bPart)) + (b - bPart) };
+}
+
+// Double-double sum
+constexpr DoubleDouble add(DoubleDouble a, DoubleDouble b) {
+    DoubleDouble s = twoSum(a.hi, b.hi);
+    const DoubleDouble t = twoSum(a.lo, b.lo);
+    s.lo += t.hi;
+    s = quickTwoSum(s.hi, s.lo);
+    s.lo += t.lo;
+    return quickTwoSum(s.hi, s.lo);
+}
+
+// Double-double quotient: long division, one double digit at a time
+constexpr DoubleDouble divide(DoubleDouble a, DoubleDouble b) {
+    const double q1 = a.hi / b.hi;
+    DoubleDouble product = multiply(b, { q1, 0.0 });
+    DoubleDouble rest = add(a, { -product.hi, -product.lo });
+    const double q2 = rest.hi / b.hi;
+    product = multiply(b, { q2, 0.0 });
+    rest = add(rest, { -product.hi, -product.lo });
+    const double q3 = rest.hi / b.hi;
+    return add(quickTwoSum(q1, q2), { q3, 0.0 });
+}
+
+// base^exponent by binary exponentiation, base and result in double-double
+constexpr DoubleDouble powDoubleDouble(DoubleDouble base, unsigned exponent) {
+    DoubleDouble result{ 1.0, 0.0 };
+    DoubleDouble square = base;
+    while (exponent != 0) {
+        if (exponent & 1u) {
+            result = multiply(result, square);
+        }
+        exponent >>= 1;
+        if (exponent != 0) {
+            square = multiply(square, square);
+        }
+    }
+    return result;
+}
+
+// base^exponent for any int exponent, usable in constant expressions
+constexpr double powInt(double base, int exponent) {
+    const bool negative = exponent < 0;
+    const unsigned remaining = negative ? 0u - static_cast<unsigned>(exponent) : static_cast<unsigned>(exponent);
+
+    const DoubleDouble result = powDoubleDouble({ base, 0.0 }, remaining);
+    const double value = result.hi + result.lo;
+    return negative ? 1.0 / value : value;
+}
+
+} // namespace constexpr_math
+
+#endif // CONSTEXPR_MATH_H
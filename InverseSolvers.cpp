@@ -0,0 +1,404 @@
+// Inverse Solvers Implementation
+
+#include "InverseSolvers.h"
+#include "AnnuityMath.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MORTGAGE_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr size_t PRINCIPAL_BLOCK = 256;     // Loans per payment-factor block (stack buffers)
+constexpr double RATE_TOLERANCE = 1e-12;    // Relative Newton step below which a lane is done
+
+/*
+    Forward Payment
+
+    Programmer's Note:
+        - annuity_math::paymentFactor, exactly as Mortgage::getMonthlyPayment() prices.
+
+    Simpler Terms:
+        The ordinary monthly payment calculation.
+ */
+double forwardPayment(double principal, double r, int32_t n) {
+    return principal * annuity_math::paymentFactor(r, n);
+}
+
+/*
+    Rate Guess / Newton Step
+
+    Programmer's Note:
+        - rateGuess: root of the first-order expansion  M ~ (P / n) * (1 + r * (n + 1) / 2).
+          M(r) is convex, so this is never below the true root.
+        - newtonStep: (M(r) - M) / M'(r) with  M'(r) = P * F * (1 - r * n / ((1 + r) * (F - 1))) / (F - 1).
+          The vector paths evaluate the same expressions lane by lane.
+
+    Simpler Terms:
+        A good first guess at the rate, and how far to move it to get closer.
+ */
+double rateGuess(double principal, double payment, double n) {
+    return 2.0 * (payment * n / principal - 1.0) / (n + 1.0);
+}
+
+double newtonStep(double principal, double payment, double n, double r, double power_factor) {
+    const double growth = power_factor - 1.0;
+    const double value = principal * r * power_factor / growth - payment;
+    const double slope = principal * power_factor * (1.0 - r * n / ((1.0 + r) * growth)) / growth;
+    return value / slope;
+}
+
+/*
+    Scalar Rate Solve
+
+    Programmer's Note:
+        - One loan at a time with std::pow; each loan stops as soon as it has converged.
+        - The step is limited to halving r, which Newton from above never needs but which
+          keeps r positive whatever the input.
+        - Stops on a step below RATE_TOLERANCE * r or one no smaller than the last
+          (rounding noise has taken over).
+
+    Simpler Terms:
+        Finds the rate for one loan by repeatedly improving a guess.
+ */
+int monthlyRatesScalar(const double* principal, const double* monthlyPayment, const int32_t* paymentCount,
+                       double* monthlyRate, size_t count) {
+    int slowest = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const double p = principal[i];
+        const double m = monthlyPayment[i];
+        const double n = paymentCount[i];
+        const double cover = m * n;
+
+        if (!(p > 0.0) || !(m > 0.0) || !(n > 0.0) || cover < p) {
+            monthlyRate[i] = numeric_limits<double>::quiet_NaN();
+            continue;
+        }
+        if (cover == p) {
+            monthlyRate[i] = 0.0;
+            continue;
+        }
+
+        double r = rateGuess(p, m, n);
+        double previous = numeric_limits<double>::infinity();
+        int round = 0;
+        while (round < MAX_RATE_ITERATIONS) {
+            ++round;
+            const double step = newtonStep(p, m, n, r, pow(1 + r, paymentCount[i]));
+            r = max(r - step, 0.5 * r);
+            if (fabs(step) <= RATE_TOLERANCE * r || fabs(step) >= previous) {
+                break;
+            }
+            previous = fabs(step);
+        }
+        monthlyRate[i] = r;
+        slowest = max(slowest, round);
+    }
+    return slowest;
+}
+
+// Binary-exponentiation rounds for the largest n in the batch (shared by all vector lanes)
+int exponentBits(const int32_t* paymentCount, size_t count) {
+    int32_t maxCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        maxCount = max(maxCount, paymentCount[i]);
+    }
+    return bit_width(static_cast<uint32_t>(maxCount));
+}
+
+#ifdef MORTGAGE_X86_DISPATCH
+
+/*
+    AVX2 Rate Block (4 loans)
+
+    Programmer's Note:
+        - Newton on four loans at once. (1 + r)^n is a plain-double binary exponentiation
+          (a few ULP, which the stall test absorbs), with lanes whose bit is clear kept
+          through a blend.
+        - Converged lanes are frozen; the block stops when none is pending or after
+          MAX_RATE_ITERATIONS rounds. Lanes with no positive rate are patched at the end.
+
+    Simpler Terms:
+        Finds the rates for four loans in one go using 256-bit registers.
+ */
+__attribute__((target("avx2,fma")))
+int rateBlockAvx2(const double* principal, const double* monthlyPayment, const int32_t* paymentCount,
+                  double* monthlyRate, int bits) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d tolerance = _mm256_set1_pd(RATE_TOLERANCE);
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+
+    const __m128i count32 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(paymentCount));
+    const __m256i exponent = _mm256_cvtepi32_epi64(count32);
+    const __m256d n = _mm256_cvtepi32_pd(count32);
+    const __m256d p = _mm256_loadu_pd(principal);
+    const __m256d m = _mm256_loadu_pd(monthlyPayment);
+    const __m256d cover = _mm256_mul_pd(m, n);
+
+    const __m256d valid = _mm256_and_pd(
+        _mm256_and_pd(_mm256_cmp_pd(p, zero, _CMP_GT_OQ), _mm256_cmp_pd(m, zero, _CMP_GT_OQ)),
+        _mm256_and_pd(_mm256_cmp_pd(n, zero, _CMP_GT_OQ), _mm256_cmp_pd(cover, p, _CMP_GT_OQ)));
+
+    __m256d r = _mm256_div_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), _mm256_sub_pd(_mm256_div_pd(cover, p), one)),
+                              _mm256_add_pd(n, one));
+    __m256d pending = valid;
+    __m256d previous = _mm256_set1_pd(numeric_limits<double>::infinity());
+
+    int round = 0;
+    while (round < MAX_RATE_ITERATIONS && _mm256_movemask_pd(pending) != 0) {
+        ++round;
+        const __m256d base0 = _mm256_add_pd(one, r);
+        __m256d base = base0;
+        __m256d power_factor = one;
+        for (int bit = 0; bit < bits; ++bit) {
+            const __m256i bitMask = _mm256_set1_epi64x(int64_t{1} << bit);
+            const __m256d take = _mm256_castsi256_pd(
+                _mm256_cmpeq_epi64(_mm256_and_si256(exponent, bitMask), bitMask));
+            power_factor = _mm256_blendv_pd(power_factor, _mm256_mul_pd(power_factor, base), take);
+            base = _mm256_mul_pd(base, base);
+        }
+
+        const __m256d growth = _mm256_sub_pd(power_factor, one);
+        const __m256d value = _mm256_sub_pd(_mm256_div_pd(_mm256_mul_pd(_mm256_mul_pd(p, r), power_factor), growth), m);
+        const __m256d bend = _mm256_sub_pd(one, _mm256_div_pd(_mm256_mul_pd(r, n), _mm256_mul_pd(base0, growth)));
+        const __m256d slope = _mm256_div_pd(_mm256_mul_pd(_mm256_mul_pd(p, power_factor), bend), growth);
+        const __m256d step = _mm256_div_pd(value, slope);
+
+        const __m256d next = _mm256_max_pd(_mm256_sub_pd(r, step), _mm256_mul_pd(half, r));
+        r = _mm256_blendv_pd(r, next, pending);
+        const __m256d size = _mm256_andnot_pd(signMask, step);
+        const __m256d done = _mm256_or_pd(_mm256_cmp_pd(size, _mm256_mul_pd(tolerance, r), _CMP_LE_OQ),
+                                          _mm256_cmp_pd(size, previous, _CMP_GE_OQ));
+        pending = _mm256_andnot_pd(done, pending);
+        previous = size;
+    }
+
+    // No positive rate: exactly zero when the payments just cover the principal, else NaN
+    const __m256d flat = _mm256_blendv_pd(_mm256_set1_pd(numeric_limits<double>::quiet_NaN()), zero,
+                                          _mm256_cmp_pd(cover, p, _CMP_EQ_OQ));
+    _mm256_storeu_pd(monthlyRate, _mm256_blendv_pd(flat, r, valid));
+    return round;
+}
+
+__attribute__((target("avx2,fma")))
+int monthlyRatesAvx2(const double* principal, const double* monthlyPayment, const int32_t* paymentCount,
+                     double* monthlyRate, size_t count) {
+    const int bits = exponentBits(paymentCount, count);
+    int slowest = 0;
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        slowest = max(slowest, rateBlockAvx2(principal + i, monthlyPayment + i, paymentCount + i, monthlyRate + i, bits));
+    }
+
+    if (i < count) {
+        double p[4] = {}, payment[4] = {}, out[4];
+        int32_t n[4] = {};
+        copy(principal + i, principal + count, p);
+        copy(monthlyPayment + i, monthlyPayment + count, payment);
+        copy(paymentCount + i, paymentCount + count, n);
+        slowest = max(slowest, rateBlockAvx2(p, payment, n, out, bits));
+        copy(out, out + (count - i), monthlyRate + i);
+    }
+    return slowest;
+}
+
+/*
+    AVX-512 Rate Solve (8 loans per instruction)
+
+    Programmer's Note:
+        - Same Newton iteration as the AVX2 block, with mask registers for the pending
+          lanes and masked loads/stores for the remainder.
+
+    Simpler Terms:
+        Finds the rates for eight loans in each CPU step using 512-bit registers.
+ */
+__attribute__((target("avx512f")))
+int monthlyRatesAvx512(const double* principal, const double* monthlyPayment, const int32_t* paymentCount,
+                       double* monthlyRate, size_t count) {
+    const int bits = exponentBits(paymentCount, count);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d tolerance = _mm512_set1_pd(RATE_TOLERANCE);
+    int slowest = 0;
+
+    for (size_t i = 0; i < count; i += 8) {
+        const size_t lanes = min<size_t>(8, count - i);
+        const __mmask8 active = static_cast<__mmask8>((1u << lanes) - 1);
+
+        const __m256i count32 = _mm512_castsi512_si256(_mm512_maskz_loadu_epi32(active, paymentCount + i));
+        const __m512i exponent = _mm512_cvtepi32_epi64(count32);
+        const __m512d n = _mm512_cvtepi32_pd(count32);
+        const __m512d p = _mm512_maskz_loadu_pd(active, principal + i);
+        const __m512d m = _mm512_maskz_loadu_pd(active, monthlyPayment + i);
+        const __m512d cover = _mm512_mul_pd(m, n);
+
+        const __mmask8 valid = _mm512_cmp_pd_mask(p, zero, _CMP_GT_OQ) & _mm512_cmp_pd_mask(m, zero, _CMP_GT_OQ)
+                             & _mm512_cmp_pd_mask(n, zero, _CMP_GT_OQ) & _mm512_cmp_pd_mask(cover, p, _CMP_GT_OQ);
+
+        __m512d r = _mm512_div_pd(_mm512_mul_pd(_mm512_set1_pd(2.0), _mm512_sub_pd(_mm512_div_pd(cover, p), one)),
+                                  _mm512_add_pd(n, one));
+        __mmask8 pending = valid;
+        __m512d previous = _mm512_set1_pd(numeric_limits<double>::infinity());
+
+        int round = 0;
+        while (round < MAX_RATE_ITERATIONS && pending != 0) {
+            ++round;
+            const __m512d base0 = _mm512_add_pd(one, r);
+            __m512d base = base0;
+            __m512d power_factor = one;
+            for (int bit = 0; bit < bits; ++bit) {
+                const __mmask8 take = _mm512_test_epi64_mask(exponent, _mm512_set1_epi64(int64_t{1} << bit));
+                power_factor = _mm512_mask_mul_pd(power_factor, take, power_factor, base);
+                base = _mm512_mul_pd(base, base);
+            }
+
+            const __m512d growth = _mm512_sub_pd(power_factor, one);
+            const __m512d value = _mm512_sub_pd(_mm512_div_pd(_mm512_mul_pd(_mm512_mul_pd(p, r), power_factor), growth), m);
+            const __m512d bend = _mm512_sub_pd(one, _mm512_div_pd(_mm512_mul_pd(r, n), _mm512_mul_pd(base0, growth)));
+            const __m512d slope = _mm512_div_pd(_mm512_mul_pd(_mm512_mul_pd(p, power_factor), bend), growth);
+            const __m512d step = _mm512_div_pd(value, slope);
+
+            const __m512d next = _mm512_max_pd(_mm512_sub_pd(r, step), _mm512_mul_pd(half, r));
+            r = _mm512_mask_mov_pd(r, pending, next);
+            const __m512d size = _mm512_abs_pd(step);
+            const __mmask8 done = _mm512_cmp_pd_mask(size, _mm512_mul_pd(tolerance, r), _CMP_LE_OQ)
+                                | _mm512_cmp_pd_mask(size, previous, _CMP_GE_OQ);
+            pending &= static_cast<__mmask8>(~done);
+            previous = size;
+        }
+        slowest = max(slowest, round);
+
+        const __m512d flat = _mm512_mask_mov_pd(_mm512_set1_pd(numeric_limits<double>::quiet_NaN()),
+                                                _mm512_cmp_pd_mask(cover, p, _CMP_EQ_OQ), zero);
+        _mm512_mask_storeu_pd(monthlyRate + i, active, _mm512_mask_mov_pd(flat, valid, r));
+    }
+    return slowest;
+}
+
+#endif // MORTGAGE_X86_DISPATCH
+
+} // namespace
+
+/*
+    Solve Max Principal
+
+    Programmer's Note:
+        - Prices one-dollar loans with the batch payment kernel (at the requested SIMD
+          level) in blocks of 256, then divides each payment by its factor.
+        - r == 0 gives M * n; n <= 0 gives 0.
+
+    Simpler Terms:
+        The largest loan each payment can carry.
+ */
+void solveMaxPrincipal(const double* monthlyPayment, const double* monthlyRate, const int32_t* paymentCount,
+                       double* principal, size_t count, SimdLevel level) {
+    double ones[PRINCIPAL_BLOCK];
+    fill(ones, ones + PRINCIPAL_BLOCK, 1.0);
+
+    for (size_t first = 0; first < count; first += PRINCIPAL_BLOCK) {
+        const size_t size = min(PRINCIPAL_BLOCK, count - first);
+        computeMonthlyPayments(ones, monthlyRate + first, paymentCount + first, principal + first, size, level);
+
+        for (size_t i = first; i < first + size; ++i) {
+            const double factor = principal[i];
+            if (paymentCount[i] <= 0) {
+                principal[i] = 0.0;
+            } else if (monthlyRate[i] == 0) {
+                principal[i] = monthlyPayment[i] * paymentCount[i];
+            } else {
+                principal[i] = monthlyPayment[i] / factor;
+            }
+        }
+    }
+}
+
+/*
+    Solve Monthly Rate
+
+    Programmer's Note:
+        - Dispatches to the widest supported level not above 'level'.
+        - The scalar level stops each loan on its own; the vector levels stop a block when
+          all of its lanes have converged, so they can run one or two extra rounds on some
+          loans; they agree with scalar to the accuracy described in the header, not bit for bit.
+
+    Simpler Terms:
+        The interest rate each payment implies.
+ */
+int solveMonthlyRate(const double* principal, const double* monthlyPayment, const int32_t* paymentCount,
+                     double* monthlyRate, size_t count, SimdLevel level) {
+    level = min(level, detectSimdLevel());
+
+#ifdef MORTGAGE_X86_DISPATCH
+    if (level == SimdLevel::Avx512) {
+        return monthlyRatesAvx512(principal, monthlyPayment, paymentCount, monthlyRate, count);
+    }
+    if (level == SimdLevel::Avx2) {
+        return monthlyRatesAvx2(principal, monthlyPayment, paymentCount, monthlyRate, count);
+    }
+#endif
+
+    return monthlyRatesScalar(principal, monthlyPayment, paymentCount, monthlyRate, count);
+}
+
+/*
+    Solve Minimum Term
+
+    Programmer's Note:
+        - The closed form can land one payment off at the boundary through rounding, so the
+          candidate is moved down while the shorter term is still affordable and up while it
+          is not, against forwardPayment(). Each loop runs at most a step or two.
+        - r == 0: ceil(P / M). Terms beyond INT32_MAX payments are reported as 0.
+
+    Simpler Terms:
+        The fewest monthly payments that pay each loan off.
+ */
+void solveMinimumTerm(const double* principal, const double* monthlyPayment, const double* monthlyRate,
+                      int32_t* paymentCount, size_t count) {
+    constexpr double MAX_TERM = numeric_limits<int32_t>::max() - 1;
+
+    for (size_t i = 0; i < count; ++i) {
+        const double p = principal[i];
+        const double m = monthlyPayment[i];
+        const double r = monthlyRate[i];
+        paymentCount[i] = 0;
+
+        if (!(p > 0.0) || !(m > 0.0) || !(r >= 0.0)) {
+            continue;
+        }
+        if (r == 0) {
+            const double payments = ceil(p / m);
+            if (payments <= MAX_TERM) {
+                paymentCount[i] = static_cast<int32_t>(payments);
+            }
+            continue;
+        }
+        if (m <= r * p) {
+            continue;       // Never gets past the interest
+        }
+
+        const double payments = ceil(-log1p(-r * p / m) / log1p(r));
+        if (!(payments <= MAX_TERM)) {
+            continue;
+        }
+
+        int32_t n = max<int32_t>(1, static_cast<int32_t>(payments));
+        while (n > 1 && forwardPayment(p, r, n - 1) <= m) {
+            --n;
+        }
+        while (forwardPayment(p, r, n) > m && n < MAX_TERM) {
+            ++n;
+        }
+        paymentCount[i] = n;
+    }
+}
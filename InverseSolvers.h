@@ -0,0 +1,55 @@
+// Inverse Solvers Specification
+
+#ifndef INVERSE_SOLVERS_H
+#define INVERSE_SOLVERS_H
+
+#include "PaymentKernels.h"
+#include <cstddef>
+#include <cstdint>
+
+/*
+    Batch Inverse Solvers
+
+    Programmer's Note:
+        - The forward formula is  M = P * r * F / (F - 1),  F = (1 + r)^n  (Mortgage::getMonthlyPayment).
+          These solve it for P, r or n over arrays of loans (structure of arrays, like
+          computeMonthlyPayments). Rates are monthly decimals; the nominal annual
+          rate in percent (what Mortgage::setAnnualInterestRate takes) is r * 1200.
+        - solveMaxPrincipal: P = M / factor, with the factor from the batch payment kernel
+          (one-dollar loans). Zero-rate loans use P = M * n.
+        - solveMonthlyRate: Newton's method on M(r). The starting guess
+          r0 = 2 * (M * n / P - 1) / (n + 1) solves the first-order expansion of M(r); since
+          M(r) is increasing and convex, r0 is never below the root and Newton converges
+          from above without overshooting. A loan is done when its step falls below 1e-12
+          relative (the next error would be far below one ULP) or stops shrinking (rounding
+          noise; at rates under 1% F - 1 loses digits and r is only determined to ~1e-10,
+          though the payment still round-trips to ~1e-12). Vector lanes stop as a block, and
+          nothing runs more than MAX_RATE_ITERATIONS (16) rounds; rates from 0.25% to 50%
+          and terms of 1 to 50 years need at most 8.
+          Payments that do not cover the principal at a zero rate (M * n < P) give NaN;
+          M * n == P gives 0. Returns the number of rounds the slowest block needed.
+        - solveMinimumTerm: smallest n with M(n) <= M, from n = -log(1 - r P / M) / log(1 + r)
+          and then checked against the forward formula Mortgage uses
+          (annuity_math::paymentFactor). A payment that does not exceed the first month's
+          interest never pays the loan off and gives 0.
+        - Vector levels process 4 (AVX2) or 8 (AVX-512) loans per instruction.
+        - Round trips: feeding a solved value back through getMonthlyPayment() reproduces
+          the target payment to ~1e-12 relative or better, and solved terms equal the
+          originals (checked in mortgage_bench).
+
+    Simpler Terms:
+        The calculator in reverse: the most someone can borrow for a payment, the rate a
+        payment implies, and the shortest loan a payment can cover, for many loans at once.
+ */
+inline constexpr int MAX_RATE_ITERATIONS = 16;
+
+void solveMaxPrincipal(const double* monthlyPayment, const double* monthlyRate, const std::int32_t* paymentCount,
+                       double* principal, std::size_t count, SimdLevel level = detectSimdLevel());
+
+int solveMonthlyRate(const double* principal, const double* monthlyPayment, const std::int32_t* paymentCount,
+                     double* monthlyRate, std::size_t count, SimdLevel level = detectSimdLevel());
+
+void solveMinimumTerm(const double* principal, const double* monthlyPayment, const double* monthlyRate,
+                      std::int32_t* paymentCount, std::size_t count);
+
+#endif // INVERSE_SOLVERS_H
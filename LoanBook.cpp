@@ -0,0 +1,104 @@
+// LoanBook Class Implementation
+
+#include "LoanBook.h"
+#include "PerfCounters.h"
+
+using namespace std;
+
+/*
+    Reserve
+
+    Programmer's Note:
+        - Pre-allocates all three columns so bulk loading does not reallocate.
+
+    Simpler Terms:
+        Makes room for a known number of loans up front.
+ */
+void LoanBook::reserve(size_t count) {
+    principal.reserve(count);
+    monthly_rate.reserve(count);
+    payment_count.reserve(count);
+}
+
+/*
+    Add Loan
+
+    Programmer's Note:
+        - Mirrors Mortgage::setAnnualInterestRate / setTotalYearsToRepay conversions
+          so the stored values are bit-identical to a Mortgage object's members.
+
+    Simpler Terms:
+        Adds one loan to the end of the list.
+ */
+void LoanBook::addLoan(double amount, double annualRatePercent, int years) {
+    const double annual_interest_rate = annualRatePercent / 100.0;  // Percentage -> decimal
+    principal.push_back(amount);
+    monthly_rate.push_back(annual_interest_rate / 12.0);           // Annual -> monthly
+    payment_count.push_back(years * 12);                           // Years -> monthly payments
+}
+
+/*
+    Resize / Set Loan
+
+    Programmer's Note:
+        - resize() changes the number of loans; new slots are zero until setLoan() fills them.
+        - setLoan() overwrites one slot and touches no shared state, so calls for different
+          indices may run on different threads.
+
+    Simpler Terms:
+        Makes the list a given length, then fills in any loan by its position.
+ */
+void LoanBook::resize(size_t count) {
+    principal.resize(count);
+    monthly_rate.resize(count);
+    payment_count.resize(count);
+}
+
+void LoanBook::setLoan(size_t index, double amount, double annualRatePercent, int years) {
+    const double annual_interest_rate = annualRatePercent / 100.0;  // Percentage -> decimal
+    principal[index] = amount;
+    monthly_rate[index] = annual_interest_rate / 12.0;             // Annual -> monthly
+    payment_count[index] = years * 12;                             // Years -> monthly payments
+}
+
+/*
+    Clear
+
+    Programmer's Note:
+        - Removes all loans but keeps the allocated capacity for reuse.
+
+    Simpler Terms:
+        Empties the list of loans.
+ */
+void LoanBook::clear() {
+    principal.clear();
+    monthly_rate.clear();
+    payment_count.clear();
+}
+
+/*
+    Compute Monthly Payments
+
+    Programmer's Note:
+        - Thin wrappers over the dispatched kernel in PaymentKernels.
+
+    Simpler Terms:
+        Prices every loan in the book.
+ */
+void LoanBook::computeMonthlyPayments(span<double> out) const {
+    computeMonthlyPayments(out, detectSimdLevel());
+}
+
+void LoanBook::computeMonthlyPayments(span<double> out, SimdLevel level) const {
+    perf_counters::ScopedTimer timer(perf_counters::Phase::Pricing);
+    perf_counters::add(perf_counters::Counter::LoansPriced, principal.size());
+    ::computeMonthlyPayments(principal.data(), monthly_rate.data(), payment_count.data(),
+                             out.data(), principal.size(), level);
+}
+
+void LoanBook::computeMonthlyPaymentsExtended(span<double> out) const {
+    perf_counters::ScopedTimer timer(perf_counters::Phase::Pricing);
+    perf_counters::add(perf_counters::Counter::LoansPriced, principal.size());
+    ::computeMonthlyPaymentsExtended(principal.data(), monthly_rate.data(), payment_count.data(),
+                                     out.data(), principal.size());
+}
@@ -0,0 +1,118 @@
+// LoanBook Class Specification
+
+#ifndef LOAN_BOOK_H
+#define LOAN_BOOK_H
+
+#include "PaymentKernels.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <vector>
+
+/*
+    Aligned Allocator
+
+    Programmer's Note:
+        - Minimal allocator returning 64-byte aligned storage (one cache line,
+          one AVX-512 register), so LoanBook columns start on a vector boundary.
+
+    Simpler Terms:
+        Makes sure each list of numbers starts at a memory address the CPU likes.
+ */
+template <typename T>
+struct AlignedAllocator {
+    using value_type = T;
+    static constexpr std::size_t alignment = 64;
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U>&) const noexcept { return true; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+/*
+    Class: LoanBook
+
+    Programmer's Note:
+        - Structure-of-arrays container for many fixed-rate loans: principal, monthly rate
+          and payment count each live in their own contiguous, 64-byte aligned array.
+        - Rates and payment counts are converted exactly as Mortgage's setters do
+          (rate / 100 / 12, years * 12), so both paths price from identical inputs.
+        - computeMonthlyPayments() runs the SIMD kernel from PaymentKernels over the whole book.
+
+    Simpler Terms:
+        A list of many loans stored column by column, so the computer can
+        price several of them at the same time.
+ */
+class LoanBook {
+private:
+    AlignedVector<double> principal;        // Amount borrowed per loan
+    AlignedVector<double> monthly_rate;     // Monthly interest rate per loan (decimal)
+    AlignedVector<std::int32_t> payment_count;  // Number of monthly payments per loan
+
+public:
+    /*
+        Building the Book
+
+        Programmer's Note:
+            - addLoan takes the same units as the Mortgage setters
+              (rate as a percentage, term in years).
+            - resize + setLoan let several threads fill disjoint slots of a pre-sized book
+              (the bulk loan-tape reader does this); setLoan converts exactly like addLoan.
+
+        Simpler Terms:
+            Add loans to the list, make room ahead of time, or empty the list.
+     */
+    void reserve(std::size_t count);
+    void addLoan(double amount, double annualRatePercent, int years);
+    void resize(std::size_t count);
+    void setLoan(std::size_t index, double amount, double annualRatePercent, int years);
+    void clear();
+
+    [[nodiscard]] std::size_t size() const { return principal.size(); }
+
+    /*
+        Column Access
+
+        Programmer's Note:
+            - Read-only views of the underlying arrays, for kernels that work on raw columns.
+
+        Simpler Terms:
+            Look at one column of the loan list at a time.
+     */
+    [[nodiscard]] std::span<const double> principals() const { return principal; }
+    [[nodiscard]] std::span<const double> monthlyRates() const { return monthly_rate; }
+    [[nodiscard]] std::span<const std::int32_t> paymentCounts() const { return payment_count; }
+
+    /*
+        Batch Monthly Payments
+
+        Programmer's Note:
+            - Writes one payment per loan into 'out' (which must hold size() values).
+            - Uses the widest SIMD level the CPU supports unless a level is given;
+              see PaymentKernels.h for the accuracy bound against Mortgage::getMonthlyPayment().
+            - computeMonthlyPaymentsExtended() is the correctly rounded audit mode (scalar, slower).
+
+        Simpler Terms:
+            Works out every loan's monthly payment in one call.
+     */
+    void computeMonthlyPayments(std::span<double> out) const;
+    void computeMonthlyPayments(std::span<double> out, SimdLevel level) const;
+    void computeMonthlyPaymentsExtended(std::span<double> out) const;
+};
+
+#endif // LOAN_BOOK_H
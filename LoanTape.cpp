@@ -0,0 +1,363 @@
+// Loan Tape Implementation
+
+#include "LoanTape.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MORTGAGE_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+/*
+    Class: TapeMapping
+
+    Programmer's Note:
+        - Read-only view of the whole tape: an mmap on POSIX (with a sequential-access hint),
+          a heap copy elsewhere. An empty file opens fine with size() == 0.
+
+    Simpler Terms:
+        Makes the loan file's bytes available without copying them around.
+ */
+class TapeMapping {
+public:
+    TapeMapping() = default;
+    TapeMapping(const TapeMapping&) = delete;
+    TapeMapping& operator=(const TapeMapping&) = delete;
+
+#ifdef MORTGAGE_HAVE_MMAP
+    ~TapeMapping() {
+        if (mapped != nullptr) {
+            ::munmap(mapped, bytes);
+        }
+    }
+#endif
+
+    bool open(const string& filename) {
+#ifdef MORTGAGE_HAVE_MMAP
+        const int descriptor = ::open(filename.c_str(), O_RDONLY);
+        struct stat info{};
+        if (descriptor < 0 || ::fstat(descriptor, &info) != 0) {
+            if (descriptor >= 0) {
+                ::close(descriptor);
+            }
+            return false;
+        }
+
+        bytes = static_cast<size_t>(info.st_size);
+        if (bytes > 0) {
+            void* view = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (view != MAP_FAILED) {
+                mapped = view;
+                base = static_cast<const char*>(view);
+                ::madvise(view, bytes, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(descriptor);
+        return bytes == 0 || base != nullptr;
+#else
+        ifstream inFile(filename, ios::binary);
+        if (!inFile) {
+            return false;
+        }
+        buffer.assign(istreambuf_iterator<char>(inFile), istreambuf_iterator<char>());
+        base = buffer.data();
+        bytes = buffer.size();
+        return true;
+#endif
+    }
+
+    [[nodiscard]] const char* data() const { return base; }
+    [[nodiscard]] size_t size() const { return bytes; }
+
+private:
+    const char* base = nullptr;
+    size_t bytes = 0;
+#ifdef MORTGAGE_HAVE_MMAP
+    void* mapped = nullptr;
+#else
+    vector<char> buffer;
+#endif
+};
+
+/*
+    Struct: TapeChunk
+
+    Programmer's Note:
+        - One newline-aligned byte range of the tape and what its parse produced.
+          Reject line numbers are relative to the chunk (1 = its first line) until the
+          chunks are merged; the text pointers point into the mapping.
+
+    Simpler Terms:
+        One piece of the loan file, with the loans and bad lines found in it.
+ */
+struct TapeReject {
+    size_t line;
+    LoanCheck reason;
+    const char* first;
+    const char* last;
+};
+
+struct TapeChunk {
+    size_t begin = 0;
+    size_t end = 0;
+    size_t lines = 0;
+    size_t first_loan = 0;                  // Index of this chunk's first loan in the book
+    vector<LoanRecord> loans;
+    vector<TapeReject> rejects;
+};
+
+/*
+    Split Into Chunks
+
+    Programmer's Note:
+        - Each chunk after the first starts just past the first newline at or beyond
+          chunkBytes from the previous start, so no line is ever split. A line longer than
+          chunkBytes simply makes its chunk longer.
+
+    Simpler Terms:
+        Cuts the file into pieces of about the same size, only ever between two lines.
+ */
+vector<TapeChunk> splitIntoChunks(const char* data, size_t size, size_t chunkBytes) {
+    vector<TapeChunk> chunks;
+    size_t begin = 0;
+    while (begin < size) {
+        size_t end = size;
+        if (size - begin > chunkBytes) {
+            const size_t probe = begin + chunkBytes - 1;
+            const void* newline = memchr(data + probe, '\n', size - probe);
+            if (newline != nullptr) {
+                end = static_cast<size_t>(static_cast<const char*>(newline) - data) + 1;
+            }
+        }
+
+        TapeChunk chunk;
+        chunk.begin = begin;
+        chunk.end = end;
+        chunks.push_back(move(chunk));
+        begin = end;
+    }
+    return chunks;
+}
+
+/*
+    Parse Chunk
+
+    Programmer's Note:
+        - Splits the chunk into lines with memchr, parses each with parseLoanCsvLine and
+          validates it with checkLoan. Blank lines are skipped, and so is a header on the
+          tape's first line (only chunk 0 may have one).
+        - The loan list is reserved from a newline count first (a cheap vectorized scan),
+          so it is never regrown and copied while parsing.
+
+    Simpler Terms:
+        Reads every line in one piece of the file and sorts the loans into good and bad.
+ */
+void parseChunk(const char* data, TapeChunk& chunk, const LoanTapeLimits& limits, bool firstChunk) {
+    const char* cursor = data + chunk.begin;
+    const char* end = data + chunk.end;
+    chunk.loans.reserve(static_cast<size_t>(count(cursor, end, '\n')) + 1);
+
+    while (cursor < end) {
+        const char* newline = static_cast<const char*>(memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+        const char* lineEnd = newline != nullptr ? newline : end;
+        const char* first = cursor;
+        cursor = newline != nullptr ? newline + 1 : end;
+        ++chunk.lines;
+
+        if (first == lineEnd || (lineEnd - first == 1 && *first == '\r')) {
+            continue;  // Blank lines are ignored
+        }
+
+        LoanRecord record{};
+        LoanCheck check = LoanCheck::Malformed;
+        if (parseLoanCsvLine(first, lineEnd, record)) {
+            check = checkLoan(record, limits);
+        } else if (firstChunk && chunk.lines == 1 && looksLikeCsvHeader(first, lineEnd)) {
+            continue;  // Column header line
+        }
+
+        if (check == LoanCheck::Valid) {
+            chunk.loans.push_back(record);
+        } else {
+            chunk.rejects.push_back({ chunk.lines, check, first, lineEnd });
+        }
+    }
+}
+
+/*
+    Write Rejects
+
+    Programmer's Note:
+        - One "line,reason,record" row per rejected record, chunks in file order. The record
+          is copied as it appeared (minus a trailing '\r'), so it may itself contain commas.
+
+    Simpler Terms:
+        Saves the bad lines, with where they were and what was wrong, for someone to fix.
+ */
+bool writeRejects(const string& filename, const vector<TapeChunk>& chunks) {
+    ofstream outFile(filename, ios::binary);
+    if (!outFile) {
+        cerr << "ERROR: Could not open reject file " << filename << "." << endl;
+        return false;
+    }
+
+    string text = "line,reason,record\n";
+    size_t firstLine = 1;
+    for (const TapeChunk& chunk : chunks) {
+        for (const TapeReject& reject : chunk.rejects) {
+            const char* last = reject.last;
+            if (last != reject.first && last[-1] == '\r') {
+                --last;
+            }
+            text += to_string(firstLine + reject.line - 1);
+            text += ',';
+            text += loanCheckName(reject.reason);
+            text += ',';
+            text.append(reject.first, last);
+            text += '\n';
+        }
+        firstLine += chunk.lines;
+
+        if (text.size() >= (1 << 20)) {
+            outFile.write(text.data(), static_cast<streamsize>(text.size()));
+            text.clear();
+        }
+    }
+    outFile.write(text.data(), static_cast<streamsize>(text.size()));
+
+    if (!outFile) {
+        cerr << "ERROR: Could not write reject file " << filename << "." << endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+/*
+    Check Loan
+
+    Programmer's Note:
+        - See LoanCheck in LoanTape.h for the order of the tests.
+
+    Simpler Terms:
+        Decides whether one loan is usable.
+ */
+LoanCheck checkLoan(const LoanRecord& record, const LoanTapeLimits& limits) {
+    if (!isfinite(record.loan_amount) || !isfinite(record.annual_interest_rate)) {
+        return LoanCheck::NonFinite;
+    }
+    if (record.loan_amount <= 0.0) {
+        return LoanCheck::NonPositiveAmount;
+    }
+    if (record.loan_amount > limits.max_amount) {
+        return LoanCheck::AmountAboveLimit;
+    }
+    if (record.annual_interest_rate < 0.0) {
+        return LoanCheck::NegativeRate;
+    }
+    if (record.annual_interest_rate > limits.max_rate_percent) {
+        return LoanCheck::RateAboveLimit;
+    }
+    if (record.total_years_to_repay < 1 || record.total_years_to_repay > limits.max_years) {
+        return LoanCheck::TermOutOfRange;
+    }
+    return LoanCheck::Valid;
+}
+
+const char* loanCheckName(LoanCheck check) {
+    switch (check) {
+        case LoanCheck::Valid:             return "valid";
+        case LoanCheck::Malformed:         return "malformed";
+        case LoanCheck::NonFinite:         return "non_finite";
+        case LoanCheck::NonPositiveAmount: return "non_positive_amount";
+        case LoanCheck::AmountAboveLimit:  return "amount_above_limit";
+        case LoanCheck::NegativeRate:      return "negative_rate";
+        case LoanCheck::RateAboveLimit:    return "rate_above_limit";
+        case LoanCheck::TermOutOfRange:    return "term_out_of_range";
+        default:                           return "unknown";
+    }
+}
+
+/*
+    Load Loan Tape
+
+    Programmer's Note:
+        - Pass 1 (parallel): parse and validate each chunk into its own loan and reject lists.
+        - A prefix sum over the chunks gives each chunk's first book index; the book is
+          resized once.
+        - Pass 2 (parallel): each chunk copies its loans into its slice of the book with
+          LoanBook::setLoan, then frees its list.
+        - Rejects are written last, on the calling thread (they are expected to be rare).
+
+    Simpler Terms:
+        Reads the file in pieces at the same time, then puts all the good loans into the
+        loan list in their original order.
+ */
+bool loadLoanTape(const string& filename, LoanBook& book, WorkStealingPool& pool,
+                  LoanTapeStats& stats, const LoanTapeOptions& options) {
+    perf_counters::ScopedTimer timer(perf_counters::Phase::TapeIngest);
+    const auto start = chrono::steady_clock::now();
+    stats = LoanTapeStats{};
+    book.clear();
+
+    TapeMapping tape;
+    if (!tape.open(filename)) {
+        cerr << "ERROR: Could not open loan tape " << filename << "." << endl;
+        return false;
+    }
+    stats.bytes = tape.size();
+    perf_counters::add(perf_counters::Counter::BytesRead, tape.size());
+
+    vector<TapeChunk> chunks = splitIntoChunks(tape.data(), tape.size(), max<size_t>(options.chunk_bytes, 1));
+    stats.chunks = chunks.size();
+
+    pool.parallelFor(chunks.size(), 1, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; ++c) {
+            parseChunk(tape.data(), chunks[c], options.limits, c == 0);
+        }
+    });
+
+    size_t loaded = 0;
+    for (TapeChunk& chunk : chunks) {
+        chunk.first_loan = loaded;
+        loaded += chunk.loans.size();
+        stats.lines += chunk.lines;
+        stats.loans_rejected += chunk.rejects.size();
+        for (const TapeReject& reject : chunk.rejects) {
+            ++stats.rejected_by_reason[static_cast<size_t>(reject.reason)];
+        }
+    }
+
+    book.resize(loaded);
+    pool.parallelFor(chunks.size(), 1, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; ++c) {
+            TapeChunk& chunk = chunks[c];
+            for (size_t i = 0; i < chunk.loans.size(); ++i) {
+                const LoanRecord& loan = chunk.loans[i];
+                book.setLoan(chunk.first_loan + i, loan.loan_amount, loan.annual_interest_rate,
+                             loan.total_years_to_repay);
+            }
+            vector<LoanRecord>().swap(chunk.loans);
+        }
+    });
+    stats.loans_loaded = loaded;
+
+    const bool ok = options.reject_path.empty() || writeRejects(options.reject_path, chunks);
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return ok;
+}
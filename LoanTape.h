@@ -0,0 +1,103 @@
+// Loan Tape Specification
+
+#ifndef LOAN_TAPE_H
+#define LOAN_TAPE_H
+
+#include "BatchPricer.h"
+#include "LoanBook.h"
+#include "WorkStealingPool.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+    Loan Checks
+
+    Programmer's Note:
+        - The result of validating one loan record. Valid loans are priced; every other
+          value is a reason to reject the record, named by loanCheckName() (the spelling
+          used in reject files).
+        - checkLoan() tests, in this order: non-finite amount or rate (from_chars accepts
+          "nan" and "inf"), amount <= 0, amount above the limit, rate < 0 (a zero rate is an
+          interest-free loan, priced as amount / payments), rate above the limit, term
+          outside 1..max_years.
+          Malformed is for lines that do not parse at all.
+
+    Simpler Terms:
+        Whether a loan makes sense, and if not, why not.
+ */
+enum class LoanCheck : std::uint8_t {
+    Valid,
+    Malformed,              // Not "amount,rate,years"
+    NonFinite,              // Amount or rate is NaN or infinite
+    NonPositiveAmount,
+    AmountAboveLimit,
+    NegativeRate,
+    RateAboveLimit,
+    TermOutOfRange,
+    Count
+};
+
+inline constexpr std::size_t LOAN_CHECK_COUNT = static_cast<std::size_t>(LoanCheck::Count);
+
+struct LoanTapeLimits {
+    double max_amount = 1e12;           // Largest accepted loan amount (keeps totals printable)
+    double max_rate_percent = 100.0;    // Highest accepted annual rate, percent
+    int max_years = 100;                // Longest accepted term
+};
+
+[[nodiscard]] LoanCheck checkLoan(const LoanRecord& record, const LoanTapeLimits& limits = {});
+[[nodiscard]] const char* loanCheckName(LoanCheck check);
+
+/*
+    Loan Tape Options / Statistics
+
+    Programmer's Note:
+        - reject_path names a CSV file that receives one "line,reason,record" row per rejected
+          record, in file order (line numbers are 1-based, the record is the original text).
+          Empty means rejects are only counted.
+        - chunk_bytes is the size of the pieces the file is cut into for parallel parsing.
+        - rejected_by_reason is indexed by LoanCheck (the Valid slot stays 0).
+
+    Simpler Terms:
+        Settings for reading a loan file, and what happened when it was read.
+ */
+struct LoanTapeOptions {
+    std::string reject_path;                // Where rejected records go; empty = nowhere
+    LoanTapeLimits limits;
+    std::size_t chunk_bytes = 4 << 20;      // Bytes per parallel parsing chunk
+};
+
+struct LoanTapeStats {
+    std::size_t bytes = 0;                  // Size of the tape
+    std::size_t lines = 0;                  // Lines seen, including header and blank lines
+    std::size_t chunks = 0;
+    std::size_t loans_loaded = 0;
+    std::size_t loans_rejected = 0;
+    std::array<std::size_t, LOAN_CHECK_COUNT> rejected_by_reason{};
+    double seconds = 0.0;
+};
+
+/*
+    Function: loadLoanTape
+
+    Programmer's Note:
+        - Bulk reader for large "amount,rate,years" CSV tapes (same line syntax as batch
+          mode, parsed by the same parseLoanCsvLine). The file is memory-mapped (read into
+          memory where mmap is unavailable), cut into newline-aligned chunks, and the chunks
+          are parsed and validated on the pool. Valid loans are then written straight into
+          'book' (replacing its contents) in file order, also in parallel.
+        - Peak extra memory is about one LoanRecord per valid line, held per chunk between
+          the two parallel passes.
+        - Returns false after an ERROR line if the tape cannot be opened or the reject file
+          cannot be written; 'stats' is filled in either way as far as the load got.
+
+    Simpler Terms:
+        Reads a huge loan file using every core, keeps the sensible loans, and writes the
+        rest to a separate file saying what was wrong with each one.
+ */
+bool loadLoanTape(const std::string& filename, LoanBook& book, WorkStealingPool& pool,
+                  LoanTapeStats& stats, const LoanTapeOptions& options = {});
+
+#endif // LOAN_TAPE_H
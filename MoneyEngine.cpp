@@ -0,0 +1,16 @@
+// Money Engine Implementation
+
+#include "MoneyEngine.h"
+
+/*
+    Explicit Instantiations
+
+    Programmer's Note:
+        - The two supported money types are compiled here once; MoneyEngine.h declares
+          them extern so other translation units do not instantiate them again.
+
+    Simpler Terms:
+        Builds the decimal and the whole-cents versions of the loan engine.
+ */
+template class AmortizedLoan<double>;
+template class AmortizedLoan<Cents64>;
@@ -0,0 +1,222 @@
+// Money Engine Specification
+
+#ifndef MONEY_ENGINE_H
+#define MONEY_ENGINE_H
+
+#include "Mortgage.h"
+#include <cmath>
+#include <cstdint>
+#include <span>
+
+/*
+    Struct: Cents64
+
+    Programmer's Note:
+        - Exact money amount as a signed 64-bit count of cents (range about +/- $92 quadrillion).
+        - Only integer arithmetic is defined; conversions to and from dollars round to the
+          nearest cent and are meant for input and output, not for inner loops.
+
+    Simpler Terms:
+        An amount of money counted in whole cents, so nothing is ever lost to rounding.
+ */
+struct Cents64 {
+    std::int64_t cents = 0;
+
+    static Cents64 fromDollars(double dollars) { return { std::llround(dollars * 100.0) }; }
+    [[nodiscard]] constexpr double toDollars() const { return static_cast<double>(cents) / 100.0; }
+
+    constexpr Cents64& operator+=(Cents64 other) { cents += other.cents; return *this; }
+    constexpr Cents64& operator-=(Cents64 other) { cents -= other.cents; return *this; }
+    friend constexpr Cents64 operator+(Cents64 a, Cents64 b) { return { a.cents + b.cents }; }
+    friend constexpr Cents64 operator-(Cents64 a, Cents64 b) { return { a.cents - b.cents }; }
+    friend constexpr auto operator<=>(Cents64 a, Cents64 b) = default;
+};
+
+/*
+    Money Traits
+
+    Programmer's Note:
+        - Everything AmortizedLoan needs from a money type: how to hold the monthly rate,
+          how to convert dollars, and how to compute one month's interest rounded to the cent.
+        - double: the usual floating-point math, rounding each interest charge with std::round.
+        - Cents64: the annual rate is held as an integer number of millionths of a percent,
+          so monthly interest = balance * rate / 1,200,000,000 rounded half up, computed
+          with integer operations only (no overflow for any balance below $92 quadrillion and
+          rates below 2147%). Amounts and rates are expected to be non-negative.
+
+    Simpler Terms:
+        The rules for doing money math with decimals or with whole cents.
+ */
+template <typename Money>
+struct MoneyTraits;
+
+template <>
+struct MoneyTraits<double> {
+    using Rate = double;   // Monthly rate as a decimal
+
+    static Rate monthlyRate(double annualRatePercent) { return annualRatePercent / 100.0 / 12.0; }
+    static double fromDollars(double dollars) { return std::round(dollars * 100.0) / 100.0; }
+    static double toDollars(double amount) { return amount; }
+    static double zero() { return 0.0; }
+
+    static double monthlyInterest(double balance, Rate rate) {
+        return std::round(balance * rate * 100.0) / 100.0;
+    }
+};
+
+template <>
+struct MoneyTraits<Cents64> {
+    struct Rate {
+        std::int64_t millionths_of_percent;   // Annual rate * 10^6 (6.125% -> 6125000)
+    };
+
+    static constexpr std::int64_t RATE_DENOMINATOR = 1'200'000'000;   // 12 months * 100% * 10^6
+
+    static Rate monthlyRate(double annualRatePercent) { return { std::llround(annualRatePercent * 1e6) }; }
+    static Cents64 fromDollars(double dollars) { return Cents64::fromDollars(dollars); }
+    static double toDollars(Cents64 amount) { return amount.toDollars(); }
+    static Cents64 zero() { return {}; }
+
+    // balance * rate / denominator, rounded half up, without a 128-bit intermediate:
+    // split balance = q * D + r so that r * rate (< 2^62) cannot overflow
+    static Cents64 monthlyInterest(Cents64 balance, Rate rate) {
+        const std::int64_t quotient = balance.cents / RATE_DENOMINATOR;
+        const std::int64_t remainder = balance.cents % RATE_DENOMINATOR;
+        return { quotient * rate.millionths_of_percent
+                 + (remainder * rate.millionths_of_percent + RATE_DENOMINATOR / 2) / RATE_DENOMINATOR };
+    }
+};
+
+/*
+    Struct: MoneyRow
+
+    Programmer's Note:
+        - One month of a servicer-style schedule in the engine's money type.
+
+    Simpler Terms:
+        One month of the payment plan, in dollars or in cents.
+ */
+template <typename Money>
+struct MoneyRow {
+    int payment_number;
+    Money payment_amount;
+    Money interest;
+    Money principal;
+    Money remaining_balance;
+};
+
+/*
+    Class Template: AmortizedLoan
+
+    Programmer's Note:
+        - Servicer-style amortization: the level payment is Mortgage::getMonthlyPayment()
+          rounded to the cent, each month's interest is rounded to the cent, and the final
+          payment (or any payment that would overshoot) is adjusted to exactly clear the
+          balance, so the schedule always reconciles to zero.
+        - AmortizedLoan<Cents64> runs the monthly loop with integer operations only;
+          AmortizedLoan<double> follows the same rules in floating point and is kept for
+          comparison (it can disagree by a cent when a product lands on a rounding boundary).
+        - Both instantiations are compiled once, in MoneyEngine.cpp.
+
+    Simpler Terms:
+        A payment plan that works like a real loan servicer's statement:
+        every amount is in whole cents and the last payment settles the loan exactly.
+ */
+template <typename Money>
+class AmortizedLoan {
+public:
+    using Traits = MoneyTraits<Money>;
+
+    AmortizedLoan(double loanAmount, double annualRatePercent, int years);
+
+    [[nodiscard]] Money loanAmount() const { return loan_amount; }
+    [[nodiscard]] Money monthlyPayment() const { return monthly_payment; }
+    [[nodiscard]] int numberOfPayments() const { return number_of_payments; }
+
+    // Fills numberOfPayments() rows and returns the total amount paid
+    Money fillSchedule(std::span<MoneyRow<Money>> rows) const;
+
+    // Total amount paid over the life of the loan, including the adjusted final payment
+    [[nodiscard]] Money totalPayback() const;
+
+private:
+    Money loan_amount;
+    Money monthly_payment;
+    typename Traits::Rate monthly_rate;
+    int number_of_payments;
+
+    template <typename RowSink>
+    Money amortize(RowSink&& sink) const;
+};
+
+/*
+    AmortizedLoan Constructor
+
+    Programmer's Note:
+        - The level payment comes from the regular Mortgage formula, rounded to the cent.
+
+    Simpler Terms:
+        Sets up the loan and works out its monthly payment in cents.
+ */
+template <typename Money>
+AmortizedLoan<Money>::AmortizedLoan(double loanAmount, double annualRatePercent, int years)
+    : loan_amount(Traits::fromDollars(loanAmount)),
+      monthly_payment(Traits::zero()),
+      monthly_rate(Traits::monthlyRate(annualRatePercent)),
+      number_of_payments(years > 0 ? years * 12 : 0) {
+    Mortgage loan(false);
+    loan.setLoanAmount(Traits::toDollars(loan_amount));
+    loan.setAnnualInterestRate(annualRatePercent);
+    loan.setTotalYearsToRepay(years);
+    monthly_payment = Traits::fromDollars(loan.getMonthlyPayment());
+}
+
+/*
+    Amortize
+
+    Programmer's Note:
+        - The monthly loop shared by fillSchedule and totalPayback; 'sink' receives each row.
+        - Once the balance reaches zero the remaining rows are all zero.
+
+    Simpler Terms:
+        Steps through every month, charging interest and paying down the loan.
+ */
+template <typename Money>
+template <typename RowSink>
+Money AmortizedLoan<Money>::amortize(RowSink&& sink) const {
+    const Money zero = Traits::zero();
+    Money balance = loan_amount;
+    Money total = zero;
+
+    for (int pmt_number = 1; pmt_number <= number_of_payments; ++pmt_number) {
+        const Money interest = Traits::monthlyInterest(balance, monthly_rate);
+        Money principal = monthly_payment - interest;
+
+        // Final payment, or a payment that would overshoot: pay off exactly what is owed
+        if (pmt_number == number_of_payments || principal > balance) {
+            principal = balance;
+        }
+
+        const Money payment = interest + principal;
+        balance -= principal;
+        total += payment;
+        sink(MoneyRow<Money>{ pmt_number, payment, interest, principal, balance });
+    }
+
+    return total;
+}
+
+template <typename Money>
+Money AmortizedLoan<Money>::fillSchedule(std::span<MoneyRow<Money>> rows) const {
+    return amortize([&rows](const MoneyRow<Money>& row) { rows[static_cast<std::size_t>(row.payment_number - 1)] = row; });
+}
+
+template <typename Money>
+Money AmortizedLoan<Money>::totalPayback() const {
+    return amortize([](const MoneyRow<Money>&) {});
+}
+
+extern template class AmortizedLoan<double>;
+extern template class AmortizedLoan<Cents64>;
+
+#endif // MONEY_ENGINE_H
@@ -0,0 +1,285 @@
+// Monte Carlo Cash-Flow Simulator Implementation
+
+#include "MonteCarlo.h"
+#include "CounterRng.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numbers>
+
+using namespace std;
+
+namespace {
+
+constexpr size_t PATH_BLOCK = 32;         // Paths per block (unit of work and of accumulation)
+constexpr size_t MONTH_GRAIN = 8;         // Months per task when computing percentiles
+constexpr uint32_t STREAM_LOAN = 0;       // Counter word 3: loan-month default/prepay draws
+constexpr uint32_t STREAM_PATH = 1;       // Counter word 3: per-path economic factor
+
+// Philox known-answer tests (Random123 kat_vectors)
+static_assert(counter_rng::philox4x32({ 0, 0, 0, 0 }, 0)
+              == counter_rng::Counter{ 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u });
+static_assert(counter_rng::philox4x32({ 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu }, ~uint64_t{ 0 })
+              == counter_rng::Counter{ 0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu });
+static_assert(counter_rng::philox4x32({ 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u }, 0x299f31d0a4093822ull)
+              == counter_rng::Counter{ 0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u });
+
+/*
+    Struct: LoanTerms
+
+    Programmer's Note:
+        - What the month loop needs per loan, priced once before the simulation.
+
+    Simpler Terms:
+        Each loan's amount, rate, payment and length.
+ */
+struct LoanTerms {
+    double loan_amount;
+    double monthly_rate;
+    double monthly_payment;
+    int number_of_payments;
+};
+
+/*
+    Struct: BlockAccumulator
+
+    Programmer's Note:
+        - Monthly sums over one block of paths; merged in block order by the caller.
+
+    Simpler Terms:
+        Running monthly totals for a small group of simulated futures.
+ */
+struct BlockAccumulator {
+    vector<double> cash_flow;
+    vector<double> interest;
+    vector<double> prepayment;
+    vector<double> loss;
+};
+
+// Annual rate (percent) -> monthly probability
+double monthlyProbability(double annualPercent) {
+    return 1.0 - pow(1.0 - annualPercent / 100.0, 1.0 / 12.0);
+}
+
+/*
+    Path Factor
+
+    Programmer's Note:
+        - exp(sigma * z - sigma^2 / 2) with z from Box-Muller on the path's own counter,
+          so the factor has mean 1 and depends only on (seed, path).
+
+    Simpler Terms:
+        How much faster or slower than usual borrowers behave in this simulated future.
+ */
+double pathFactor(uint64_t seed, uint32_t path, double sigma) {
+    if (sigma == 0.0) {
+        return 1.0;
+    }
+    const counter_rng::Counter words = counter_rng::philox4x32({ 0, 0, path, STREAM_PATH }, seed);
+    const double u1 = counter_rng::toUniform(words[0], words[1]);
+    const double u2 = counter_rng::toUniform(words[2], words[3]);
+    const double z = sqrt(-2.0 * log1p(-u1)) * cos(2.0 * numbers::pi * u2);
+    return exp(sigma * z - 0.5 * sigma * sigma);
+}
+
+/*
+    Simulate Path
+
+    Programmer's Note:
+        - Runs every loan for one path, adding the path's monthly portfolio cash flow to
+          'cashRow' and its monthly components to the block accumulator.
+        - Each month: default check first (recovery instead of a payment), then the
+          scheduled payment as in Mortgage::outputPaymentSchedule, then a full prepayment
+          check on what is left.
+
+    Simpler Terms:
+        Plays out one possible future for every loan in the portfolio.
+ */
+void simulatePath(span<const LoanTerms> loans, const MonteCarloConfig& config, uint32_t path,
+                  double baseDefault, double basePrepay, span<double> cashRow, BlockAccumulator& block,
+                  double& lifetimeCash, double& lifetimeLoss) {
+    const double factor = pathFactor(config.seed, path, config.speed_volatility);
+    const double defaultProbability = min(1.0, baseDefault * factor);
+    const double prepayProbability = min(1.0, basePrepay * factor);
+    const double severity = config.loss_severity_percent / 100.0;
+
+    for (size_t i = 0; i < loans.size(); ++i) {
+        const LoanTerms& loan = loans[i];
+        double balance = loan.loan_amount;
+
+        for (int month = 0; month < loan.number_of_payments && balance > 0.0; ++month) {
+            const counter_rng::Counter words = counter_rng::philox4x32(
+                { static_cast<uint32_t>(month), static_cast<uint32_t>(i), path, STREAM_LOAN }, config.seed);
+            const size_t m = static_cast<size_t>(month);
+
+            if (counter_rng::toUniform(words[0], words[1]) < defaultProbability) {
+                const double recovery = balance * (1.0 - severity);
+                cashRow[m] += recovery;
+                block.cash_flow[m] += recovery;
+                block.loss[m] += balance - recovery;
+                lifetimeCash += recovery;
+                lifetimeLoss += balance - recovery;
+                break;
+            }
+
+            const double interest = loan.monthly_rate * balance;
+            const double principal = min(loan.monthly_payment - interest, balance);
+            balance -= principal;
+            double cash = interest + principal;
+            block.interest[m] += interest;
+
+            if (balance > 0.0 && counter_rng::toUniform(words[2], words[3]) < prepayProbability) {
+                cash += balance;
+                block.prepayment[m] += balance;
+                balance = 0.0;
+            }
+
+            cashRow[m] += cash;
+            block.cash_flow[m] += cash;
+            lifetimeCash += cash;
+        }
+    }
+}
+
+/*
+    Percentile
+
+    Programmer's Note:
+        - Linear interpolation between the closest ranks of the sorted values.
+
+    Simpler Terms:
+        The value below which the given percentage of results fall.
+ */
+double percentileOfSorted(const vector<double>& sorted, double level) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const double position = level / 100.0 * static_cast<double>(sorted.size() - 1);
+    const size_t lower = static_cast<size_t>(position);
+    const size_t upper = min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (position - static_cast<double>(lower)) * (sorted[upper] - sorted[lower]);
+}
+
+vector<double> percentilesOf(vector<double> values, span<const double> levels) {
+    sort(values.begin(), values.end());
+    vector<double> result;
+    for (double level : levels) {
+        result.push_back(percentileOfSorted(values, level));
+    }
+    return result;
+}
+
+/*
+    Validate Config
+
+    Programmer's Note:
+        - Rates and severity are percentages in [0, 100]; percentile levels likewise.
+
+    Simpler Terms:
+        Makes sure the simulation assumptions make sense.
+ */
+bool validateConfig(const MonteCarloConfig& config) {
+    const auto isPercent = [](double value) { return value >= 0.0 && value <= 100.0; };
+    if (config.paths == 0 || !isPercent(config.cpr_percent) || !isPercent(config.cdr_percent)
+        || !isPercent(config.loss_severity_percent) || !(config.speed_volatility >= 0.0)
+        || !all_of(config.percentiles.begin(), config.percentiles.end(), isPercent)) {
+        cerr << "ERROR: Invalid Monte Carlo assumptions (paths > 0, rates and percentiles in [0, 100])." << endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+/*
+    Simulate Portfolio
+
+    Programmer's Note:
+        - Phase 1 (parallel by block): every path of the block, written to its own row of
+          the cash-flow matrix and its own block accumulator.
+        - Phase 2 (serial): block accumulators merged in block order into the expectations.
+        - Phase 3 (parallel by month): per-month percentiles across paths.
+
+    Simpler Terms:
+        Runs all the simulated futures and collects averages and ranges.
+ */
+bool simulatePortfolio(span<const LoanRecord> loans, const MonteCarloConfig& config,
+                       WorkStealingPool& pool, MonteCarloResult& result) {
+    if (!validateConfig(config)) {
+        return false;
+    }
+
+    vector<LoanQuote> quotes(loans.size());
+    priceLoans(loans, quotes);
+
+    vector<LoanTerms> terms(loans.size());
+    size_t months = 0;
+    for (size_t i = 0; i < loans.size(); ++i) {
+        const int payments = max(0, loans[i].total_years_to_repay * 12);
+        terms[i] = { loans[i].loan_amount, loans[i].annual_interest_rate / 100.0 / 12.0,
+                     quotes[i].monthly_payment, payments };
+        months = max(months, static_cast<size_t>(payments));
+    }
+
+    const size_t paths = config.paths;
+    const size_t blocks = (paths + PATH_BLOCK - 1) / PATH_BLOCK;
+    const double baseDefault = monthlyProbability(config.cdr_percent);
+    const double basePrepay = monthlyProbability(config.cpr_percent);
+
+    result = MonteCarloResult{};
+    result.paths = paths;
+    result.months = months;
+    result.percentile_levels = config.percentiles;
+    result.lifetime_cash_flow.assign(paths, 0.0);
+    result.lifetime_loss.assign(paths, 0.0);
+
+    vector<double> cashMatrix(paths * months, 0.0);
+    vector<BlockAccumulator> accumulators(blocks, BlockAccumulator{ vector<double>(months), vector<double>(months),
+                                                                    vector<double>(months), vector<double>(months) });
+
+    pool.parallelFor(blocks, 1, [&](size_t firstBlock, size_t lastBlock) {
+        for (size_t b = firstBlock; b < lastBlock; ++b) {
+            for (size_t p = b * PATH_BLOCK; p < min(paths, (b + 1) * PATH_BLOCK); ++p) {
+                simulatePath(terms, config, static_cast<uint32_t>(p), baseDefault, basePrepay,
+                             span<double>(cashMatrix.data() + p * months, months), accumulators[b],
+                             result.lifetime_cash_flow[p], result.lifetime_loss[p]);
+            }
+        }
+    });
+
+    result.expected_cash_flow.assign(months, 0.0);
+    result.expected_interest.assign(months, 0.0);
+    result.expected_prepayment.assign(months, 0.0);
+    result.expected_loss.assign(months, 0.0);
+    for (const BlockAccumulator& block : accumulators) {
+        for (size_t m = 0; m < months; ++m) {
+            result.expected_cash_flow[m] += block.cash_flow[m];
+            result.expected_interest[m] += block.interest[m];
+            result.expected_prepayment[m] += block.prepayment[m];
+            result.expected_loss[m] += block.loss[m];
+        }
+    }
+    for (size_t m = 0; m < months; ++m) {
+        result.expected_cash_flow[m] /= static_cast<double>(paths);
+        result.expected_interest[m] /= static_cast<double>(paths);
+        result.expected_prepayment[m] /= static_cast<double>(paths);
+        result.expected_loss[m] /= static_cast<double>(paths);
+    }
+
+    const size_t levels = config.percentiles.size();
+    result.cash_flow_percentiles.assign(months * levels, 0.0);
+    pool.parallelFor(months, MONTH_GRAIN, [&](size_t firstMonth, size_t lastMonth) {
+        vector<double> column(paths);
+        for (size_t m = firstMonth; m < lastMonth; ++m) {
+            for (size_t p = 0; p < paths; ++p) {
+                column[p] = cashMatrix[p * months + m];
+            }
+            const vector<double> values = percentilesOf(column, config.percentiles);
+            copy(values.begin(), values.end(), result.cash_flow_percentiles.begin() + static_cast<ptrdiff_t>(m * levels));
+        }
+    });
+
+    result.lifetime_cash_flow_percentiles = percentilesOf(result.lifetime_cash_flow, config.percentiles);
+    result.lifetime_loss_percentiles = percentilesOf(result.lifetime_loss, config.percentiles);
+    return true;
+}
@@ -0,0 +1,94 @@
+// Monte Carlo Cash-Flow Simulator Specification
+
+#ifndef MONTE_CARLO_H
+#define MONTE_CARLO_H
+
+#include "BatchPricer.h"
+#include "WorkStealingPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+    Struct: MonteCarloConfig
+
+    Programmer's Note:
+        - Each simulated path runs every loan month by month. In each month a loan can
+          default (probability MDR, from cdr_percent) or, after its scheduled payment,
+          prepay in full (probability SMM, from cpr_percent).
+        - speed_volatility adds a per-path economic factor: both hazards are multiplied by
+          exp(sigma * z - sigma^2 / 2), z standard normal, so paths differ systematically
+          as well as loan by loan (0 = independent loans only).
+        - A default returns (1 - loss_severity_percent / 100) of the balance that month;
+          the rest is a loss.
+        - Random numbers come from Philox keyed by 'seed' with counter
+          (month, loan, path, stream), so every draw is fixed by its indices alone.
+        - percentiles: levels in [0, 100] reported for every month and for lifetime totals.
+
+    Simpler Terms:
+        The assumptions for the simulation: how often borrowers pay off early or stop
+        paying, how much is lost when they stop, and how many futures to try.
+ */
+struct MonteCarloConfig {
+    std::uint64_t seed = 20240101;
+    std::size_t paths = 1000;
+    double cpr_percent = 8.0;
+    double cdr_percent = 1.0;
+    double loss_severity_percent = 35.0;
+    double speed_volatility = 0.3;
+    std::vector<double> percentiles = { 5.0, 50.0, 95.0 };
+};
+
+/*
+    Struct: MonteCarloResult
+
+    Programmer's Note:
+        - Months are indexed month - 1 and cover the longest loan.
+        - expected_*: mean over paths of the portfolio total in each month.
+        - cash_flow_percentiles: months x levels, row-major (month m, level j at
+          m * levels + j), of the portfolio cash flow in that month across paths.
+        - lifetime_*: per path lifetime totals and their percentiles (one per level).
+        - Cash flow = interest + scheduled principal + prepayments + default recoveries.
+
+    Simpler Terms:
+        The average money coming in each month, and how good or bad it can get.
+ */
+struct MonteCarloResult {
+    std::size_t paths = 0;
+    std::size_t months = 0;
+    std::vector<double> percentile_levels;
+
+    std::vector<double> expected_cash_flow;
+    std::vector<double> expected_interest;
+    std::vector<double> expected_prepayment;
+    std::vector<double> expected_loss;
+
+    std::vector<double> cash_flow_percentiles;
+    std::vector<double> lifetime_cash_flow;             // One per path
+    std::vector<double> lifetime_loss;                  // One per path
+    std::vector<double> lifetime_cash_flow_percentiles;
+    std::vector<double> lifetime_loss_percentiles;
+};
+
+/*
+    Simulate Portfolio
+
+    Programmer's Note:
+        - Paths are split into fixed blocks of 32 and handed to the work-stealing pool.
+          Each block sums its months into its own accumulator, and the block accumulators
+          are merged in block order at the end. (Accumulators per thread would be merged
+          in an order that depends on scheduling, which changes the last bits.) Because
+          the blocks, the random numbers and the merge order do not depend on which thread
+          ran what, the result is bit-identical for any thread count.
+        - Keeps one paths x months matrix of portfolio cash flows for the percentiles.
+        - Returns false (after printing an ERROR line) for invalid assumptions.
+
+    Simpler Terms:
+        Runs thousands of possible futures for a portfolio of loans on all CPU cores and
+        summarizes the cash that comes in.
+ */
+bool simulatePortfolio(std::span<const LoanRecord> loans, const MonteCarloConfig& config,
+                       WorkStealingPool& pool, MonteCarloResult& result);
+
+#endif // MONTE_CARLO_H
@@ -1,292 +1,249 @@
 // Mortgage Class Implementation
 
 #include "Mortgage.h"
+#include "PerfCounters.h"
+#include "ScheduleSink.h"
 #include <iostream>
 #include <iomanip>
 #include <cmath>
 #include <fstream>
-#include <vector>
+#include <algorithm>
+#include <memory>
 
 using namespace std;
 
 /*
-    Constructor
+    Lifecycle Logging
 
     Programmer's Note:
-        - Initializes member variables to default values by assignment.
-        - Logs the creation of the Mortgage object for traceability.
+        - Out-of-line so the constexpr constructor and destructor in Mortgage.h
+          can call them only at run time, keeping <iostream> out of the header.
 
     Simpler Terms:
-        When a Mortgage object is created, this sets all loan details to zero
-        and shows a message that the mortgage calculation is starting.
+        The INFO messages printed when a loan object is created or cleaned up.
  */
-Mortgage::Mortgage() {
-    // Initialize all loan-related member variables to default values
-    loan_amount = 0.0;               // Initial loan amount set to 0
-    annual_interest_rate = 0.0;      // Annual interest rate set to 0%
-    monthly_interest_rate = 0.0;     // Monthly interest rate set to 0%
-    total_years_to_repay = 0;        // Total repayment duration in years set to 0
-    number_of_payments = 0;          // Total number of payments set to 0
-
+void Mortgage::logConstruction() const {
     // Output a message indicating the constructor execution for tracing/debugging
     cout << "\nINFO: executing constructor for Mortgage class." << endl;
 }
 
+void Mortgage::logDestruction() const {
+    // Display a message indicating the destructor is running, showing the current loan amount
+    cout << "INFO: Executing DESTRUCTOR for Mortgage class (loan amount = "
+         << fixed << setprecision(2) // Format loan amount to two decimal places
+         << loan_amount << ")." << endl; // Output loan amount and close message
+}
 
 /*
-    Destructor
+    Output Payment Schedule (Extra Credit)
 
     Programmer's Note:
-        - Handles the cleanup when the Mortgage object is destroyed.
-        - Outputs the loan amount for context during destruction.
+        - Writes a formatted, column-aligned amortization schedule to a specified text file.
+        - Includes payment number, monthly payment, interest, principal, and remaining balance.
+        - Prevents the remaining balance from dropping below zero due to rounding.
 
     Simpler Terms:
-        When the Mortgage object is finished, this shows a message
-        that includes the loan amount to confirm cleanup.
+        Saves a monthly payment plan to a file that shows:
+        - How much of each payment goes toward interest.
+        - How much reduces the original loan.
+        - How much is still left to pay after each month.
  */
-Mortgage::~Mortgage() {
-    // Display a message indicating the destructor is running, showing the current loan amount
-    cout << "INFO: Executing DESTRUCTOR for Mortgage class (loan amount = "
-         << fixed << setprecision(2) // Format loan amount to two decimal places
-         << loan_amount << ")." << endl; // Output loan amount and close message
+void Mortgage::outputPaymentSchedule(const string& filename) const {
+    // Creates and opens the output file stream with the specified filename
+    ofstream outFile(filename);
+
+    // Checks if the file failed to open
+    if (!outFile) {
+        // Display an error message to standard error output
+        cerr << "ERROR: Could not open file " << filename << " for writing." << endl;
+        // Exit the function early since writing to the file is not possible
+        return;
+    }
+
+    // Write the schedule, then close the output file
+    outputPaymentSchedule(outFile);
+    outFile.close();
 }
 
 /*
-    Set Loan Amount
+    Output Payment Schedule to a Stream
 
     Programmer's Note:
-        - Stores the principal loan amount.
+        - The text schedule sink (ScheduleSink.h) fed by writePaymentSchedule: ScheduleWriter
+          formats numbers with to_chars into a reusable buffer and writes it in large blocks,
+          so there is no per-row allocation or flush.
+        - Produces exactly the same text as earlier versions of outputPaymentSchedule.
 
     Simpler Terms:
-        Saves how much money you want to borrow.
+        Writes the monthly payment plan to any output, such as a file or a string.
  */
-void Mortgage::setLoanAmount(double amount) {
-    loan_amount = amount; // Store the provided loan amount into the member variable
+void Mortgage::outputPaymentSchedule(ostream& out) const {
+    perf_counters::ScopedTimer timer(perf_counters::Phase::ScheduleWrite);
+    perf_counters::add(perf_counters::Counter::RowsGenerated, static_cast<uint64_t>(max(0, number_of_payments)));
+    const unique_ptr<ScheduleSink> sink = makeScheduleSink(ScheduleFormat::Text, out);
+    writePaymentSchedule(*sink);
+
+    // Hand the last block of text to the stream
+    sink->finish();
 }
 
 /*
-    Set Annual Interest Rate
+    Write Payment Schedule to a Sink
 
     Programmer's Note:
-        - Stores the annual interest rate.
-        - Calculates the equivalent monthly interest rate.
+        - Computes the schedule in a single pass into a small stack block and hands the
+          sink each block as it fills, so rows are formatted while they are still in cache.
+        - The rate is reported as a percentage (annual_interest_rate * 100), as the text
+          summary has always printed it.
+        - Records no performance counters: callers run it once per loan, and count rows
+          and time for the whole call themselves (outputPaymentSchedule does).
 
     Simpler Terms:
-        Sets the yearly interest rate and figures out the monthly rate.
+        Sends the monthly payment plan to any kind of output.
  */
-void Mortgage::setAnnualInterestRate(double rate) {
-    annual_interest_rate = rate / 100.0;     // Convert percentage to decimal (e.g., 5% -> 0.05)
-    monthly_interest_rate = annual_interest_rate / 12.0;  // Calculate monthly rate
+void Mortgage::writePaymentSchedule(ScheduleSink& sink, size_t loanIndex) const {
+    constexpr size_t BLOCK_ROWS = 256;     // Rows computed before each hand-off
+
+    // Retrieve the calculated monthly payment amount
+    const double monthly_payment = getMonthlyPayment();
+    sink.beginLoan({ loanIndex, loan_amount, annual_interest_rate * 100, total_years_to_repay,
+                     number_of_payments, monthly_payment, getTotalPayback() });
+
+    // Collect rows as the schedule range produces them (same range as schedule(), reusing the payment)
+    PaymentRow block[BLOCK_ROWS];
+    size_t used = 0;
+    for (const PaymentRow& row : ScheduleRange(loan_amount, monthly_interest_rate, monthly_payment, number_of_payments)) {
+        block[used++] = row;
+        if (used == BLOCK_ROWS) {
+            sink.writeRows(span<const PaymentRow>(block, used));
+            used = 0;
+        }
+    }
+    if (used > 0) {
+        sink.writeRows(span<const PaymentRow>(block, used));
+    }
+    sink.endLoan();
 }
 
 /*
-    Set Total Years to Repay
+    Balance After (Closed Form)
 
     Programmer's Note:
-        - Stores the repayment term in years.
-        - Calculates the total number of monthly payments.
+        - B(k) = P * F - M * (F - 1) / r  with  F - 1 = expm1(k * log(1 + r)).
+        - With r == 0 there is no growth and the balance falls by M each month.
+        - Clamps k to the loan term and the result to zero, like the schedule loop.
 
     Simpler Terms:
-        Saves how many years you’ll take to pay off the loan,
-        and figures out how many monthly payments that means.
+        Works out what is still owed after k payments with one formula.
  */
-void Mortgage::setTotalYearsToRepay(int years) {
-    total_years_to_repay = years;             // Store the repayment period in years
-    number_of_payments = total_years_to_repay * 12;  // Calculate total monthly payments
+double Mortgage::balanceAfter(int k, double log_growth, double monthly_payment) const {
+    k = max(0, min(k, number_of_payments));
+
+    double balance;
+    if (monthly_interest_rate == 0) {
+        balance = loan_amount - monthly_payment * k;
+    } else {
+        const double growth_minus_one = expm1(k * log_growth);   // (1 + r)^k - 1
+        balance = loan_amount * (growth_minus_one + 1) - monthly_payment * growth_minus_one / monthly_interest_rate;
+    }
+
+    return balance < 0.0 ? 0.0 : balance;  // Prevent negative balance due to rounding errors
+}
+
+double Mortgage::balanceAfter(int k) const {
+    return balanceAfter(k, log1p(monthly_interest_rate), getMonthlyPayment());
 }
 
 /*
-    Get Monthly Payment
+    Cumulative Principal and Interest
 
     Programmer's Note:
-        - Computes the monthly mortgage payment using the standard amortization formula.
-        - Returns zero if interest rate or number of payments is invalid.
+        - Principal repaid in payments first..last is B(first - 1) - B(last).
+        - Interest is whatever the level payments did not put toward principal.
+        - An empty or reversed range gives zero.
 
     Simpler Terms:
-        Calculates how much you have to pay every month on your loan.
+        Adds up how much principal or interest was paid between two payment numbers.
  */
-double Mortgage::getMonthlyPayment() const {
-    // Safeguard: Return 0 if either the interest rate or number of payments is zero (invalid scenario)
-    if (monthly_interest_rate == 0 || number_of_payments == 0) {
+double Mortgage::cumulativePrincipal(int first, int last) const {
+    first = max(first, 1);
+    last = min(last, number_of_payments);
+    if (first > last) {
         return 0.0;
     }
 
-    // Compute (1 + monthly_interest_rate) raised to the number_of_payments
-    double power_factor = pow(1 + monthly_interest_rate, number_of_payments);
+    const double log_growth = log1p(monthly_interest_rate);
+    const double monthly_payment = getMonthlyPayment();
+    return balanceAfter(first - 1, log_growth, monthly_payment) - balanceAfter(last, log_growth, monthly_payment);
+}
 
-    // Apply the amortization formula for fixed-rate mortgages
-    double monthly_payment = (loan_amount * monthly_interest_rate * power_factor) / (power_factor - 1);
+double Mortgage::cumulativeInterest(int first, int last) const {
+    first = max(first, 1);
+    last = min(last, number_of_payments);
+    if (first > last) {
+        return 0.0;
+    }
 
-    return monthly_payment;  // Return the computed monthly payment
+    return getMonthlyPayment() * (last - first + 1) - cumulativePrincipal(first, last);
 }
 
 /*
-    Get Total Payback
+    Payment Breakdown
 
     Programmer's Note:
-        - Calculates the total amount paid back over the life of the loan.
+        - Row k as the schedule loop would produce it: interest on the previous balance,
+          the rest of the payment as principal, and the new balance.
+        - k is clamped to the first and last payment, payment_number included.
 
     Simpler Terms:
-        Calculates the total amount of money you’ll pay by the time the loan is fully paid off.
+        Shows how payment k splits into interest and principal.
  */
-double Mortgage::getTotalPayback() const {
-    return getMonthlyPayment() * number_of_payments;  // Total payback = monthly payment * total number of payments
+PaymentRow Mortgage::paymentBreakdown(int k) const {
+    k = max(1, min(k, number_of_payments));
+    const double log_growth = log1p(monthly_interest_rate);
+    const double monthly_payment = getMonthlyPayment();
+
+    const double interest = monthly_interest_rate * balanceAfter(k - 1, log_growth, monthly_payment);
+    return { k, monthly_payment, interest, monthly_payment - interest, balanceAfter(k, log_growth, monthly_payment) };
 }
 
 /*
-    Output Payment Schedule (Extra Credit)
+    Batched Schedule Queries
 
     Programmer's Note:
-        - Writes a formatted, column-aligned amortization schedule to a specified text file.
-        - Includes payment number, monthly payment, interest, principal, and remaining balance.
-        - Prevents the remaining balance from dropping below zero due to rounding.
+        - Same formulas as the single-month queries, with log1p(r) and the monthly
+          payment computed once for the whole list.
 
     Simpler Terms:
-        Saves a monthly payment plan to a file that shows:
-        - How much of each payment goes toward interest.
-        - How much reduces the original loan.
-        - How much is still left to pay after each month.
+        Answers the same questions for a whole list of months at once.
  */
-void Mortgage::outputPaymentSchedule(const string& filename) const {
-    // Creates and opens the output file stream with the specified filename
-    ofstream outFile(filename);
-
-    // Checks if the file failed to open
-    if (!outFile) {
-        // Display an error message to standard error output
-        cerr << "ERROR: Could not open file " << filename << " for writing." << endl;
-        // Exit the function early since writing to the file is not possible
-        return;
-    }
-
-    // Define the banner message to label the payment schedule section
-    const string bannerMessage = " Mortgage Payment Schedule ";
-
-    // Define the total width of the banner for visual formatting
-    constexpr int bannerWidth = 60;  // Adjust width as needed
-
-    // Output the top border of the banner using '=' characters
-    outFile << setfill('=') << setw(bannerWidth) << "=" << setfill(' ') << "\n"
-
-    // Center the banner message within the defined banner width
-            << setw(static_cast<int>((bannerWidth + bannerMessage.length()) / 2))
-            << bannerMessage << endl;
-
-    // Output the bottom border of the banner using '=' characters
-    outFile << setfill('=') << setw(bannerWidth) << "=" << endl << endl;
-
-    // Reset fill character back to space for normal output formatting
-    outFile << setfill(' ');
-
-    // Initialize the loan balance with the original loan amount
-    double balance = loan_amount;
-
-    // Retrieve the calculated monthly payment amount
+void Mortgage::balancesAfter(span<const int> months, span<double> out) const {
+    const double log_growth = log1p(monthly_interest_rate);
     const double monthly_payment = getMonthlyPayment();
 
-    // Format all subsequent numeric output with fixed-point notation, always show the decimal point,
-    // and limit to two decimal places for currency representation
-    outFile << fixed << showpoint << setprecision(2);
-
-    // Output the loan details summary, formatted for readability
-    outFile << "Loan Amount:"
-            << setw(15) << "$" << loan_amount << "\n"
-
-            << "Annual Interest Rate:"
-            << right << setw(9) << (annual_interest_rate * 100) << "%" << "\n"
-
-            << "Years to repay:"
-            << setw(13) << total_years_to_repay << "\n"
-
-            << "Monthly Payment:"
-            << setw(11) << "$" << monthly_payment << "\n"
-
-            << "Total Pay Back:"
-            << setw(12) << "$" << getTotalPayback() << endl << endl;
-
-    // Defines the number of spaces to insert between columns for alignment
-    constexpr int padding = 4;  // Space between columns
-
-    // Define the header labels for the payment schedule table
-    const vector<string> headers = { "Pmt#", "Payment Amount", "Interest", "Principal", "Remaining Balance" };
-
-    // Initialize a vector to store the width of each column, starting with the length of each header
-    vector<int> columnWidths(headers.size());
-    for (unsigned int i = 0; i < headers.size(); ++i) {
-        columnWidths[i] = static_cast<int>(headers[i].length());
-    }
-
-    // Iterate through each payment number to determine the maximum width required for each column
-    for (int pmt_number = 1; pmt_number <= number_of_payments; ++pmt_number) {
-        double interest = monthly_interest_rate * balance;
-        double principal = monthly_payment - interest;
-        balance -= principal;
-        if (balance < 0.0) balance = 0.0;  // Prevent balance from going negative due to rounding
-
-        // Update column width if the length of the current payment number is greater than the existing width
-        if (static_cast<int>(to_string(pmt_number).length()) > columnWidths[0]) {
-            columnWidths[0] = static_cast<int>(to_string(pmt_number).length());
-        }
-
-        // Update column width if the length of the monthly payment value is greater than the existing width
-        if (static_cast<int>(to_string(monthly_payment).length()) > columnWidths[1]) {
-            columnWidths[1] = static_cast<int>(to_string(monthly_payment).length());
-        }
-
-        // Update column width if the length of the interest value is greater than the existing width
-        if (static_cast<int>(to_string(interest).length()) > columnWidths[2]) {
-            columnWidths[2] = static_cast<int>(to_string(interest).length());
-        }
-
-        // Update column width if the length of the principal value is greater than the existing width
-        if (static_cast<int>(to_string(principal).length()) > columnWidths[3]) {
-            columnWidths[3] = static_cast<int>(to_string(principal).length());
-        }
-
-        // Update column width if the length of the remaining balance is greater than the existing width
-        if (static_cast<int>(to_string(balance).length()) > columnWidths[4]) {
-            columnWidths[4] = static_cast<int>(to_string(balance).length());
-        }
+    for (size_t i = 0; i < months.size(); ++i) {
+        out[i] = balanceAfter(months[i], log_growth, monthly_payment);
     }
+}
 
-    // Set text alignment to left for printing the table headers
-    outFile << left;
+void Mortgage::cumulativeInterests(span<const int> months, span<double> out) const {
+    const double log_growth = log1p(monthly_interest_rate);
+    const double monthly_payment = getMonthlyPayment();
 
-    // Output each header label with spacing defined by the header's length plus padding
-    for (const auto& header : headers) {
-        outFile << setw(static_cast<int>(header.length()) + padding) << header;
+    for (size_t i = 0; i < months.size(); ++i) {
+        const int k = max(0, min(months[i], number_of_payments));
+        const double principal_repaid = loan_amount - balanceAfter(k, log_growth, monthly_payment);
+        out[i] = monthly_payment * k - principal_repaid;
     }
+}
 
-    // Move to the next line after printing all headers
-    outFile << endl;
-
-
-    // Reset the balance to the original loan amount before generating the payment schedule output
-    balance = loan_amount;
-
-    // Iterate over each payment number to calculate and display the amortization details
-    for (int pmt_number = 1; pmt_number <= number_of_payments; ++pmt_number) {
-        // Calculate the interest portion of the current payment
-        double interest = monthly_interest_rate * balance;
-
-        // Calculate the principal portion by subtracting interest from the monthly payment
-        double principal = monthly_payment - interest;
-
-        // Update the remaining balance after applying the principal
-        balance -= principal;
-        if (balance < 0.0) balance = 0.0;  // Prevent negative balance due to rounding errors
+void Mortgage::paymentBreakdowns(span<const int> months, span<PaymentRow> out) const {
+    const double log_growth = log1p(monthly_interest_rate);
+    const double monthly_payment = getMonthlyPayment();
 
-        // Output each column value aligned to the right, with spacing based on the header length
-        outFile << right
-            << setw(static_cast<int>(headers[0].length())) << pmt_number << string(padding, ' ')
-            << setw(static_cast<int>(headers[1].length())) << monthly_payment << string(padding, ' ')
-            << setw(static_cast<int>(headers[2].length())) << interest << string(padding, ' ')
-            << setw(static_cast<int>(headers[3].length())) << principal << string(padding, ' ')
-            << setw(static_cast<int>(headers[4].length())) << balance
-            << endl;
+    for (size_t i = 0; i < months.size(); ++i) {
+        const int k = max(1, min(months[i], number_of_payments));
+        const double interest = monthly_interest_rate * balanceAfter(k - 1, log_growth, monthly_payment);
+        out[i] = { k, monthly_payment, interest, monthly_payment - interest, balanceAfter(k, log_growth, monthly_payment) };
     }
-
-    // Close the output file after writing the complete payment schedule
-    outFile.close();
-
 }
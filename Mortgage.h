@@ -3,9 +3,129 @@
 #ifndef MORTGAGE_H
 #define MORTGAGE_H
 
+#include "AnnuityMath.h"
+#include <cmath>
+#include <cstddef>
+#include <iosfwd>
+#include <iterator>
+#include <ranges>
+#include <span>
 #include <string>
+#include <type_traits>
 // using namespace std;
 
+class ScheduleSink;     // ScheduleSink.h
+
+/*
+    Struct: PaymentRow
+
+    Programmer's Note:
+        - One row of the amortization schedule, exactly as outputPaymentSchedule prints it.
+        - Produced in memory by Mortgage::fillPaymentSchedule for callers that
+          need the numbers rather than the text file.
+
+    Simpler Terms:
+        One month of the payment plan: how much was paid,
+        how much went to interest and to the loan, and what is still owed.
+ */
+struct PaymentRow {
+    int payment_number;         // 1-based payment number
+    double payment_amount;      // Level monthly payment
+    double interest;            // Interest portion of this payment
+    double principal;           // Principal portion of this payment
+    double remaining_balance;   // Balance after this payment (never below zero)
+};
+
+/*
+    Class: ScheduleRange
+
+    Programmer's Note:
+        - Lazy view of an amortization schedule: each row is computed when the iterator
+          advances, from the previous row's balance, using the loop outputPaymentSchedule
+          always used. Nothing is stored, so memory use is constant for any loan length.
+        - A std::ranges::view (forward, sized), so it composes with std::views:
+              for (const PaymentRow& row : loan.schedule() | std::views::drop(12)) ...
+        - Rows are returned by value; the iterator only holds the current row and the
+          loan's rate and payment, so copying it is cheap and it can be restarted.
+          Project with a lambda that returns by value: views::transform(&PaymentRow::interest)
+          would return a reference into a temporary row.
+        - constexpr, like the rest of the loan math.
+
+    Simpler Terms:
+        The payment plan, one month at a time, worked out only when it is asked for.
+ */
+class ScheduleRange : public std::ranges::view_interface<ScheduleRange> {
+public:
+    class iterator {
+    public:
+        using value_type = PaymentRow;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+
+        constexpr iterator() = default;
+
+        constexpr PaymentRow operator*() const { return row; }
+
+        constexpr iterator& operator++() {
+            advance();
+            return *this;
+        }
+
+        constexpr iterator operator++(int) {
+            iterator previous = *this;
+            advance();
+            return previous;
+        }
+
+        friend constexpr bool operator==(const iterator& a, const iterator& b) {
+            return a.row.payment_number == b.row.payment_number;
+        }
+
+        friend constexpr bool operator==(const iterator& it, std::default_sentinel_t) {
+            return it.row.payment_number > it.last_payment;
+        }
+
+    private:
+        friend class ScheduleRange;
+
+        constexpr iterator(double loanAmount, double monthlyRate, double monthlyPayment, int lastPayment)
+            : monthly_rate(monthlyRate), monthly_payment(monthlyPayment), last_payment(lastPayment),
+              row{ 0, monthlyPayment, 0.0, 0.0, loanAmount } {
+            advance();
+        }
+
+        // Next row from the current balance, exactly as outputPaymentSchedule computes it
+        constexpr void advance() {
+            const double interest = monthly_rate * row.remaining_balance;   // Interest portion of this payment
+            const double principal = monthly_payment - interest;            // Principal portion of this payment
+            double balance = row.remaining_balance - principal;             // Apply the principal
+            if (balance < 0.0) balance = 0.0;                               // Prevent negative balance due to rounding errors
+            row = { row.payment_number + 1, monthly_payment, interest, principal, balance };
+        }
+
+        double monthly_rate = 0.0;
+        double monthly_payment = 0.0;
+        int last_payment = 0;
+        PaymentRow row{};           // Current row; its balance seeds the next one
+    };
+
+    constexpr ScheduleRange() = default;
+    constexpr ScheduleRange(double loanAmount, double monthlyRate, double monthlyPayment, int numberOfPayments)
+        : loan_amount(loanAmount), monthly_rate(monthlyRate), monthly_payment(monthlyPayment),
+          number_of_payments(numberOfPayments < 0 ? 0 : numberOfPayments) {
+    }
+
+    constexpr iterator begin() const { return { loan_amount, monthly_rate, monthly_payment, number_of_payments }; }
+    constexpr std::default_sentinel_t end() const { return {}; }
+    constexpr std::size_t size() const { return static_cast<std::size_t>(number_of_payments); }
+
+private:
+    double loan_amount = 0.0;
+    double monthly_rate = 0.0;
+    double monthly_payment = 0.0;
+    int number_of_payments = 0;
+};
+
 /*
     Class: Mortgage
 
@@ -40,6 +160,15 @@ private:
         total_years_to_repay,    // Repayment period in years
         number_of_payments;      // Total payments (years * 12)
 
+    bool log_lifecycle;          // Print INFO lines on construction/destruction
+
+    // INFO messages (defined in Mortgage.cpp, only called at run time)
+    void logConstruction() const;
+    void logDestruction() const;
+
+    // Closed-form balance after k payments, given log(1 + r) and the level payment
+    [[nodiscard]] double balanceAfter(int k, double log_growth, double monthly_payment) const;
+
 public:
     /*
         Constructor & Destructor
@@ -47,13 +176,17 @@ public:
         Programmer's Note:
             - Handles the lifecycle of the Mortgage object.
             - Logs creation and destruction for traceability.
+            - Batch pricing constructs Mortgage objects with logging turned off,
+              so millions of loans do not flood standard output.
 
         Simpler Terms:
             When you start a loan, the constructor sets it up.
             When you're done, the destructor show's a message that the loan object is cleaned up.
+            Passing false to the second constructor keeps the loan quiet.
      */
-    Mortgage();     // Constructor
-    ~Mortgage();    // Destructor
+    constexpr Mortgage();                             // Constructor (logs creation and destruction)
+    constexpr explicit Mortgage(bool logLifecycle);   // Constructor with optional lifecycle logging
+    constexpr ~Mortgage();                            // Destructor
 
     /*
         Setter Methods for Core Loan Data
@@ -66,9 +199,9 @@ public:
             Functions to enter or update the loan amount,
             interest rate, and repayment duration in years.
      */
-    void setLoanAmount(double amount);          // Sets the loan amount (principal)
-    void setAnnualInterestRate(double rate);    // Sets the annual interest rate (percentage)
-    void setTotalYearsToRepay(int years);       // Sets the total years to repay the loan
+    constexpr void setLoanAmount(double amount);          // Sets the loan amount (principal)
+    constexpr void setAnnualInterestRate(double rate);    // Sets the annual interest rate (percentage)
+    constexpr void setTotalYearsToRepay(int years);       // Sets the total years to repay the loan
 
     /*
         Financial Calculation Methods
@@ -78,14 +211,20 @@ public:
               such as monthly payments and total payback.
             - Marked [[nodiscard]] to warn if the return value is ignored,
               helping prevent accidental misuse of critical financial data.
+            - constexpr: usable in constant expressions (see PaymentFactorTable.h),
+              where the payment comes from the extended-precision evaluation in AnnuityMath.h.
+            - getMonthlyPaymentExtended() is the audit mode: the same payment in double-double
+              arithmetic, correctly rounded, at run time too (several times slower).
 
         Simpler Terms:
             Calculates how much you pay monthly
             and the total repayment amount over the loan term.
             The compiler will warn you if you ignore the results.
     */
-    [[nodiscard]] double getMonthlyPayment() const;  // Calculates and returns the monthly mortgage payment
-    [[nodiscard]] double getTotalPayback() const;    // Calculates and returns the total amount paid over the loan term
+    [[nodiscard]] constexpr double getMonthlyPayment() const;  // Calculates and returns the monthly mortgage payment
+    [[nodiscard]] constexpr double getMonthlyPaymentExtended() const;  // Same payment, correctly rounded (audits)
+    [[nodiscard]] constexpr double getTotalPayback() const;    // Calculates and returns the total amount paid over the loan term
+    [[nodiscard]] constexpr int getNumberOfPayments() const;   // Returns the total number of monthly payments
 
 
     /*
@@ -94,13 +233,290 @@ public:
         Programmer's Note:
             - Creates a detailed amortization schedule,
               writing payment breakdowns to a specified text file.
+            - The stream overload writes the same text to any std::ostream
+              (for example a std::ostringstream for in-memory use).
+            - writePaymentSchedule sends the schedule to any ScheduleSink (text, CSV, NDJSON,
+              columnar, or a custom one): beginLoan, the rows in blocks, endLoan. The text
+              output above is this with the text sink. The caller calls finish() on the sink.
 
         Simpler Terms:
             Saves a full payment plan to a file,
             showing how each payment splits into interest, principal, and remaining balance.
      */
     void outputPaymentSchedule(const std::string& filename) const;  // Writes detailed amortization schedule to a file
+    void outputPaymentSchedule(std::ostream& out) const;            // Writes the same schedule to a stream
+    void writePaymentSchedule(ScheduleSink& sink, std::size_t loanIndex = 0) const;  // Sends the schedule to a sink
+
+    /*
+        Lazy Payment Schedule
+
+        Programmer's Note:
+            - Returns a ScheduleRange over every payment; rows are computed on demand and
+              are identical to the rows outputPaymentSchedule prints. outputPaymentSchedule
+              and fillPaymentSchedule are both consumers of this range.
+
+        Simpler Terms:
+            The monthly payment plan as a list that works itself out as you read it.
+     */
+    [[nodiscard]] constexpr ScheduleRange schedule() const;  // Lazy, constant-memory view of the schedule
+
+    /*
+        Fill Payment Schedule (In Memory)
+
+        Programmer's Note:
+            - Writes the same rows outputPaymentSchedule prints into caller-provided storage.
+            - 'rows' must hold at least getNumberOfPayments() entries; no allocation is made.
+            - constexpr, so whole schedules can be generated at compile time.
+
+        Simpler Terms:
+            Builds the monthly payment plan in memory instead of in a file.
+     */
+    constexpr void fillPaymentSchedule(std::span<PaymentRow> rows) const;  // Computes the amortization schedule into rows
+
+    /*
+        Random-Access Schedule Queries
+
+        Programmer's Note:
+            - O(1) closed-form answers for any payment number, without running the schedule loop:
+                  B(k) = P(1 + r)^k - M((1 + r)^k - 1) / r
+            - (1 + r)^k - 1 is evaluated with expm1(k * log1p(r)) to avoid cancellation
+              at small rates.
+            - Month numbers are clamped to [0, getNumberOfPayments()]; balances are never
+              below zero, as in the schedule loop. paymentBreakdown clamps k to
+              [1, getNumberOfPayments()] and reports the clamped number as payment_number,
+              so it always returns a real schedule row.
+            - Results agree with the iterative schedule to within floating-point rounding
+              (far below a cent), not bit for bit.
+            - The span variants answer many months at once and share the log1p and
+              payment computations; 'out' must be as long as 'months'.
+
+        Simpler Terms:
+            Answers "how much is still owed after payment k" or "how much interest was paid
+            between payments a and b" instantly, for any month.
+     */
+    [[nodiscard]] double balanceAfter(int k) const;                         // Remaining balance after payment k
+    [[nodiscard]] double cumulativeInterest(int first, int last) const;     // Interest paid in payments first..last
+    [[nodiscard]] double cumulativePrincipal(int first, int last) const;    // Principal repaid in payments first..last
+    [[nodiscard]] PaymentRow paymentBreakdown(int k) const;                 // Row k of the schedule
+
+    void balancesAfter(std::span<const int> months, std::span<double> out) const;         // balanceAfter for each month
+    void cumulativeInterests(std::span<const int> months, std::span<double> out) const;   // Interest paid in payments 1..k
+    void paymentBreakdowns(std::span<const int> months, std::span<PaymentRow> out) const; // paymentBreakdown for each month
 
 };
 
+/*
+    Inline Member Function Definitions
+
+    Programmer's Note:
+        - The core loan math is defined here, in the header, so it can run in constant
+          expressions (C++20 constexpr constructors, destructor and member functions).
+        - std::is_constant_evaluated() keeps run-time behaviour exactly as before:
+          the fast payment factor and INFO logging at run time, the extended-precision
+          payment and no logging at compile time.
+
+    Simpler Terms:
+        The basic loan calculations, written so the compiler can also do them ahead of time.
+ */
+
+/*
+    Constructor
+
+    Programmer's Note:
+        - Initializes member variables to default values by assignment.
+        - Logs the creation of the Mortgage object for traceability.
+
+    Simpler Terms:
+        When a Mortgage object is created, this sets all loan details to zero
+        and shows a message that the mortgage calculation is starting.
+ */
+constexpr Mortgage::Mortgage() : Mortgage(true) {
+}
+
+/*
+    Constructor with Optional Logging
+
+    Programmer's Note:
+        - Same initialization as the default constructor.
+        - Only logs when logLifecycle is true (and never during constant evaluation);
+          batch pricing passes false.
+
+    Simpler Terms:
+        Sets up an empty loan, and only prints a message if you ask it to.
+ */
+constexpr Mortgage::Mortgage(bool logLifecycle) {
+    // Initialize all loan-related member variables to default values
+    loan_amount = 0.0;               // Initial loan amount set to 0
+    annual_interest_rate = 0.0;      // Annual interest rate set to 0%
+    monthly_interest_rate = 0.0;     // Monthly interest rate set to 0%
+    total_years_to_repay = 0;        // Total repayment duration in years set to 0
+    number_of_payments = 0;          // Total number of payments set to 0
+    log_lifecycle = logLifecycle;    // Remember whether to log construction/destruction
+
+    // Output a message indicating the constructor execution for tracing/debugging
+    if (!std::is_constant_evaluated() && log_lifecycle) {
+        logConstruction();
+    }
+}
+
+/*
+    Destructor
+
+    Programmer's Note:
+        - Handles the cleanup when the Mortgage object is destroyed.
+        - Outputs the loan amount for context during destruction.
+
+    Simpler Terms:
+        When the Mortgage object is finished, this shows a message
+        that includes the loan amount to confirm cleanup.
+ */
+constexpr Mortgage::~Mortgage() {
+    // Silent loans (batch mode) and compile-time loans skip the message entirely
+    if (!std::is_constant_evaluated() && log_lifecycle) {
+        logDestruction();
+    }
+}
+
+/*
+    Set Loan Amount
+
+    Programmer's Note:
+        - Stores the principal loan amount.
+
+    Simpler Terms:
+        Saves how much money you want to borrow.
+ */
+constexpr void Mortgage::setLoanAmount(double amount) {
+    loan_amount = amount; // Store the provided loan amount into the member variable
+}
+
+/*
+    Set Annual Interest Rate
+
+    Programmer's Note:
+        - Stores the annual interest rate.
+        - Calculates the equivalent monthly interest rate.
+
+    Simpler Terms:
+        Sets the yearly interest rate and figures out the monthly rate.
+ */
+constexpr void Mortgage::setAnnualInterestRate(double rate) {
+    annual_interest_rate = rate / 100.0;     // Convert percentage to decimal (e.g., 5% -> 0.05)
+    monthly_interest_rate = annual_interest_rate / 12.0;  // Calculate monthly rate
+}
+
+/*
+    Set Total Years to Repay
+
+    Programmer's Note:
+        - Stores the repayment term in years.
+        - Calculates the total number of monthly payments.
+
+    Simpler Terms:
+        Saves how many years you’ll take to pay off the loan,
+        and figures out how many monthly payments that means.
+ */
+constexpr void Mortgage::setTotalYearsToRepay(int years) {
+    total_years_to_repay = years;             // Store the repayment period in years
+    number_of_payments = total_years_to_repay * 12;  // Calculate total monthly payments
+}
+
+/*
+    Get Monthly Payment
+
+    Programmer's Note:
+        - Computes the monthly mortgage payment using the standard amortization formula,
+          principal * r / (1 - (1 + r)^-n), through annuity_math::paymentFactor (see
+          AnnuityMath.h for how it stays accurate at low rates and long terms).
+        - A zero rate gives principal / n, the limit of the formula; zero payments give zero.
+        - At compile time the payment comes from annuity_math::monthlyPaymentExtended
+          (correctly rounded, within a few ULP of the run-time value).
+
+    Simpler Terms:
+        Calculates how much you have to pay every month on your loan.
+ */
+constexpr double Mortgage::getMonthlyPayment() const {
+    // Safeguard: Return 0 if there are no payments to spread the loan over (invalid scenario)
+    if (number_of_payments == 0) {
+        return 0.0;
+    }
+
+    if (std::is_constant_evaluated()) {
+        return annuity_math::monthlyPaymentExtended(loan_amount, monthly_interest_rate, number_of_payments);
+    }
+
+    // Apply the amortization formula for fixed-rate mortgages
+    return loan_amount * annuity_math::paymentFactor(monthly_interest_rate, number_of_payments);
+}
+
+/*
+    Get Monthly Payment (Extended Precision)
+
+    Programmer's Note:
+        - Double-double evaluation of the same formula, rounded once: the reference that
+          getMonthlyPayment() and the batch kernels are measured against, for audits.
+
+    Simpler Terms:
+        The monthly payment worked out the slow, exact way, for double-checking.
+ */
+constexpr double Mortgage::getMonthlyPaymentExtended() const {
+    return annuity_math::monthlyPaymentExtended(loan_amount, monthly_interest_rate, number_of_payments);
+}
+
+/*
+    Get Total Payback
+
+    Programmer's Note:
+        - Calculates the total amount paid back over the life of the loan.
+
+    Simpler Terms:
+        Calculates the total amount of money you’ll pay by the time the loan is fully paid off.
+ */
+constexpr double Mortgage::getTotalPayback() const {
+    return getMonthlyPayment() * number_of_payments;  // Total payback = monthly payment * total number of payments
+}
+
+/*
+    Get Number of Payments
+
+    Programmer's Note:
+        - Returns the total number of monthly payments (years * 12).
+
+    Simpler Terms:
+        Tells you how many monthly payments the loan has.
+ */
+constexpr int Mortgage::getNumberOfPayments() const {
+    return number_of_payments;
+}
+
+/*
+    Schedule
+
+    Programmer's Note:
+        - Captures the loan's amount, monthly rate and level payment; the range does not
+          refer back to this object, so it stays valid if the Mortgage is changed later.
+
+    Simpler Terms:
+        Hands out the monthly payment plan, to be worked out as it is read.
+ */
+constexpr ScheduleRange Mortgage::schedule() const {
+    return { loan_amount, monthly_interest_rate, getMonthlyPayment(), number_of_payments };
+}
+
+/*
+    Fill Payment Schedule
+
+    Programmer's Note:
+        - Stores the rows of schedule(), so in-memory and file schedules agree bit for bit.
+
+    Simpler Terms:
+        Works out every month of the payment plan and saves it in a list.
+ */
+constexpr void Mortgage::fillPaymentSchedule(std::span<PaymentRow> rows) const {
+    std::size_t index = 0;
+    for (const PaymentRow& row : schedule()) {
+        rows[index++] = row;
+    }
+}
+
 #endif // MORTGAGE_H
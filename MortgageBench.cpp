@@ -0,0 +1,1594 @@
+/*
+    Program     : Mortgage Benchmarks (mortgage_bench)
+
+    Description:
+        Self-contained benchmark harness for the pricing paths of the
+        Mortgage Loan Calculator. Each benchmark prints one line:
+
+            <name>  <items>  <seconds per run>  <items per second>
+
+        Run it from a Release build; numbers from a Debug build are meaningless.
+*/
+
+#include "AnnuityFactorCache.h"
+#include "AnnuityMath.h"
+#include "ArmEngine.h"
+#include "BatchPricer.h"
+#include "BinarySchedule.h"
+#include "InverseSolvers.h"
+#include "LoanBook.h"
+#include "LoanTape.h"
+#include "MoneyEngine.h"
+#include "MonteCarlo.h"
+#include "Mortgage.h"
+#include "PaymentKernels.h"
+#include "PerfCounters.h"
+#include "PortfolioAggregate.h"
+#include "ProductCatalog.h"
+#include "ScenarioEngine.h"
+#include "ScheduleArena.h"
+#include "ScheduleEngine.h"
+#include "ScheduleSink.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/*
+    Function: doNotOptimize
+
+    Programmer's Note:
+        - Forces the compiler to treat 'value' as used, so benchmarked work is not removed.
+
+    Simpler Terms:
+        Stops the compiler from skipping work whose answer we never print.
+ */
+template <typename T>
+static void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+/*
+    Function: runBenchmark
+
+    Programmer's Note:
+        - Runs 'body' repeatedly for at least ~0.2 seconds and reports the best
+          per-run time, which is the least noisy estimate on a shared machine.
+        - Returns that best time, for benchmarks that compare two runs.
+
+    Simpler Terms:
+        Times a piece of code several times and prints how fast it went.
+ */
+template <typename Body>
+static double runBenchmark(const string& name, size_t items, Body&& body) {
+    using clock = chrono::steady_clock;
+    double best = 1e300;
+    double total = 0.0;
+    int runs = 0;
+
+    while (total < 0.2 || runs < 3) {
+        const auto start = clock::now();
+        body();
+        const double seconds = chrono::duration<double>(clock::now() - start).count();
+        best = min(best, seconds);
+        total += seconds;
+        ++runs;
+    }
+
+    printf("%-44s %10zu %12.6f s %14.0f items/s\n", name.c_str(), items, best, items / best);
+    return best;
+}
+
+/*
+    Function: makePortfolio
+
+    Programmer's Note:
+        - Random but reproducible portfolio: rates on a 1/8-point grid, common terms.
+
+    Simpler Terms:
+        Builds a list of made-up loans to time the calculations with.
+ */
+static vector<LoanRecord> makePortfolio(size_t count) {
+    mt19937_64 rng(12345);
+    uniform_real_distribution<double> amount(50'000.0, 1'500'000.0);
+    uniform_int_distribution<int> eighths(16, 80);   // 2.000% .. 10.000%
+    const int terms[] = { 10, 15, 20, 30, 40 };
+
+    vector<LoanRecord> loans(count);
+    for (LoanRecord& loan : loans) {
+        loan = { amount(rng), eighths(rng) / 8.0, terms[rng() % 5], 0 };
+    }
+    return loans;
+}
+
+/*
+    Function: makeLoanBook
+
+    Programmer's Note:
+        - Copies a portfolio into structure-of-arrays form.
+
+    Simpler Terms:
+        Puts the made-up loans into a LoanBook.
+ */
+static LoanBook makeLoanBook(const vector<LoanRecord>& loans) {
+    LoanBook book;
+    book.reserve(loans.size());
+    for (const LoanRecord& loan : loans) {
+        book.addLoan(loan.loan_amount, loan.annual_interest_rate, loan.total_years_to_repay);
+    }
+    return book;
+}
+
+/*
+    Function: ulpDistance
+
+    Programmer's Note:
+        - Number of representable doubles between a and b (both finite, same sign).
+
+    Simpler Terms:
+        How many "smallest steps" apart two numbers are.
+ */
+static int64_t ulpDistance(double a, double b) {
+    const int64_t ia = bit_cast<int64_t>(a);
+    const int64_t ib = bit_cast<int64_t>(b);
+    return ia > ib ? ia - ib : ib - ia;
+}
+
+/*
+    Function: benchMonthlyPayment
+
+    Programmer's Note:
+        - Scalar Mortgage::getMonthlyPayment() loop versus the LoanBook kernel at every
+          SIMD level this CPU supports, plus the largest ULP difference to Mortgage.
+        - Also checks that loans the vector lanes hand to the scalar factor (terms of zero
+          or fewer years, zero and tiny rates, terms so long that (1 + r)^n or P r F
+          overflows) price exactly as Mortgage prices them, in full blocks and in the
+          remainder.
+
+    Simpler Terms:
+        Compares pricing loans one by one against pricing them in groups.
+ */
+static void benchMonthlyPayment(size_t count) {
+    const vector<LoanRecord> loans = makePortfolio(count);
+    const LoanBook book = makeLoanBook(loans);
+    vector<double> payments(count);
+    vector<double> reference(count);
+
+    // Reference: one silent Mortgage object, exactly like batch mode
+    Mortgage loan(false);
+    runBenchmark("mortgage/getMonthlyPayment", count, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            loan.setLoanAmount(loans[i].loan_amount);
+            loan.setAnnualInterestRate(loans[i].annual_interest_rate);
+            loan.setTotalYearsToRepay(loans[i].total_years_to_repay);
+            reference[i] = loan.getMonthlyPayment();
+        }
+        doNotOptimize(reference.data());
+    });
+
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512 }) {
+        if (level > detectSimdLevel()) {
+            continue;
+        }
+
+        runBenchmark(string("loanbook/computeMonthlyPayments/") + simdLevelName(level), count, [&] {
+            book.computeMonthlyPayments(payments, level);
+            doNotOptimize(payments.data());
+        });
+
+        int64_t worst = 0;
+        for (size_t i = 0; i < count; ++i) {
+            worst = max(worst, ulpDistance(payments[i], reference[i]));
+        }
+        printf("  max difference vs Mortgage: %lld ULP\n", static_cast<long long>(worst));
+    }
+
+    const vector<LoanRecord> edgeLoans = {
+        { 250'000.0, 5.5, -2, 0 }, { 250'000.0, 5.5, 0, 0 }, { 250'000.0, 0.0, 30, 0 },
+        { 250'000.0, 1e-11, 30, 0 }, { 80'000.0, 7.25, -30, 0 }, { 80'000.0, 0.0, -1, 0 },
+        { 80'000.0, 3.0, -100, 0 }, { 80'000.0, 0.0, 0, 0 }, { 1'000.0, 12.0, -5, 0 },
+        { 100'000.0, 1000.0, 2'000'000, 0 }, { 100'000.0, 12.0, 6'667, 0 }, { 1e12, 12.0, 5'800, 0 }
+    };
+    const LoanBook edgeBook = makeLoanBook(edgeLoans);
+    vector<double> edgePayments(edgeLoans.size());
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512 }) {
+        if (level > detectSimdLevel()) {
+            continue;
+        }
+
+        edgeBook.computeMonthlyPayments(edgePayments, level);
+        bool identical = true;
+        for (size_t i = 0; i < edgeLoans.size(); ++i) {
+            loan.setLoanAmount(edgeLoans[i].loan_amount);
+            loan.setAnnualInterestRate(edgeLoans[i].annual_interest_rate);
+            loan.setTotalYearsToRepay(edgeLoans[i].total_years_to_repay);
+            identical = identical && ulpDistance(edgePayments[i], loan.getMonthlyPayment()) == 0;
+        }
+        printf("  %s: n <= 0, near-zero rates and overflowing (1 + r)^n identical to Mortgage: %s\n",
+               simdLevelName(level), identical ? "yes" : "NO");
+    }
+}
+
+/*
+    Function: benchFactorCache
+
+    Programmer's Note:
+        - Batch pricing with and without the annuity-factor cache on a portfolio that,
+          like real books, has few distinct (rate, term) pairs; prints the cache counters.
+
+    Simpler Terms:
+        Shows how much time remembering repeated rate/term math saves.
+ */
+static void benchFactorCache(size_t count) {
+    const vector<LoanRecord> loans = makePortfolio(count);
+    vector<LoanQuote> quotes(count);
+
+    runBenchmark("batch/priceLoans/pow", count, [&] {
+        priceLoans(loans, quotes);
+        doNotOptimize(quotes.data());
+    });
+
+    AnnuityFactorCache cache;
+    runBenchmark("batch/priceLoans/factor_cache", count, [&] {
+        priceLoans(loans, quotes, cache);
+        doNotOptimize(quotes.data());
+    });
+
+    const AnnuityFactorCache::Stats stats = cache.stats();
+    printf("  cache: %llu hits, %llu misses, %zu/%zu entries, %zu bytes\n",
+           static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.misses),
+           stats.entries, stats.capacity, stats.memory_bytes);
+}
+
+/*
+    Function: benchProductCatalog
+
+    Programmer's Note:
+        - Quoting from the compile-time StandardProductCatalog table versus run-time
+          Mortgage pricing, plus the largest ULP difference and any cent mismatch.
+
+    Simpler Terms:
+        Compares the built-in price list with doing the math on the spot.
+ */
+static void benchProductCatalog(size_t count) {
+    mt19937_64 rng(777);
+    uniform_real_distribution<double> amount(50'000.0, 1'500'000.0);
+    vector<double> principals(count);
+    vector<int> rateEighths(count);
+    vector<int> years(count);
+    for (size_t i = 0; i < count; ++i) {
+        principals[i] = amount(rng);
+        rateEighths[i] = 8 + static_cast<int>(rng() % StandardProductCatalog::rate_count);
+        years[i] = StandardProductCatalog::terms[rng() % StandardProductCatalog::terms.size()];
+    }
+
+    vector<double> quoted(count);
+    runBenchmark("catalog/monthlyPayment", count, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            quoted[i] = StandardProductCatalog::monthlyPayment(principals[i], rateEighths[i], years[i]);
+        }
+        doNotOptimize(quoted.data());
+    });
+
+    Mortgage loan(false);
+    int64_t worst = 0;
+    size_t centMismatches = 0;
+    for (size_t i = 0; i < count; ++i) {
+        loan.setLoanAmount(principals[i]);
+        loan.setAnnualInterestRate(rateEighths[i] / 8.0);
+        loan.setTotalYearsToRepay(years[i]);
+        const double runtime = loan.getMonthlyPayment();
+        worst = max(worst, ulpDistance(quoted[i], runtime));
+        centMismatches += llround(quoted[i] * 100.0) != llround(runtime * 100.0);
+    }
+    printf("  max difference vs Mortgage: %lld ULP, %zu cent mismatches\n",
+           static_cast<long long>(worst), centMismatches);
+}
+
+/*
+    Function: benchPortfolioSchedules
+
+    Programmer's Note:
+        - Serial versus work-stealing portfolio schedule builds, and a check that both
+          produce identical per-loan rows and monthly aggregates, also on an 8-thread pool
+          (the totals must not depend on the thread count).
+
+    Simpler Terms:
+        Times building every loan's payment plan on one core and on all cores.
+ */
+static void benchPortfolioSchedules(size_t count) {
+    const vector<LoanRecord> loans = makePortfolio(count);
+    WorkStealingPool pool;
+
+    PortfolioSchedule serial;
+    runBenchmark("schedule_engine/serial", count, [&] {
+        serial = buildPortfolioSchedulesSerial(loans);
+        doNotOptimize(serial.rows.data());
+    });
+
+    PortfolioSchedule parallel;
+    runBenchmark("schedule_engine/parallel/threads=" + to_string(pool.threadCount()), count, [&] {
+        parallel = buildPortfolioSchedules(loans, pool);
+        doNotOptimize(parallel.rows.data());
+    });
+
+    const auto sameAsSerial = [&serial](const PortfolioSchedule& other) {
+        return equal(serial.rows.begin(), serial.rows.end(), other.rows.begin(), other.rows.end(),
+                     [](const PaymentRow& a, const PaymentRow& b) {
+                         return a.payment_number == b.payment_number && a.interest == b.interest
+                             && a.principal == b.principal && a.remaining_balance == b.remaining_balance;
+                     })
+            && serial.interest_by_month == other.interest_by_month
+            && serial.principal_by_month == other.principal_by_month
+            && serial.balance_by_month == other.balance_by_month;
+    };
+
+    WorkStealingPool wide(8);
+    const bool identical = sameAsSerial(parallel) && sameAsSerial(buildPortfolioSchedules(loans, wide));
+    printf("  parallel result identical to serial (%u and 8 threads): %s\n",
+           pool.threadCount(), identical ? "yes" : "NO");
+}
+
+/*
+    Function: benchMoneyEngine
+
+    Programmer's Note:
+        - Servicer-style amortization of every loan with AmortizedLoan<double> and
+          AmortizedLoan<Cents64>, reported in schedule rows per second. Loans are set up
+          outside the timed loop so only the monthly loops are compared.
+        - Also reports how many loans the two paths disagree on by at least a cent.
+
+    Simpler Terms:
+        Times the decimal and the whole-cents payment plans against each other.
+ */
+static void benchMoneyEngine(size_t count) {
+    const vector<LoanRecord> records = makePortfolio(count);
+    vector<AmortizedLoan<double>> dollarLoans;
+    vector<AmortizedLoan<Cents64>> centLoans;
+    size_t rows = 0;
+    dollarLoans.reserve(records.size());
+    centLoans.reserve(records.size());
+    for (const LoanRecord& record : records) {
+        dollarLoans.emplace_back(record.loan_amount, record.annual_interest_rate, record.total_years_to_repay);
+        centLoans.emplace_back(record.loan_amount, record.annual_interest_rate, record.total_years_to_repay);
+        rows += static_cast<size_t>(centLoans.back().numberOfPayments());
+    }
+
+    vector<double> dollarTotals(records.size());
+    runBenchmark("money_engine/double/totalPayback", rows, [&] {
+        for (size_t i = 0; i < dollarLoans.size(); ++i) {
+            dollarTotals[i] = dollarLoans[i].totalPayback();
+        }
+        doNotOptimize(dollarTotals.data());
+    });
+
+    vector<Cents64> centTotals(records.size());
+    runBenchmark("money_engine/cents64/totalPayback", rows, [&] {
+        for (size_t i = 0; i < centLoans.size(); ++i) {
+            centTotals[i] = centLoans[i].totalPayback();
+        }
+        doNotOptimize(centTotals.data());
+    });
+
+    size_t differing = 0;
+    for (size_t i = 0; i < records.size(); ++i) {
+        differing += Cents64::fromDollars(dollarTotals[i]) != centTotals[i] ? 1 : 0;
+    }
+    printf("  loans where double and cents64 totals differ: %zu of %zu\n", differing, records.size());
+}
+
+/*
+    Function: benchScenarioSweep
+
+    Programmer's Note:
+        - Sweeps a $10,000 lump sum over every month of a 30-year loan (latest month first),
+          then a grid of extra principal x biweekly x PSA speed.
+        - "incremental" reuses one engine (each scenario recomputes from its first changed
+          month); "fresh" builds a new engine per scenario, i.e. a full schedule every time.
+        - Checks that both give bit-identical balance curves.
+
+    Simpler Terms:
+        Times trying many "what if" payment plans, with and without reusing earlier months.
+ */
+static void benchScenarioSweep() {
+    constexpr double AMOUNT = 400'000.0;
+    constexpr double RATE = 6.5;
+    constexpr int YEARS = 30;
+
+    vector<PrepaymentScenario> lumpSums;
+    for (int month = YEARS * 12; month >= 1; --month) {
+        lumpSums.push_back({ { { month, month, 10'000.0 } }, false, 0.0, 0.0 });
+    }
+
+    vector<PrepaymentScenario> grid;
+    for (double psa : { 0.0, 100.0, 200.0, 300.0 }) {
+        for (bool biweekly : { false, true }) {
+            for (double extra : { 0.0, 100.0, 250.0, 500.0 }) {
+                for (int start = YEARS * 12; start >= 1; start -= 12) {
+                    grid.push_back({ { { start, YEARS * 12, extra } }, biweekly, 0.0, psa });
+                }
+            }
+        }
+    }
+
+    for (const auto& [name, scenarios] : { pair<string, const vector<PrepaymentScenario>*>{ "lump_sum_by_month", &lumpSums },
+                                           pair<string, const vector<PrepaymentScenario>*>{ "extra_biweekly_psa_grid", &grid } }) {
+        ScenarioEngine engine(AMOUNT, RATE, YEARS);
+        double checksum = 0.0;
+        runBenchmark("scenario/" + name + "/incremental", scenarios->size(), [&] {
+            for (const PrepaymentScenario& scenario : *scenarios) {
+                checksum += engine.evaluate(scenario).interest_saved;
+            }
+            doNotOptimize(checksum);
+        });
+
+        runBenchmark("scenario/" + name + "/fresh", scenarios->size(), [&] {
+            for (const PrepaymentScenario& scenario : *scenarios) {
+                ScenarioEngine fresh(AMOUNT, RATE, YEARS);
+                checksum += fresh.evaluate(scenario).interest_saved;
+            }
+            doNotOptimize(checksum);
+        });
+
+        bool identical = true;
+        ScenarioEngine incremental(AMOUNT, RATE, YEARS);
+        for (const PrepaymentScenario& scenario : *scenarios) {
+            const ScenarioResult& a = incremental.evaluate(scenario);
+            ScenarioEngine fresh(AMOUNT, RATE, YEARS);
+            const ScenarioResult& b = fresh.evaluate(scenario);
+            identical = identical && a.payoff_month == b.payoff_month && a.total_interest == b.total_interest
+                     && equal(a.balance_curve.begin(), a.balance_curve.end(), b.balance_curve.begin(), b.balance_curve.end());
+        }
+        printf("  incremental result identical to fresh: %s\n", identical ? "yes" : "NO");
+    }
+}
+
+/*
+    Function: benchArmPaths
+
+    Programmer's Note:
+        - A 5/1 ARM (30 years, 2/2/5 caps) under 'count' simulated index paths: a random
+          walk from 4% with 0.15% monthly steps, stored month-major.
+        - Times every SIMD level serially and the widest level on the pool, checks the
+          scalar level against the one-path reference, and reports the largest relative
+          difference of the vector levels from scalar.
+
+    Simpler Terms:
+        Times valuing an adjustable-rate loan under thousands of rate scenarios.
+ */
+static void benchArmPaths(size_t count) {
+    ArmTerms terms;
+    terms.loan_amount = 400'000.0;
+    terms.total_years_to_repay = 30;
+    terms.initial_rate_percent = 5.5;
+
+    const int months = terms.total_years_to_repay * 12;
+    vector<double> index(static_cast<size_t>(months) * count);
+    mt19937_64 rng(2024);
+    normal_distribution<double> step(0.0, 0.15);
+    vector<double> level(count, 4.0);
+    for (int m = 0; m < months; ++m) {
+        for (size_t p = 0; p < count; ++p) {
+            level[p] = max(0.0, level[p] + step(rng));
+            index[static_cast<size_t>(m) * count + p] = level[p];
+        }
+    }
+    const RatePathMatrix paths{ index, count, months };
+
+    vector<double> interest(count), paid(count), maxPayment(count);
+    vector<double> scalarInterest;
+    const ArmPathOutputs out{ interest, paid, maxPayment };
+
+    for (SimdLevel simd : { SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512 }) {
+        if (simd > detectSimdLevel()) {
+            continue;
+        }
+        runBenchmark(string("arm/evaluateArmPaths/") + simdLevelName(simd), count, [&] {
+            evaluateArmPaths(terms, paths, out, simd);
+            doNotOptimize(interest.data());
+        });
+
+        if (simd == SimdLevel::Scalar) {
+            scalarInterest = interest;
+            bool identical = true;
+            for (size_t p = 0; p < count; ++p) {
+                const ArmPathResult reference = evaluateArmPath(terms, paths, p);
+                identical = identical && reference.total_interest == interest[p] && reference.total_paid == paid[p]
+                         && reference.max_payment == maxPayment[p];
+            }
+            printf("  scalar identical to one-path reference: %s\n", identical ? "yes" : "NO");
+        } else {
+            double worst = 0.0;
+            for (size_t p = 0; p < count; ++p) {
+                worst = max(worst, fabs(interest[p] - scalarInterest[p]) / scalarInterest[p]);
+            }
+            printf("  max relative difference vs scalar: %.3g\n", worst);
+        }
+    }
+
+    WorkStealingPool pool;
+    runBenchmark("arm/evaluateArmPaths/pool/threads=" + to_string(pool.threadCount()), count, [&] {
+        evaluateArmPaths(terms, paths, out, pool);
+        doNotOptimize(interest.data());
+    });
+}
+
+/*
+    Function: sameResult
+
+    Programmer's Note:
+        - Exact (bitwise) comparison of two simulation results.
+
+    Simpler Terms:
+        Checks that two simulations produced exactly the same numbers.
+ */
+static bool sameResult(const MonteCarloResult& a, const MonteCarloResult& b) {
+    return a.expected_cash_flow == b.expected_cash_flow && a.expected_interest == b.expected_interest
+        && a.expected_prepayment == b.expected_prepayment && a.expected_loss == b.expected_loss
+        && a.cash_flow_percentiles == b.cash_flow_percentiles && a.lifetime_cash_flow == b.lifetime_cash_flow
+        && a.lifetime_loss == b.lifetime_loss;
+}
+
+/*
+    Function: benchMonteCarlo
+
+    Programmer's Note:
+        - Simulates a 100-loan portfolio under 'paths' paths with one thread and with the
+          default pool, checks that both results are bit-identical (and identical with a
+          4-thread pool), and prints lifetime cash-flow and loss percentiles.
+
+    Simpler Terms:
+        Times the portfolio simulation and checks it gives the same answer on any number of cores.
+ */
+static void benchMonteCarlo(size_t paths) {
+    const vector<LoanRecord> loans = makePortfolio(100);
+    MonteCarloConfig config;
+    config.paths = paths;
+
+    WorkStealingPool single(1);
+    WorkStealingPool pool;
+    WorkStealingPool four(4);
+    MonteCarloResult serialResult, poolResult, fourResult;
+
+    runBenchmark("monte_carlo/100_loans/threads=1", paths, [&] {
+        simulatePortfolio(loans, config, single, serialResult);
+    });
+    runBenchmark("monte_carlo/100_loans/threads=" + to_string(pool.threadCount()), paths, [&] {
+        simulatePortfolio(loans, config, pool, poolResult);
+    });
+    simulatePortfolio(loans, config, four, fourResult);
+
+    printf("  identical for 1, %u and 4 threads: %s\n", pool.threadCount(),
+           sameResult(serialResult, poolResult) && sameResult(serialResult, fourResult) ? "yes" : "NO");
+    printf("  lifetime cash flow p5/p50/p95: %.0f / %.0f / %.0f, loss p50/p95: %.0f / %.0f\n",
+           serialResult.lifetime_cash_flow_percentiles[0], serialResult.lifetime_cash_flow_percentiles[1],
+           serialResult.lifetime_cash_flow_percentiles[2], serialResult.lifetime_loss_percentiles[1],
+           serialResult.lifetime_loss_percentiles[2]);
+}
+
+/*
+    Function: benchScheduleArena
+
+    Programmer's Note:
+        - In-memory schedules for every loan of a portfolio, all kept until the batch ends:
+          one std::vector per loan versus a ScheduleArena reset once per batch. Reports rows per second and whether
+          the arena allocated any new chunks after the first (warm-up) batch.
+
+    Simpler Terms:
+        Times building many payment plans in memory with and without the scratch area.
+ */
+static void benchScheduleArena(size_t count) {
+    const vector<LoanRecord> loans = makePortfolio(count);
+    vector<Mortgage> mortgages;
+    mortgages.reserve(count);
+    size_t rows = 0;
+    for (const LoanRecord& record : loans) {
+        Mortgage& loan = mortgages.emplace_back(false);
+        loan.setLoanAmount(record.loan_amount);
+        loan.setAnnualInterestRate(record.annual_interest_rate);
+        loan.setTotalYearsToRepay(record.total_years_to_repay);
+        rows += static_cast<size_t>(loan.getNumberOfPayments());
+    }
+
+    // Both variants keep every schedule of the batch alive until the batch is done
+    vector<vector<PaymentRow>> owned;
+    runBenchmark("schedule/vector_per_loan", rows, [&] {
+        owned.clear();
+        owned.reserve(mortgages.size());
+        for (const Mortgage& loan : mortgages) {
+            vector<PaymentRow>& schedule = owned.emplace_back(static_cast<size_t>(loan.getNumberOfPayments()));
+            loan.fillPaymentSchedule(schedule);
+        }
+        doNotOptimize(owned.data());
+    });
+    owned = {};
+
+    ScheduleArena arena;
+    vector<span<const PaymentRow>> schedules;
+    schedules.reserve(mortgages.size());
+    size_t chunksAfterWarmUp = 0;
+    runBenchmark("schedule/arena_per_batch", rows, [&] {
+        arena.reset();
+        schedules.clear();
+        for (const Mortgage& loan : mortgages) {
+            schedules.push_back(arena.schedule(loan));
+        }
+        doNotOptimize(schedules.data());
+        chunksAfterWarmUp = chunksAfterWarmUp == 0 ? arena.chunkCount() : chunksAfterWarmUp;
+    });
+    printf("  arena chunks: %zu after warm-up, %zu at end (%.1f MiB)\n", chunksAfterWarmUp, arena.chunkCount(),
+           arena.capacityRows() * sizeof(PaymentRow) / 1048576.0);
+}
+
+/*
+    Function: benchScheduleRange
+
+    Programmer's Note:
+        - Total interest over every loan's schedule three ways: a hand-written amortization
+          loop, a range-for over Mortgage::schedule(), and a std::views::transform pipeline
+          over it. All three must give identical sums; rows per second should match.
+
+    Simpler Terms:
+        Checks that reading the payment plan one month at a time costs nothing extra.
+ */
+static void benchScheduleRange(size_t count) {
+    const vector<LoanRecord> loans = makePortfolio(count);
+    vector<Mortgage> mortgages;
+    mortgages.reserve(count);
+    size_t rows = 0;
+    for (const LoanRecord& record : loans) {
+        Mortgage& loan = mortgages.emplace_back(false);
+        loan.setLoanAmount(record.loan_amount);
+        loan.setAnnualInterestRate(record.annual_interest_rate);
+        loan.setTotalYearsToRepay(record.total_years_to_repay);
+        rows += static_cast<size_t>(loan.getNumberOfPayments());
+    }
+
+    double handWritten = 0.0;
+    runBenchmark("schedule/hand_written_loop", rows, [&] {
+        handWritten = 0.0;
+        for (size_t i = 0; i < loans.size(); ++i) {
+            const double rate = loans[i].annual_interest_rate / 100.0 / 12.0;
+            const double payment = mortgages[i].getMonthlyPayment();
+            double balance = loans[i].loan_amount;
+            for (int k = 1; k <= mortgages[i].getNumberOfPayments(); ++k) {
+                const double interest = rate * balance;
+                balance -= payment - interest;
+                if (balance < 0.0) balance = 0.0;
+                handWritten += interest;
+            }
+        }
+        doNotOptimize(handWritten);
+    });
+
+    double rangeFor = 0.0;
+    runBenchmark("schedule/range_for", rows, [&] {
+        rangeFor = 0.0;
+        for (const Mortgage& loan : mortgages) {
+            for (const PaymentRow& row : loan.schedule()) {
+                rangeFor += row.interest;
+            }
+        }
+        doNotOptimize(rangeFor);
+    });
+
+    double pipeline = 0.0;
+    runBenchmark("schedule/views_transform", rows, [&] {
+        pipeline = 0.0;
+        for (const Mortgage& loan : mortgages) {
+            for (double interest : loan.schedule() | views::transform([](const PaymentRow& row) { return row.interest; })) {
+                pipeline += interest;
+            }
+        }
+        doNotOptimize(pipeline);
+    });
+
+    printf("  identical totals: %s\n", handWritten == rangeFor && rangeFor == pipeline ? "yes" : "NO");
+}
+
+/*
+    Function: benchScheduleQueries
+
+    Programmer's Note:
+        - Times balancesAfter for one random month per loan against walking schedule() up
+          to that month.
+        - Checks the closed-form queries against the iterative schedule for every month
+          k = -2 .. n + 2 of every loan (plus interest-free loans): balanceAfter and
+          cumulativePrincipal / cumulativeInterest against the running schedule values,
+          paymentBreakdown against row k (with k clamped), and the span variants against
+          the single-month calls. The largest differences are reported; they must stay
+          far below a cent.
+
+    Simpler Terms:
+        Makes sure the instant "balance after month k" answers match the month-by-month plan.
+ */
+static void benchScheduleQueries(size_t count) {
+    vector<LoanRecord> loans = makePortfolio(count);
+    loans.push_back({ 100'000.0, 0.0, 30, 0 });
+    loans.push_back({ 1'234.56, 0.0, 1, 0 });
+    vector<Mortgage> mortgages;
+    mortgages.reserve(loans.size());
+    for (const LoanRecord& record : loans) {
+        Mortgage& loan = mortgages.emplace_back(false);
+        loan.setLoanAmount(record.loan_amount);
+        loan.setAnnualInterestRate(record.annual_interest_rate);
+        loan.setTotalYearsToRepay(record.total_years_to_repay);
+    }
+
+    mt19937_64 rng(777);
+    vector<int> months(mortgages.size());
+    for (size_t i = 0; i < months.size(); ++i) {
+        months[i] = 1 + static_cast<int>(rng() % static_cast<uint64_t>(mortgages[i].getNumberOfPayments()));
+    }
+
+    vector<double> balances(mortgages.size());
+    runBenchmark("schedule/balanceAfter/closed_form", mortgages.size(), [&] {
+        for (size_t i = 0; i < mortgages.size(); ++i) {
+            balances[i] = mortgages[i].balanceAfter(months[i]);
+        }
+        doNotOptimize(balances.data());
+    });
+
+    runBenchmark("schedule/balanceAfter/iterate", mortgages.size(), [&] {
+        for (size_t i = 0; i < mortgages.size(); ++i) {
+            for (const PaymentRow& row : mortgages[i].schedule() | views::take(months[i])) {
+                balances[i] = row.remaining_balance;
+            }
+        }
+        doNotOptimize(balances.data());
+    });
+
+    double worstBalance = 0.0;
+    double worstCumulative = 0.0;
+    double worstRow = 0.0;
+    bool numbersMatch = true;
+    bool spansMatch = true;
+    vector<PaymentRow> rows;
+    vector<int> allMonths;
+    vector<double> spanBalances, spanInterests;
+    vector<PaymentRow> spanRows;
+    for (size_t index = 0; index < mortgages.size(); ++index) {
+        const Mortgage& loan = mortgages[index];
+        const int n = loan.getNumberOfPayments();
+        rows.resize(static_cast<size_t>(n));
+        loan.fillPaymentSchedule(rows);
+
+        // expected[k]: balance after k payments; paid[k]: interest in payments 1..k
+        vector<double> expected(static_cast<size_t>(n) + 1), paid(static_cast<size_t>(n) + 1);
+        expected[0] = loans[index].loan_amount;
+        for (int k = 1; k <= n; ++k) {
+            expected[k] = rows[k - 1].remaining_balance;
+            paid[k] = paid[k - 1] + rows[k - 1].interest;
+        }
+
+        allMonths.clear();
+        for (int k = -2; k <= n + 2; ++k) {
+            allMonths.push_back(k);
+        }
+        spanBalances.resize(allMonths.size());
+        spanInterests.resize(allMonths.size());
+        spanRows.resize(allMonths.size());
+        loan.balancesAfter(allMonths, spanBalances);
+        loan.cumulativeInterests(allMonths, spanInterests);
+        loan.paymentBreakdowns(allMonths, spanRows);
+
+        for (size_t i = 0; i < allMonths.size(); ++i) {
+            const int k = allMonths[i];
+            const int clamped = clamp(k, 0, n);
+            const double balance = loan.balanceAfter(k);
+            worstBalance = max(worstBalance, fabs(balance - expected[clamped]));
+            worstCumulative = max(worstCumulative, fabs(loan.cumulativeInterest(1, k) - paid[clamped]));
+            worstCumulative = max(worstCumulative,
+                                  fabs(loan.cumulativePrincipal(1, k) - (expected[0] - expected[clamped])));
+
+            const PaymentRow row = loan.paymentBreakdown(k);
+            const PaymentRow& reference = rows[clamp(k, 1, n) - 1];
+            numbersMatch = numbersMatch && row.payment_number == reference.payment_number;
+            worstRow = max({ worstRow, fabs(row.interest - reference.interest),
+                             fabs(row.principal - reference.principal),
+                             fabs(row.remaining_balance - reference.remaining_balance) });
+
+            spansMatch = spansMatch && spanBalances[i] == balance
+                      && spanInterests[i] == loan.cumulativeInterest(1, k)
+                      && spanRows[i].payment_number == row.payment_number
+                      && spanRows[i].interest == row.interest
+                      && spanRows[i].remaining_balance == row.remaining_balance;
+        }
+    }
+
+    const bool ok = worstBalance < 1e-4 && worstCumulative < 1e-4 && worstRow < 1e-4 && numbersMatch && spansMatch;
+    printf("  vs schedule(), every month: balance %.2e, cumulative %.2e, row %.2e dollars;"
+           " payment numbers %s, span variants %s: %s\n",
+           worstBalance, worstCumulative, worstRow, numbersMatch ? "match" : "DIFFER",
+           spansMatch ? "match" : "DIFFER", ok ? "ok" : "FAILED");
+}
+
+/*
+    Function: benchBinarySchedules
+
+    Programmer's Note:
+        - Times writeBinarySchedules for the portfolio in both encodings (items are rows),
+          then reads every loan back through BinaryScheduleReader: Float64 rows must equal
+          fillPaymentSchedule exactly and FixedPoint rows to within half a ten-thousandth.
+          writeScheduleText of loan 0 must match outputPaymentSchedule byte for byte.
+        - Also damages a copy of the header (an offset and a count near 2^64) and checks
+          that the reader refuses both files, and that a FixedPoint write of values too
+          large for int64 fails without leaving a file behind.
+
+    Simpler Terms:
+        Saves payment plans in the binary format, reads them back, and compares.
+ */
+static void benchBinarySchedules(size_t count) {
+    const string filename = (filesystem::temp_directory_path() / "mortgage_bench_schedules.bin").string();
+    const vector<LoanRecord> loans = makePortfolio(count);
+    size_t rows = 0;
+    for (const LoanRecord& record : loans) {
+        rows += static_cast<size_t>(record.total_years_to_repay) * 12;
+    }
+
+    bool roundTrip = true;
+    for (const ScheduleEncoding encoding : { ScheduleEncoding::Float64, ScheduleEncoding::FixedPoint }) {
+        const bool exact = encoding == ScheduleEncoding::Float64;
+        runBenchmark(string("binary_schedule/write/") + (exact ? "float64" : "fixed_point"), rows, [&] {
+            writeBinarySchedules(filename, loans, encoding);
+        });
+
+        const BinaryScheduleReader reader(filename);
+        roundTrip = roundTrip && reader.isOpen() && reader.loanCount() == loans.size();
+        Mortgage loan(false);
+        vector<PaymentRow> expected;
+        for (size_t i = 0; roundTrip && i < loans.size(); ++i) {
+            loan.setLoanAmount(loans[i].loan_amount);
+            loan.setAnnualInterestRate(loans[i].annual_interest_rate);
+            loan.setTotalYearsToRepay(loans[i].total_years_to_repay);
+            expected.resize(static_cast<size_t>(loan.getNumberOfPayments()));
+            loan.fillPaymentSchedule(expected);
+
+            const double tolerance = exact ? 0.0 : 0.5e-4;
+            roundTrip = reader.loan(i).row_count == expected.size();
+            for (size_t k = 0; roundTrip && k < expected.size(); ++k) {
+                const PaymentRow row = reader.row(i, static_cast<int>(k + 1));
+                roundTrip = fabs(row.interest - expected[k].interest) <= tolerance
+                         && fabs(row.principal - expected[k].principal) <= tolerance
+                         && fabs(row.remaining_balance - expected[k].remaining_balance) <= tolerance;
+            }
+
+            if (exact && i == 0) {
+                ostringstream text, reference;
+                writeScheduleText(reader, 0, text);
+                loan.outputPaymentSchedule(reference);
+                roundTrip = roundTrip && text.str() == reference.str();
+            }
+        }
+    }
+
+    // A damaged copy: the reader must reject wrapped offsets and huge counts
+    bool rejectsDamage = true;
+    for (const size_t field : { offsetof(BinaryScheduleHeader, interest_offset), offsetof(BinaryScheduleHeader, loan_count) }) {
+        writeBinarySchedules(filename, span(loans).first(1));
+        {
+            fstream file(filename, ios::in | ios::out | ios::binary);
+            const uint64_t damaged = UINT64_MAX - 7;
+            file.seekp(static_cast<streamoff>(field));
+            file.write(reinterpret_cast<const char*>(&damaged), sizeof(damaged));
+        }
+        cerr.setstate(ios::failbit);        // The reader's ERROR line is expected here
+        rejectsDamage = rejectsDamage && !BinaryScheduleReader(filename).isOpen();
+        cerr.clear();
+    }
+
+    // Balances of 1e16 dollars do not fit int64 ten-thousandths: refused, no file left behind
+    const LoanRecord oversized[] = { { 1e16, 5.0, 1, 0 } };
+    cerr.setstate(ios::failbit);            // The writer's ERROR line is expected here
+    const bool refusesOverflow = !writeBinarySchedules(filename, oversized, ScheduleEncoding::FixedPoint)
+                              && !filesystem::exists(filename);
+    cerr.clear();
+
+    printf("  round trip identical to fillPaymentSchedule and outputPaymentSchedule: %s,"
+           " damaged headers rejected: %s, fixed-point overflow refused: %s\n", roundTrip ? "yes" : "NO",
+           rejectsDamage ? "yes" : "NO", refusesOverflow ? "yes" : "NO");
+
+    error_code ignored;
+    filesystem::remove(filename, ignored);
+}
+
+/*
+    Function: benchInverseSolvers
+
+    Programmer's Note:
+        - Prices the portfolio with Mortgage::getMonthlyPayment(), then solves back for the
+          principal, the rate and the term at every SIMD level.
+        - Round trips: each solved principal or rate is fed back through a Mortgage and the
+          largest relative payment error is reported; solved terms must equal the originals.
+        - A grid of 0.25%..50% rates and 1..50 year terms reports the most Newton rounds
+          any loan needed (the bound is MAX_RATE_ITERATIONS).
+
+    Simpler Terms:
+        Times the reverse calculations and checks they give back the numbers we started with.
+ */
+static void benchInverseSolvers(size_t count) {
+    const vector<LoanRecord> loans = makePortfolio(count);
+    vector<double> principal(count), rate(count), payment(count), solved(count);
+    vector<int32_t> payments(count), solvedTerm(count);
+
+    Mortgage loan(false);
+    for (size_t i = 0; i < count; ++i) {
+        loan.setLoanAmount(loans[i].loan_amount);
+        loan.setAnnualInterestRate(loans[i].annual_interest_rate);
+        loan.setTotalYearsToRepay(loans[i].total_years_to_repay);
+        principal[i] = loans[i].loan_amount;
+        rate[i] = loans[i].annual_interest_rate / 100.0 / 12.0;
+        payments[i] = loans[i].total_years_to_repay * 12;
+        payment[i] = loan.getMonthlyPayment();
+    }
+
+    // Relative payment error after putting a solved principal or annual rate back into a Mortgage
+    const auto roundTrip = [&](size_t i, double amount, double annualPercent) {
+        loan.setLoanAmount(amount);
+        loan.setAnnualInterestRate(annualPercent);
+        loan.setTotalYearsToRepay(loans[i].total_years_to_repay);
+        return fabs(loan.getMonthlyPayment() - payment[i]) / payment[i];
+    };
+
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512 }) {
+        if (level > detectSimdLevel()) {
+            continue;
+        }
+
+        runBenchmark(string("inverse/solveMaxPrincipal/") + simdLevelName(level), count, [&] {
+            solveMaxPrincipal(payment.data(), rate.data(), payments.data(), solved.data(), count, level);
+            doNotOptimize(solved.data());
+        });
+        double worst = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            worst = max(worst, roundTrip(i, solved[i], loans[i].annual_interest_rate));
+        }
+        printf("  max payment round-trip error: %.3g\n", worst);
+
+        int rounds = 0;
+        runBenchmark(string("inverse/solveMonthlyRate/") + simdLevelName(level), count, [&] {
+            rounds = solveMonthlyRate(principal.data(), payment.data(), payments.data(), solved.data(), count, level);
+            doNotOptimize(solved.data());
+        });
+        worst = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            worst = max(worst, roundTrip(i, principal[i], solved[i] * 1200.0));
+        }
+        printf("  max payment round-trip error: %.3g (Newton rounds <= %d)\n", worst, rounds);
+    }
+
+    runBenchmark("inverse/solveMinimumTerm", count, [&] {
+        solveMinimumTerm(principal.data(), payment.data(), rate.data(), solvedTerm.data(), count);
+        doNotOptimize(solvedTerm.data());
+    });
+    printf("  terms identical to originals: %s\n", solvedTerm == payments ? "yes" : "NO");
+
+    vector<double> gridPrincipal, gridPayment, gridRate;
+    vector<int32_t> gridTerm;
+    for (int years = 1; years <= 50; ++years) {
+        for (int quarter = 1; quarter <= 200; ++quarter) {
+            const double r = quarter / 4.0 / 100.0 / 12.0;
+            gridPrincipal.push_back(250'000.0);
+            gridTerm.push_back(years * 12);
+            gridPayment.push_back(250'000.0 * r * pow(1 + r, years * 12) / (pow(1 + r, years * 12) - 1));
+            gridRate.push_back(r);
+        }
+    }
+    vector<double> gridSolved(gridRate.size());
+    const int gridRounds = solveMonthlyRate(gridPrincipal.data(), gridPayment.data(), gridTerm.data(),
+                                            gridSolved.data(), gridSolved.size());
+    double rateWorst = 0.0, paymentWorst = 0.0;
+    for (size_t i = 0; i < gridSolved.size(); ++i) {
+        const double r = gridSolved[i];
+        const double power_factor = pow(1 + r, gridTerm[i]);
+        rateWorst = max(rateWorst, fabs(r - gridRate[i]) / gridRate[i]);
+        paymentWorst = max(paymentWorst, fabs(gridPrincipal[i] * r * power_factor / (power_factor - 1) - gridPayment[i])
+                                         / gridPayment[i]);
+    }
+    printf("  rate grid 0.25%%..50%% x 1..50 years: max relative error rate %.3g, payment %.3g, Newton rounds <= %d\n",
+           rateWorst, paymentWorst, gridRounds);
+}
+
+/*
+    Function: benchPortfolioAggregate
+
+    Programmer's Note:
+        - Builds a PortfolioAggregate from the portfolio (checked against
+          buildPortfolioSchedulesSerial, which sums in blocks of loans, so to rounding), then times single-loan changes (rate, amount and
+          term edits, add + remove pairs) against a full rebuild.
+        - After all the changes, reports how far the incremental sums drifted from a rebuild.
+        - Checks that NaN and infinite terms are refused without touching the totals, and
+          that adding and then removing loans leaves every total and average at exactly 0.
+
+    Simpler Terms:
+        Times keeping portfolio totals up to date one loan at a time versus recalculating them.
+ */
+static void benchPortfolioAggregate(size_t count) {
+    const vector<LoanRecord> loans = makePortfolio(count);
+
+    PortfolioAggregate aggregate;
+    runBenchmark("aggregate/build", count, [&] {
+        aggregate = PortfolioAggregate();
+        for (const LoanRecord& loan : loans) {
+            aggregate.addLoan(loan.loan_amount, loan.annual_interest_rate, loan.total_years_to_repay);
+        }
+        doNotOptimize(aggregate.totalInterest());
+    });
+
+    const PortfolioSchedule reference = buildPortfolioSchedulesSerial(loans);
+    double curveDifference = aggregate.months() == reference.interest_by_month.size() ? 0.0 : 1.0;
+    for (size_t m = 0; m < aggregate.months() && m < reference.interest_by_month.size(); ++m) {
+        curveDifference = max({ curveDifference,
+            fabs(aggregate.interestByMonth()[m] - reference.interest_by_month[m]) / max(reference.interest_by_month[m], 1.0),
+            fabs(aggregate.balanceByMonth()[m] - reference.balance_by_month[m]) / max(reference.balance_by_month[m], 1.0) });
+    }
+    const double interestBefore = aggregate.totalInterest();
+    cerr.setstate(ios::failbit);            // The ERROR lines are expected here
+    const bool refused = aggregate.addLoan(numeric_limits<double>::quiet_NaN(), 5.0, 30) == PortfolioAggregate::INVALID_LOAN
+                      && !aggregate.setLoanAmount(0, numeric_limits<double>::infinity())
+                      && !aggregate.setAnnualInterestRate(0, numeric_limits<double>::quiet_NaN());
+    cerr.clear();
+    printf("  curves vs buildPortfolioSchedulesSerial: %.3g relative (%s), non-finite loans refused: %s\n",
+           curveDifference, curveDifference < 1e-12 ? "ok" : "DIFFER", refused && aggregate.totalInterest() == interestBefore ? "yes" : "NO");
+
+    constexpr size_t CHANGES = 4'000;
+    mt19937_64 rng(777);
+    const vector<LoanRecord> edits = makePortfolio(CHANGES);
+    size_t round = 0;
+    runBenchmark("aggregate/incremental_change", CHANGES, [&] {
+        for (size_t k = 0; k < CHANGES; ++k) {
+            const PortfolioAggregate::LoanId id = rng() % count;
+            const LoanRecord& edit = edits[(k + round) % CHANGES];
+            switch (k % 4) {
+            case 0: aggregate.setAnnualInterestRate(id, edit.annual_interest_rate); break;
+            case 1: aggregate.setLoanAmount(id, edit.loan_amount); break;
+            case 2: aggregate.setTotalYearsToRepay(id, edit.total_years_to_repay); break;
+            default:
+                // Removing one loan and adding another keeps the book the same size (the id is reused)
+                aggregate.removeLoan(id);
+                aggregate.addLoan(edit.loan_amount, edit.annual_interest_rate, edit.total_years_to_repay);
+                break;
+            }
+        }
+        ++round;
+        doNotOptimize(aggregate.totalInterest());
+    });
+
+    const vector<double> incremental(aggregate.cashFlowByMonth().begin(), aggregate.cashFlowByMonth().end());
+    const double incrementalInterest = aggregate.totalInterest();
+    runBenchmark("aggregate/full_rebuild", count, [&] {
+        aggregate.rebuild();
+        doNotOptimize(aggregate.totalInterest());
+    });
+
+    double worst = 0.0;
+    for (size_t m = 0; m < incremental.size() && m < aggregate.months(); ++m) {
+        worst = max(worst, fabs(incremental[m] - aggregate.cashFlowByMonth()[m]) / aggregate.cashFlowByMonth()[m]);
+    }
+    printf("  after %zu rounds of changes: max relative drift cash flow %.3g, total interest %.3g\n", round, worst,
+           fabs(incrementalInterest - aggregate.totalInterest()) / aggregate.totalInterest());
+    printf("  weighted average rate %.4f%%, term %.1f months, %zu months\n", aggregate.weightedAverageRate(),
+           aggregate.weightedAverageTerm(), aggregate.months());
+
+    // Amounts with no exact binary sum leave residue behind unless emptying resets the totals
+    PortfolioAggregate emptied;
+    const PortfolioAggregate::LoanId ids[] = { emptied.addLoan(300'000.1, 6.5, 30), emptied.addLoan(0.2, 3.0, 15),
+                                               emptied.addLoan(123'456.7, 4.0, 20) };
+    for (PortfolioAggregate::LoanId id : ids) {
+        emptied.removeLoan(id);
+    }
+    const bool cleared = emptied.totalPrincipal() == 0.0 && emptied.totalInterest() == 0.0
+                      && emptied.totalPayback() == 0.0 && emptied.weightedAverageRate() == 0.0
+                      && emptied.weightedAverageTerm() == 0.0 && emptied.months() == 0;
+    printf("  emptied portfolio totals and averages exactly 0: %s\n", cleared ? "yes" : "NO");
+}
+
+/*
+    Function: benchLoanTape
+
+    Programmer's Note:
+        - Writes the portfolio as a CSV tape (header, shortest round-trip numbers) to a
+          scratch file, with every 1000th record spoiled in one of five ways, then times
+          loadLoanTape on one thread and on all of them; items are bytes, so items/s is
+          the ingest rate.
+        - Checks that every good loan was loaded exactly (the book equals one built with
+          addLoan from the same records) and that the rejects were counted by reason.
+
+    Simpler Terms:
+        Times reading a big loan file and makes sure the right loans were kept.
+ */
+static void benchLoanTape(size_t count) {
+    const string tapeName = (filesystem::temp_directory_path() / "mortgage_bench_tape.csv").string();
+    const string rejectName = (filesystem::temp_directory_path() / "mortgage_bench_rejects.csv").string();
+    const vector<LoanRecord> loans = makePortfolio(count);
+    const char* spoiled[] = { "-125000,5.5,30", "250000,-1.5,30", "250000,5.5,0", "250000,nan,30", "12x,abc" };
+
+    vector<LoanRecord> good;
+    good.reserve(count);
+    {
+        ofstream tape(tapeName, ios::binary);
+        string text = "amount,rate,years\n";
+        char number[64];
+        for (size_t i = 0; i < count; ++i) {
+            if (i % 1000 == 999) {
+                text += spoiled[(i / 1000) % 5];
+            } else {
+                const LoanRecord& loan = loans[i];
+                text.append(number, to_chars(number, number + sizeof(number), loan.loan_amount).ptr);
+                text += ',';
+                text.append(number, to_chars(number, number + sizeof(number), loan.annual_interest_rate).ptr);
+                text += ',';
+                text += to_string(loan.total_years_to_repay);
+                good.push_back(loan);
+            }
+            text += '\n';
+            if (text.size() >= (1 << 20)) {
+                tape.write(text.data(), static_cast<streamsize>(text.size()));
+                text.clear();
+            }
+        }
+        tape.write(text.data(), static_cast<streamsize>(text.size()));
+    }
+    const size_t bytes = filesystem::file_size(tapeName);
+
+    LoanBook book;
+    LoanTapeStats stats;
+    WorkStealingPool serial(1);
+    runBenchmark("tape/ingest_bytes/1t", bytes, [&] {
+        loadLoanTape(tapeName, book, serial, stats);
+        doNotOptimize(book.size());
+    });
+
+    WorkStealingPool pool;
+    runBenchmark("tape/ingest_bytes/" + to_string(pool.threadCount()) + "t", bytes, [&] {
+        loadLoanTape(tapeName, book, pool, stats);
+        doNotOptimize(book.size());
+    });
+
+    LoanTapeOptions options;
+    options.reject_path = rejectName;
+    loadLoanTape(tapeName, book, pool, stats, options);
+    const LoanBook expected = makeLoanBook(good);
+    const bool identical = ranges::equal(book.principals(), expected.principals())
+                        && ranges::equal(book.monthlyRates(), expected.monthlyRates())
+                        && ranges::equal(book.paymentCounts(), expected.paymentCounts());
+    printf("  %.1f MB, %zu chunks: loaded %zu (identical to addLoan: %s), rejected %zu:",
+           bytes / 1.0e6, stats.chunks, stats.loans_loaded, identical ? "yes" : "NO", stats.loans_rejected);
+    for (size_t reason = 1; reason < LOAN_CHECK_COUNT; ++reason) {
+        printf(" %s %zu", loanCheckName(static_cast<LoanCheck>(reason)), stats.rejected_by_reason[reason]);
+    }
+    printf("\n");
+
+    error_code ignored;
+    filesystem::remove(tapeName, ignored);
+    filesystem::remove(rejectName, ignored);
+}
+
+/*
+    Function: benchPaymentAccuracy
+
+    Programmer's Note:
+        - Measures every pricing path against the extended-precision reference
+          (LoanBook::computeMonthlyPaymentsExtended) on two books: the usual portfolio and
+          a stress book of very low rates (1e-9% to 2% a year, log-uniform) and 1- to
+          50-year terms, where the textbook formula loses the most digits.
+        - "legacy" is the formula as it was before annuity_math, P r F / (F - 1) with
+          F = std::pow(1 + r, n), kept here only as the yardstick.
+        - Checks the vector kernels against the 4 ULP bound documented in PaymentKernels.h.
+        - Then times legacy, the fast path and the extended path over the same columns, and
+          prints the fast path's cost relative to legacy.
+
+    Simpler Terms:
+        Shows how close each way of pricing is to the exact answer, and what accuracy costs.
+ */
+static double legacyMonthlyPayment(double principal, double monthlyRate, int32_t payments) {
+    if (monthlyRate == 0 || payments == 0) {
+        return 0.0;
+    }
+    const double power_factor = pow(1 + monthlyRate, payments);
+    return (principal * monthlyRate * power_factor) / (power_factor - 1);
+}
+
+static void benchPaymentAccuracy(size_t count) {
+    constexpr int64_t VECTOR_MAX_ULP = 4;   // Bound PaymentKernels.h documents for the vector kernels
+    const LoanBook portfolio = makeLoanBook(makePortfolio(count));
+
+    LoanBook stress;
+    mt19937_64 rng(2718);
+    uniform_real_distribution<double> amount(50'000.0, 1'500'000.0);
+    uniform_real_distribution<double> rateExponent(-9.0, log10(2.0));
+    uniform_int_distribution<int> years(1, 50);
+    stress.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        stress.addLoan(amount(rng), pow(10.0, rateExponent(rng)), years(rng));
+    }
+
+    vector<double> reference(count);
+    vector<double> payments(count);
+
+    for (const auto& [bookName, book] : { pair<const char*, const LoanBook*>{ "portfolio", &portfolio },
+                                          pair<const char*, const LoanBook*>{ "low_rate", &stress } }) {
+        const span<const double> principal = book->principals();
+        const span<const double> rate = book->monthlyRates();
+        const span<const int32_t> term = book->paymentCounts();
+        book->computeMonthlyPaymentsExtended(reference);
+
+        auto report = [&](const char* path) {
+            int64_t worst = 0;
+            for (size_t i = 0; i < count; ++i) {
+                worst = max(worst, ulpDistance(payments[i], reference[i]));
+            }
+            printf("  %-9s %-28s max error vs extended: %lld ULP\n", bookName, path,
+                   static_cast<long long>(worst));
+            return worst;
+        };
+
+        for (size_t i = 0; i < count; ++i) {
+            payments[i] = legacyMonthlyPayment(principal[i], rate[i], term[i]);
+        }
+        report("legacy std::pow formula");
+
+        for (size_t i = 0; i < count; ++i) {
+            payments[i] = principal[i] * annuity_math::paymentFactor(rate[i], term[i]);
+        }
+        report("annuity_math::paymentFactor");
+
+        for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512 }) {
+            if (level <= detectSimdLevel()) {
+                book->computeMonthlyPayments(payments, level);
+                const int64_t worst = report((string("kernel/") + simdLevelName(level)).c_str());
+                if (level != SimdLevel::Scalar) {
+                    printf("  %-9s kernel/%s within %lld ULP of extended: %s\n", bookName, simdLevelName(level),
+                           static_cast<long long>(VECTOR_MAX_ULP), worst <= VECTOR_MAX_ULP ? "yes" : "NO");
+                }
+            }
+        }
+    }
+
+    const span<const double> principal = portfolio.principals();
+    const span<const double> rate = portfolio.monthlyRates();
+    const span<const int32_t> term = portfolio.paymentCounts();
+
+    const double legacy = runBenchmark("accuracy/legacy_pow_formula", count, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            payments[i] = legacyMonthlyPayment(principal[i], rate[i], term[i]);
+        }
+        doNotOptimize(payments.data());
+    });
+    const double fast = runBenchmark("accuracy/annuity_math_fast", count, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            payments[i] = principal[i] * annuity_math::paymentFactor(rate[i], term[i]);
+        }
+        doNotOptimize(payments.data());
+    });
+    runBenchmark("accuracy/annuity_math_extended", count, [&] {
+        portfolio.computeMonthlyPaymentsExtended(payments);
+        doNotOptimize(payments.data());
+    });
+    printf("  fast path time vs legacy: %.3fx\n", fast / legacy);
+}
+
+/*
+    Function: readExportedLoan
+
+    Programmer's Note:
+        - Reads the rows of one loan back from a CSV, NDJSON or columnar export, as an
+          independent check of the writers. CSV and NDJSON lines are split at ',' or ':'
+          and parsed with from_chars (the header line does not parse and is skipped);
+          the columnar file is walked from its trailer through the group table.
+
+    Simpler Terms:
+        Loads one loan's payment plan back out of an exported file.
+ */
+static vector<PaymentRow> readExportedLoan(const string& filename, ScheduleFormat format, size_t loanIndex) {
+    ifstream inFile(filename, ios::binary);
+    const string bytes((istreambuf_iterator<char>(inFile)), istreambuf_iterator<char>());
+    vector<PaymentRow> rows;
+
+    if (format == ScheduleFormat::Columnar) {
+        ColumnarTrailer trailer{};
+        if (bytes.size() < sizeof(trailer)) {
+            return rows;
+        }
+        memcpy(&trailer, bytes.data() + bytes.size() - sizeof(trailer), sizeof(trailer));
+
+        for (uint64_t group = 0; group < trailer.group_count; ++group) {
+            ColumnarGroupEntry entry{};
+            memcpy(&entry, bytes.data() + trailer.group_table_offset + group * sizeof(entry), sizeof(entry));
+            const char* columns = bytes.data() + entry.offset + sizeof(ColumnarGroupHeader);
+            const size_t narrow = (entry.row_count * 4 + 7) / 8 * 8;     // Padded 4-byte column
+            const size_t wide = entry.row_count * 8;
+
+            for (size_t k = 0; k < entry.row_count; ++k) {
+                uint32_t loan = 0;
+                memcpy(&loan, columns + k * 4, sizeof(loan));
+                if (loan != loanIndex) {
+                    continue;
+                }
+                PaymentRow row{};
+                memcpy(&row.payment_number, columns + narrow + k * 4, 4);
+                memcpy(&row.payment_amount, columns + 2 * narrow + k * 8, 8);
+                memcpy(&row.interest, columns + 2 * narrow + wide + k * 8, 8);
+                memcpy(&row.principal, columns + 2 * narrow + 2 * wide + k * 8, 8);
+                memcpy(&row.remaining_balance, columns + 2 * narrow + 3 * wide + k * 8, 8);
+                rows.push_back(row);
+            }
+        }
+        return rows;
+    }
+
+    const char separator = format == ScheduleFormat::Ndjson ? ':' : ',';
+    istringstream lines(bytes);
+    string line;
+    while (getline(lines, line)) {
+        // Fields: loan, payment_number, payment_amount, interest, principal, remaining_balance
+        double fields[6];
+        const char* cursor = line.data() + (format == ScheduleFormat::Ndjson ? line.find(':') + 1 : 0);
+        const char* last = line.data() + line.size();
+        size_t parsed = 0;
+        for (; parsed < 6 && cursor <= last; ++parsed) {
+            const auto [end, error] = from_chars(cursor, last, fields[parsed]);
+            if (error != errc()) {
+                break;
+            }
+            cursor = find(end, last, separator) + 1;
+        }
+        if (parsed == 6 && fields[0] == static_cast<double>(loanIndex)) {
+            rows.push_back({ static_cast<int>(fields[1]), fields[2], fields[3], fields[4], fields[5] });
+        }
+    }
+    return rows;
+}
+
+/*
+    Function: benchScheduleExport
+
+    Programmer's Note:
+        - Exports the schedules of the portfolio to a scratch file in every built-in format,
+          with the sink on the calling thread (inline) and on the background writer;
+          items are rows. The last run of each background export reports how long the
+          producer waited for the writer, and the file size.
+        - Checks that a one-loan text export is byte-identical to outputPaymentSchedule,
+          that the columnar trailer accounts for every row and loan, and that the first,
+          middle and last loans read back from the CSV, NDJSON and columnar files
+          (readExportedLoan) equal fillPaymentSchedule exactly.
+
+    Simpler Terms:
+        Times saving many payment plans in each file format, with and without a helper thread.
+ */
+static void benchScheduleExport(size_t count) {
+    const string filename = (filesystem::temp_directory_path() / "mortgage_bench_export.out").string();
+    const vector<LoanRecord> loans = makePortfolio(count);
+    const pair<const char*, ScheduleFormat> formats[] = {
+        { "text", ScheduleFormat::Text }, { "csv", ScheduleFormat::Csv },
+        { "ndjson", ScheduleFormat::Ndjson }, { "columnar", ScheduleFormat::Columnar }
+    };
+
+    size_t rows = 0;
+    for (const LoanRecord& loan : loans) {
+        rows += static_cast<size_t>(loan.total_years_to_repay) * 12;
+    }
+
+    // The rows each export must contain for the loans that are read back
+    const size_t checked[] = { 0, count / 2, count - 1 };
+    vector<vector<PaymentRow>> expectedRows;
+    for (const size_t index : checked) {
+        Mortgage loan(false);
+        loan.setLoanAmount(loans[index].loan_amount);
+        loan.setAnnualInterestRate(loans[index].annual_interest_rate);
+        loan.setTotalYearsToRepay(loans[index].total_years_to_repay);
+        expectedRows.emplace_back(static_cast<size_t>(loan.getNumberOfPayments()));
+        loan.fillPaymentSchedule(expectedRows.back());
+    }
+
+    ScheduleExportStats stats;
+    bool readBack = true;
+    for (const auto& [name, format] : formats) {
+        for (const bool background : { false, true }) {
+            ScheduleExportOptions options;
+            options.background_writer = background;
+            runBenchmark(string("export/") + name + (background ? "/background" : "/inline"), rows, [&] {
+                ofstream outFile(filename, ios::binary);
+                const unique_ptr<ScheduleSink> sink = makeScheduleSink(format, outFile);
+                stats = exportSchedules(loans, *sink, options);
+            });
+        }
+        printf("  %zu rows, %zu blocks, %.1f MB, producer waited %.1f ms\n", stats.rows, stats.blocks,
+               filesystem::file_size(filename) / 1.0e6, stats.producer_wait_seconds * 1000.0);
+
+        for (size_t i = 0; format != ScheduleFormat::Text && i < size(checked); ++i) {
+            readBack = readBack && ranges::equal(readExportedLoan(filename, format, checked[i]), expectedRows[i],
+                [](const PaymentRow& a, const PaymentRow& b) {
+                    return a.payment_number == b.payment_number && a.payment_amount == b.payment_amount
+                        && a.interest == b.interest && a.principal == b.principal
+                        && a.remaining_balance == b.remaining_balance;
+                });
+        }
+    }
+
+    ColumnarTrailer trailer{};
+    {
+        ifstream inFile(filename, ios::binary);
+        inFile.seekg(-static_cast<streamoff>(sizeof(trailer)), ios::end);
+        inFile.read(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+    }
+    const bool columnarOk = trailer.row_count == stats.rows && trailer.loan_count == loans.size()
+                         && string_view(trailer.magic, sizeof(trailer.magic)) == "MTGCOLS1";
+
+    Mortgage loan(false);
+    loan.setLoanAmount(loans[0].loan_amount);
+    loan.setAnnualInterestRate(loans[0].annual_interest_rate);
+    loan.setTotalYearsToRepay(loans[0].total_years_to_repay);
+    ostringstream expected;
+    loan.outputPaymentSchedule(expected);
+    ostringstream exported;
+    const unique_ptr<ScheduleSink> textSink = makeScheduleSink(ScheduleFormat::Text, exported);
+    exportSchedules(span(loans).first(1), *textSink);
+    printf("  text identical to outputPaymentSchedule: %s, columnar trailer consistent: %s,"
+           " csv/ndjson/columnar read back exactly: %s\n",
+           exported.str() == expected.str() ? "yes" : "NO", columnarOk ? "yes" : "NO", readBack ? "yes" : "NO");
+
+    error_code ignored;
+    filesystem::remove(filename, ignored);
+}
+
+/*
+    Function: benchPortfolioSizes
+
+    Programmer's Note:
+        - Mortgage::getMonthlyPayment() and getTotalPayback() over portfolios of
+          increasing size, to show where the working set leaves the caches.
+
+    Simpler Terms:
+        Times pricing small, medium and large lists of loans one by one.
+ */
+static void benchPortfolioSizes(size_t count) {
+    vector<size_t> sizes;
+    for (size_t size : { size_t{ 1'000 }, size_t{ 100'000 }, count }) {
+        if (size <= count && find(sizes.begin(), sizes.end(), size) == sizes.end()) {
+            sizes.push_back(size);
+        }
+    }
+
+    for (size_t size : sizes) {
+        const vector<LoanRecord> loans = makePortfolio(size);
+        vector<double> results(size);
+        Mortgage loan(false);
+
+        runBenchmark("mortgage/getMonthlyPayment/loans=" + to_string(size), size, [&] {
+            for (size_t i = 0; i < size; ++i) {
+                loan.setLoanAmount(loans[i].loan_amount);
+                loan.setAnnualInterestRate(loans[i].annual_interest_rate);
+                loan.setTotalYearsToRepay(loans[i].total_years_to_repay);
+                results[i] = loan.getMonthlyPayment();
+            }
+            doNotOptimize(results.data());
+        });
+
+        runBenchmark("mortgage/getTotalPayback/loans=" + to_string(size), size, [&] {
+            for (size_t i = 0; i < size; ++i) {
+                loan.setLoanAmount(loans[i].loan_amount);
+                loan.setAnnualInterestRate(loans[i].annual_interest_rate);
+                loan.setTotalYearsToRepay(loans[i].total_years_to_repay);
+                results[i] = loan.getTotalPayback();
+            }
+            doNotOptimize(results.data());
+        });
+    }
+}
+
+/*
+    Function: benchScheduleOutput
+
+    Programmer's Note:
+        - Text schedule for one loan per common term, written to an in-memory stream and
+          to a scratch file in the system temp directory, reported in rows per second.
+
+    Simpler Terms:
+        Times writing out payment plans of different lengths to memory and to disk.
+ */
+static void benchScheduleOutput() {
+    const string filename = (filesystem::temp_directory_path() / "mortgage_bench_schedule.txt").string();
+
+    for (int years : { 10, 15, 20, 30, 40 }) {
+        Mortgage loan(false);
+        loan.setLoanAmount(250'000.0);
+        loan.setAnnualInterestRate(6.0);
+        loan.setTotalYearsToRepay(years);
+        const size_t rows = static_cast<size_t>(loan.getNumberOfPayments());
+
+        ostringstream out;
+        runBenchmark("mortgage/outputPaymentSchedule/ostream/" + to_string(years) + "y", rows, [&] {
+            out.str("");
+            loan.outputPaymentSchedule(out);
+            doNotOptimize(out);
+        });
+
+        runBenchmark("mortgage/outputPaymentSchedule/file/" + to_string(years) + "y", rows, [&] {
+            loan.outputPaymentSchedule(filename);
+        });
+    }
+
+    error_code ignored;
+    filesystem::remove(filename, ignored);
+}
+
+/*
+    Function: main
+
+    Programmer's Note:
+        - Optional arguments: portfolio size (default 1,000,000 loans) and --json, which
+          prints the library's performance counters as JSON after the benchmarks
+          (all zeros unless built with -DMORTGAGE_PERF_COUNTERS=ON).
+        - The size must be at least 1,000: some benchmarks use loans / 1000 of them.
+          Anything else prints a usage line and exits with status 1.
+
+    Simpler Terms:
+        Runs every benchmark and prints the results.
+ */
+int main(int argc, char* argv[]) {
+    size_t loans = 1'000'000;
+    bool json = false;
+    for (int i = 1; i < argc; ++i) {
+        const char* last = argv[i] + strlen(argv[i]);
+        if (string(argv[i]) == "--json") {
+            json = true;
+        } else if (const auto [end, error] = from_chars(argv[i], last, loans);
+                   error != errc() || end != last || loans < 1'000) {
+            cerr << "ERROR: usage: mortgage_bench [number_of_loans (at least 1000)] [--json]" << endl;
+            return 1;
+        }
+    }
+
+    printf("SIMD level: %s\n", simdLevelName(detectSimdLevel()));
+    benchMonthlyPayment(loans);
+    benchPaymentAccuracy(loans / 5);
+    benchFactorCache(loans);
+    benchProductCatalog(loans);
+    benchPortfolioSchedules(loans / 20);
+    benchMoneyEngine(loans / 20);
+    benchScheduleArena(loans / 20);
+    benchScheduleRange(loans / 20);
+    benchScheduleQueries(loans / 200);
+    benchBinarySchedules(loans / 200);
+    benchScenarioSweep();
+    benchArmPaths(10'000);
+    benchMonteCarlo(1'000);
+    benchInverseSolvers(loans);
+    benchPortfolioAggregate(loans / 20);
+    benchLoanTape(loans);
+    benchScheduleExport(loans / 1000);
+    benchPortfolioSizes(loans);
+    benchScheduleOutput();
+
+    if (json) {
+        fflush(stdout);
+        perf_counters::writeJson(cout);
+    }
+    return 0;
+}
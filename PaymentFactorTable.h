@@ -0,0 +1,84 @@
+// PaymentFactorTable Template Specification
+
+#ifndef PAYMENT_FACTOR_TABLE_H
+#define PAYMENT_FACTOR_TABLE_H
+
+#include "Mortgage.h"
+#include <array>
+#include <cstddef>
+#include <limits>
+
+/*
+    Class Template: PaymentFactorTable
+
+    Programmer's Note:
+        - Compile-time table of payment factors (monthly payment per dollar borrowed)
+          for a fixed product catalog: annual rates from MinRateEighths/8 % to
+          MaxRateEighths/8 % in 1/8-point steps, for each term in TermYears.
+        - Every entry is computed by a constexpr Mortgage (loan amount 1.0), so the table
+          is baked into the binary and quoting needs no run-time std::pow at all.
+        - Compile-time loans price in extended precision, so each entry is the correctly
+          rounded factor; principal * factor matches the run-time Mortgage::getMonthlyPayment()
+          to within a few ULP (see AnnuityMath.h), i.e. to the cent.
+        - Rates or terms outside the catalog return NaN; check contains() first.
+
+    Simpler Terms:
+        A price list worked out by the compiler: look up the rate and term,
+        multiply by the loan amount, and you have the monthly payment.
+ */
+template <int MinRateEighths, int MaxRateEighths, int... TermYears>
+class PaymentFactorTable {
+public:
+    static_assert(MinRateEighths > 0 && MinRateEighths <= MaxRateEighths, "rate grid must be positive and non-empty");
+    static_assert(sizeof...(TermYears) > 0, "catalog needs at least one term");
+
+    static constexpr int rate_count = MaxRateEighths - MinRateEighths + 1;
+    static constexpr int term_count = static_cast<int>(sizeof...(TermYears));
+    static constexpr std::array<int, sizeof...(TermYears)> terms{ TermYears... };
+
+    // True if the rate (in eighths of a percent) and term (years) are in the catalog
+    static constexpr bool contains(int rateEighths, int years) {
+        return rateEighths >= MinRateEighths && rateEighths <= MaxRateEighths && termIndex(years) >= 0;
+    }
+
+    // Monthly payment per dollar borrowed
+    static constexpr double paymentFactor(int rateEighths, int years) {
+        if (!contains(rateEighths, years)) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return factors[static_cast<std::size_t>((rateEighths - MinRateEighths) * term_count + termIndex(years))];
+    }
+
+    // Monthly payment for a loan of 'principal' dollars
+    static constexpr double monthlyPayment(double principal, int rateEighths, int years) {
+        return principal * paymentFactor(rateEighths, years);
+    }
+
+private:
+    static constexpr int termIndex(int years) {
+        for (int i = 0; i < term_count; ++i) {
+            if (terms[static_cast<std::size_t>(i)] == years) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    static constexpr std::array<double, static_cast<std::size_t>(rate_count * term_count)> buildFactors() {
+        std::array<double, static_cast<std::size_t>(rate_count * term_count)> table{};
+        for (int rate = 0; rate < rate_count; ++rate) {
+            for (int term = 0; term < term_count; ++term) {
+                Mortgage loan(false);
+                loan.setLoanAmount(1.0);
+                loan.setAnnualInterestRate((MinRateEighths + rate) / 8.0);
+                loan.setTotalYearsToRepay(terms[static_cast<std::size_t>(term)]);
+                table[static_cast<std::size_t>(rate * term_count + term)] = loan.getMonthlyPayment();
+            }
+        }
+        return table;
+    }
+
+    static constexpr std::array<double, static_cast<std::size_t>(rate_count * term_count)> factors = buildFactors();
+};
+
+#endif // PAYMENT_FACTOR_TABLE_H
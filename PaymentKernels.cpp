@@ -0,0 +1,340 @@
+// Payment Kernels Implementation
+
+#include "PaymentKernels.h"
+#include "AnnuityMath.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MORTGAGE_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr double VECTOR_SMALL_RATE = 1e-12;     // Below this the vector lanes use the scalar factor
+
+/*
+    Scalar Monthly Payment
+
+    Programmer's Note:
+        - Same expression, in the same order, as Mortgage::getMonthlyPayment().
+
+    Simpler Terms:
+        The ordinary one-loan-at-a-time calculation.
+ */
+double monthlyPaymentScalar(double principal, double monthlyRate, int32_t paymentCount) {
+    return paymentCount == 0 ? 0.0 : principal * annuity_math::paymentFactor(monthlyRate, paymentCount);
+}
+
+void monthlyPaymentsScalar(const double* principal, const double* monthlyRate,
+                           const int32_t* paymentCount, double* monthlyPayment, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        monthlyPayment[i] = monthlyPaymentScalar(principal[i], monthlyRate[i], paymentCount[i]);
+    }
+}
+
+/*
+    Exponent Bit Count
+
+    Programmer's Note:
+        - Number of binary-exponentiation rounds needed for the largest n in the batch,
+          so every vector lane runs the same (short) loop. Negative n are left out: those
+          lanes are priced by the scalar fallback.
+
+    Simpler Terms:
+        How many squaring steps the longest loan needs.
+ */
+int exponentBits(const int32_t* paymentCount, size_t count) {
+    int32_t maxCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        maxCount = max(maxCount, paymentCount[i]);
+    }
+    return bit_width(static_cast<uint32_t>(maxCount));
+}
+
+#ifdef MORTGAGE_X86_DISPATCH
+
+/*
+    AVX2 Payment Block (4 loans)
+
+    Programmer's Note:
+        - (1 + r)^n by binary exponentiation over the bits of n, carried as a double-double
+          (hi, lo) pair: products use FMA to recover the exact rounding error, so the power
+          factor keeps ~106 bits until the final hi + lo rounding.
+        - Lanes whose bit is clear keep their running result through a blend, so loans
+          with different terms share one loop.
+        - The base starts as the exact sum 1 + r (rounded sum plus its error), and F - 1 is
+          taken before the pair is rounded, so low rates and long terms stay accurate.
+        - Lanes with |r| < VECTOR_SMALL_RATE, n < 0 (whose sign-extended bits the loop
+          would misread) or a non-finite payment (F, or P r F, overflowed to inf; the scalar
+          factor is then r) are redone with the scalar factor. Ordinary loans never take
+          this path, so the check costs three compares.
+
+    Simpler Terms:
+        Prices four loans in one go using the computer's 256-bit registers.
+ */
+__attribute__((target("avx2,fma")))
+void paymentBlockAvx2(const double* principal, const double* monthlyRate,
+                      const int32_t* paymentCount, double* monthlyPayment, int bits) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d r = _mm256_loadu_pd(monthlyRate);
+    const __m256i exponent = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(paymentCount)));
+
+    // 1 + r exactly, as a rounded sum and its error (Knuth's two-sum)
+    __m256d baseHi = _mm256_add_pd(one, r);
+    const __m256d rPart = _mm256_sub_pd(baseHi, one);
+    __m256d baseLo = _mm256_add_pd(_mm256_sub_pd(one, _mm256_sub_pd(baseHi, rPart)), _mm256_sub_pd(r, rPart));
+    __m256d powHi = one, powLo = zero;
+
+    for (int bit = 0; bit < bits; ++bit) {
+        // Lanes whose exponent has this bit set multiply the running result by the base
+        const __m256i bitMask = _mm256_set1_epi64x(int64_t{1} << bit);
+        const __m256d take = _mm256_castsi256_pd(
+            _mm256_cmpeq_epi64(_mm256_and_si256(exponent, bitMask), bitMask));
+
+        __m256d prod = _mm256_mul_pd(powHi, baseHi);
+        __m256d err = _mm256_fmsub_pd(powHi, baseHi, prod);
+        err = _mm256_fmadd_pd(powHi, baseLo, _mm256_fmadd_pd(powLo, baseHi, err));
+        const __m256d hi = _mm256_add_pd(prod, err);
+        const __m256d lo = _mm256_sub_pd(err, _mm256_sub_pd(hi, prod));
+        powHi = _mm256_blendv_pd(powHi, hi, take);
+        powLo = _mm256_blendv_pd(powLo, lo, take);
+
+        // Square the base for the next bit
+        prod = _mm256_mul_pd(baseHi, baseHi);
+        err = _mm256_fmsub_pd(baseHi, baseHi, prod);
+        err = _mm256_fmadd_pd(_mm256_add_pd(baseHi, baseHi), baseLo, err);
+        baseHi = _mm256_add_pd(prod, err);
+        baseLo = _mm256_sub_pd(err, _mm256_sub_pd(baseHi, prod));
+    }
+
+    // F - 1 from the unrounded pair: powHi - 1 is exact wherever it cancels (Sterbenz)
+    const __m256d power_factor = _mm256_add_pd(powHi, powLo);
+    const __m256d growth = _mm256_add_pd(_mm256_sub_pd(powHi, one), powLo);
+    const __m256d numerator = _mm256_mul_pd(_mm256_mul_pd(_mm256_loadu_pd(principal), r), power_factor);
+    __m256d payment = _mm256_div_pd(numerator, growth);
+
+    // n == 0 -> 0.0, as in Mortgage::getMonthlyPayment()
+    const __m256d noPayments = _mm256_castsi256_pd(_mm256_cmpeq_epi64(exponent, _mm256_setzero_si256()));
+    payment = _mm256_blendv_pd(payment, zero, noPayments);
+    _mm256_storeu_pd(monthlyPayment, payment);
+
+    // Rates near zero (r == 0 included), negative payment counts and non-finite results
+    // (F or P r F overflowed: inf / inf) -> the scalar factor
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+    const __m256d absRate = _mm256_andnot_pd(signBit, r);
+    const __m256d negativeCount = _mm256_castsi256_pd(_mm256_cmpgt_epi64(_mm256_setzero_si256(), exponent));
+    const __m256d nonFinite = _mm256_cmp_pd(_mm256_andnot_pd(signBit, payment),
+                                            _mm256_set1_pd(numeric_limits<double>::infinity()), _CMP_NLT_UQ);
+    int fallback = _mm256_movemask_pd(_mm256_or_pd(_mm256_or_pd(negativeCount, nonFinite), _mm256_andnot_pd(noPayments,
+        _mm256_cmp_pd(absRate, _mm256_set1_pd(VECTOR_SMALL_RATE), _CMP_LT_OQ))));
+    while (fallback != 0) {
+        const int lane = countr_zero(static_cast<unsigned>(fallback));
+        monthlyPayment[lane] = monthlyPaymentScalar(principal[lane], monthlyRate[lane], paymentCount[lane]);
+        fallback &= fallback - 1;
+    }
+}
+
+/*
+    AVX2 Monthly Payment (4 loans per instruction)
+
+    Programmer's Note:
+        - Runs paymentBlockAvx2 over the arrays; the remainder (count % 4)
+          goes through the same code on a zero-padded copy.
+
+    Simpler Terms:
+        Prices the whole list four loans at a time.
+ */
+__attribute__((target("avx2,fma")))
+void monthlyPaymentsAvx2(const double* principal, const double* monthlyRate,
+                         const int32_t* paymentCount, double* monthlyPayment, size_t count) {
+    const int bits = exponentBits(paymentCount, count);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        paymentBlockAvx2(principal + i, monthlyRate + i, paymentCount + i, monthlyPayment + i, bits);
+    }
+
+    if (i < count) {
+        double p[4] = {}, rate[4] = {}, out[4];
+        int32_t n[4] = {};
+        copy(principal + i, principal + count, p);
+        copy(monthlyRate + i, monthlyRate + count, rate);
+        copy(paymentCount + i, paymentCount + count, n);
+        paymentBlockAvx2(p, rate, n, out, bits);
+        copy(out, out + (count - i), monthlyPayment + i);
+    }
+}
+
+/*
+    AVX-512 Monthly Payment (8 loans per instruction)
+
+    Programmer's Note:
+        - Same double-double exponentiation (and exact 1 + r, F - 1, scalar fallback) as
+          the AVX2 path, using mask registers instead of blends and masked loads/stores for
+          the remainder.
+
+    Simpler Terms:
+        Prices eight loans in each CPU step using 512-bit registers.
+ */
+__attribute__((target("avx512f")))
+void monthlyPaymentsAvx512(const double* principal, const double* monthlyRate,
+                           const int32_t* paymentCount, double* monthlyPayment, size_t count) {
+    const int bits = exponentBits(paymentCount, count);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d zero = _mm512_setzero_pd();
+
+    for (size_t i = 0; i < count; i += 8) {
+        const size_t lanes = min<size_t>(8, count - i);
+        const __mmask8 active = static_cast<__mmask8>((1u << lanes) - 1);
+
+        const __m512d r = _mm512_maskz_loadu_pd(active, monthlyRate + i);
+        const __m512i exponent = _mm512_cvtepi32_epi64(
+            _mm512_castsi512_si256(_mm512_maskz_loadu_epi32(active, paymentCount + i)));
+
+        __m512d baseHi = _mm512_add_pd(one, r);
+        const __m512d rPart = _mm512_sub_pd(baseHi, one);
+        __m512d baseLo = _mm512_add_pd(_mm512_sub_pd(one, _mm512_sub_pd(baseHi, rPart)), _mm512_sub_pd(r, rPart));
+        __m512d powHi = one, powLo = zero;
+
+        for (int bit = 0; bit < bits; ++bit) {
+            const __mmask8 take = _mm512_test_epi64_mask(exponent, _mm512_set1_epi64(int64_t{1} << bit));
+
+            __m512d prod = _mm512_mul_pd(powHi, baseHi);
+            __m512d err = _mm512_fmsub_pd(powHi, baseHi, prod);
+            err = _mm512_fmadd_pd(powHi, baseLo, _mm512_fmadd_pd(powLo, baseHi, err));
+            const __m512d hi = _mm512_add_pd(prod, err);
+            const __m512d lo = _mm512_sub_pd(err, _mm512_sub_pd(hi, prod));
+            powHi = _mm512_mask_mov_pd(powHi, take, hi);
+            powLo = _mm512_mask_mov_pd(powLo, take, lo);
+
+            prod = _mm512_mul_pd(baseHi, baseHi);
+            err = _mm512_fmsub_pd(baseHi, baseHi, prod);
+            err = _mm512_fmadd_pd(_mm512_add_pd(baseHi, baseHi), baseLo, err);
+            baseHi = _mm512_add_pd(prod, err);
+            baseLo = _mm512_sub_pd(err, _mm512_sub_pd(baseHi, prod));
+        }
+
+        const __m512d power_factor = _mm512_add_pd(powHi, powLo);
+        const __m512d growth = _mm512_add_pd(_mm512_sub_pd(powHi, one), powLo);
+        const __m512d p = _mm512_maskz_loadu_pd(active, principal + i);
+        const __m512d numerator = _mm512_mul_pd(_mm512_mul_pd(p, r), power_factor);
+        const __m512d payment = _mm512_div_pd(numerator, growth);
+
+        const __mmask8 noPayments = _mm512_cmpeq_epi64_mask(exponent, _mm512_setzero_si512());
+        _mm512_mask_storeu_pd(monthlyPayment + i, active, _mm512_mask_mov_pd(payment, noPayments, zero));
+
+        const __m512i magnitude = _mm512_set1_epi64(INT64_MAX);
+        const __m512d absRate = _mm512_castsi512_pd(_mm512_and_epi64(_mm512_castpd_si512(r), magnitude));
+        const __m512d absPayment = _mm512_castsi512_pd(_mm512_and_epi64(_mm512_castpd_si512(payment), magnitude));
+        unsigned fallback = _mm512_mask_cmp_pd_mask(static_cast<__mmask8>(active & ~noPayments), absRate,
+                                                    _mm512_set1_pd(VECTOR_SMALL_RATE), _CMP_LT_OQ)
+                          | _mm512_mask_cmplt_epi64_mask(active, exponent, _mm512_setzero_si512())
+                          | _mm512_mask_cmp_pd_mask(static_cast<__mmask8>(active & ~noPayments), absPayment,
+                                                    _mm512_set1_pd(numeric_limits<double>::infinity()), _CMP_NLT_UQ);
+        while (fallback != 0) {
+            const size_t lane = i + static_cast<size_t>(countr_zero(fallback));
+            monthlyPayment[lane] = monthlyPaymentScalar(principal[lane], monthlyRate[lane], paymentCount[lane]);
+            fallback &= fallback - 1;
+        }
+    }
+}
+
+#endif // MORTGAGE_X86_DISPATCH
+
+} // namespace
+
+/*
+    Detect SIMD Level
+
+    Programmer's Note:
+        - Queries the CPU once; later calls return the cached answer.
+
+    Simpler Terms:
+        Checks which fast instructions this computer supports.
+ */
+SimdLevel detectSimdLevel() {
+#ifdef MORTGAGE_X86_DISPATCH
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return SimdLevel::Avx512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return SimdLevel::Avx2;
+        }
+        return SimdLevel::Scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+/*
+    SIMD Level Name
+
+    Programmer's Note:
+        - Short lowercase name used in benchmark and log output.
+
+    Simpler Terms:
+        Turns the SIMD level into readable text.
+ */
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Avx2:   return "avx2";
+        case SimdLevel::Avx512: return "avx512";
+        default:                return "scalar";
+    }
+}
+
+/*
+    Compute Monthly Payments
+
+    Programmer's Note:
+        - Dispatches to the requested kernel; a level the CPU (or build) does not support
+          falls back to the next narrower one.
+
+    Simpler Terms:
+        Picks the fastest available way to price the list of loans.
+ */
+void computeMonthlyPayments(const double* principal, const double* monthlyRate,
+                            const int32_t* paymentCount, double* monthlyPayment,
+                            size_t count, SimdLevel level) {
+    level = min(level, detectSimdLevel());
+
+#ifdef MORTGAGE_X86_DISPATCH
+    if (level == SimdLevel::Avx512) {
+        monthlyPaymentsAvx512(principal, monthlyRate, paymentCount, monthlyPayment, count);
+        return;
+    }
+    if (level == SimdLevel::Avx2) {
+        monthlyPaymentsAvx2(principal, monthlyRate, paymentCount, monthlyPayment, count);
+        return;
+    }
+#endif
+
+    monthlyPaymentsScalar(principal, monthlyRate, paymentCount, monthlyPayment, count);
+}
+
+/*
+    Compute Monthly Payments (Extended Precision)
+
+    Programmer's Note:
+        - One annuity_math::monthlyPaymentExtended per loan; no SIMD, it is for audits.
+
+    Simpler Terms:
+        Prices the list of loans the slow, exact way.
+ */
+void computeMonthlyPaymentsExtended(const double* principal, const double* monthlyRate,
+                                    const int32_t* paymentCount, double* monthlyPayment, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        monthlyPayment[i] = annuity_math::monthlyPaymentExtended(principal[i], monthlyRate[i], paymentCount[i]);
+    }
+}
@@ -0,0 +1,76 @@
+// Payment Kernels Specification
+
+#ifndef PAYMENT_KERNELS_H
+#define PAYMENT_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+    SIMD Level
+
+    Programmer's Note:
+        - Instruction sets the batch kernels can run on.
+        - detectSimdLevel() picks the widest one the current CPU supports at run time,
+          so one binary runs everywhere and still uses AVX-512 where available.
+        - Builds for other compilers/architectures always report Scalar.
+
+    Simpler Terms:
+        Which "many loans at once" CPU features this computer has.
+ */
+enum class SimdLevel {
+    Scalar,     // One loan at a time (identical to Mortgage::getMonthlyPayment)
+    Avx2,       // 4 loans per instruction (AVX2 + FMA)
+    Avx512      // 8 loans per instruction (AVX-512F)
+};
+
+SimdLevel detectSimdLevel();                    // Widest level supported by this CPU
+const char* simdLevelName(SimdLevel level);     // "scalar", "avx2" or "avx512"
+
+/*
+    Batch Monthly Payment Kernel
+
+    Programmer's Note:
+        - Evaluates the fixed-rate amortization formula  P * r * F / (F - 1),  F = (1 + r)^n
+          for 'count' loans stored as separate arrays (structure of arrays).
+        - Loans with n == 0 produce 0.0 and loans with r == 0 produce P / n, matching
+          Mortgage::getMonthlyPayment().
+        - The scalar path is annuity_math::paymentFactor, bit for bit Mortgage's.
+        - The vector paths compute F by binary exponentiation in double-double arithmetic
+          (FMA-exact products) from the exact sum 1 + r, and take F - 1 in double-double too,
+          so neither the rounding of 1 + r nor the cancellation in F - 1 costs accuracy. The
+          payment is within 4 ULP of computeMonthlyPaymentsExtended (mortgage_bench asserts
+          that bound on its portfolio and low-rate books; the scalar path measures 5).
+          Lanes with |r| < 1e-12, where even double-double F - 1 runs short of digits, and
+          lanes whose F or P r F overflows to inf are finished with the scalar factor.
+        - Arrays do not need any particular alignment, but LoanBook keeps them 64-byte aligned.
+
+    Simpler Terms:
+        Works out the monthly payment for a whole list of loans, several loans per CPU step.
+ */
+void computeMonthlyPayments(const double* principal, const double* monthlyRate,
+                            const std::int32_t* paymentCount, double* monthlyPayment,
+                            std::size_t count, SimdLevel level);
+
+/*
+    Extended-Precision Payments
+
+    Programmer's Note:
+        - The audit mode: annuity_math::monthlyPaymentExtended for each loan (double-double
+          arithmetic, correctly rounded), one loan at a time. Several times slower than
+          computeMonthlyPayments; the reference the fast paths are measured against.
+        - PaymentPrecision lets batch callers choose between the two.
+
+    Simpler Terms:
+        Works out the monthly payments the slow, exact way, for double-checking.
+ */
+enum class PaymentPrecision {
+    Fast,       // computeMonthlyPayments at the widest SIMD level
+    Extended    // computeMonthlyPaymentsExtended
+};
+
+void computeMonthlyPaymentsExtended(const double* principal, const double* monthlyRate,
+                                    const std::int32_t* paymentCount, double* monthlyPayment,
+                                    std::size_t count);
+
+#endif // PAYMENT_KERNELS_H
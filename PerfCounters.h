@@ -0,0 +1,124 @@
+// Performance Counters Specification
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+// Set by the MORTGAGE_PERF_COUNTERS CMake option; off by default
+#ifndef MORTGAGE_PERF_COUNTERS
+#define MORTGAGE_PERF_COUNTERS 0
+#endif
+
+/*
+    Performance Counters
+
+    Programmer's Note:
+        - Process-wide totals recorded by the library's batch entry points: loans priced,
+          schedule rows generated, bytes written, and wall time (ns) plus call count per phase.
+        - Recorded once per call of an entry point (a batch, an export, one schedule
+          printed by outputPaymentSchedule), never per row and never inside per-loan
+          helpers such as Mortgage::writePaymentSchedule, with relaxed atomics, so the cost
+          is a few nanoseconds per call even when enabled. Buffered writers add their bytes
+          per buffer flush or column array, not per row.
+        - When the library is built without MORTGAGE_PERF_COUNTERS, add() and ScopedTimer
+          compile to nothing and snapshot() reports all zeros with "enabled": false.
+        - Phases can nest (a batch stream also counts as pricing), so phase times are
+          not meant to be added together.
+
+    Simpler Terms:
+        Optional tallies of how much work the calculator did and how long each part took,
+        which can be printed as JSON to compare one release against another.
+ */
+namespace perf_counters {
+
+inline constexpr bool ENABLED = MORTGAGE_PERF_COUNTERS != 0;
+
+enum class Counter {
+    LoansPriced,        // Loans given a monthly payment by a batch path
+    RowsGenerated,      // Payment-schedule rows computed
+    BytesWritten,       // Bytes of schedule or batch output handed to a stream or file
+    BytesRead,          // Bytes of loan-tape input scanned
+    Count
+};
+
+enum class Phase {
+    Pricing,            // priceLoans / LoanBook::computeMonthlyPayments
+    BatchStream,        // priceLoanStream (parse + price + format)
+    ScheduleBuild,      // Portfolio schedule construction
+    ScheduleWrite,      // Text, binary and exported (ScheduleSink) schedule output
+    TapeIngest,         // loadLoanTape (map + parse + validate + load)
+    Count
+};
+
+inline constexpr std::size_t COUNTER_COUNT = static_cast<std::size_t>(Counter::Count);
+inline constexpr std::size_t PHASE_COUNT = static_cast<std::size_t>(Phase::Count);
+
+struct PhaseTotals {
+    std::uint64_t calls = 0;
+    std::uint64_t nanoseconds = 0;
+};
+
+struct Snapshot {
+    std::array<std::uint64_t, COUNTER_COUNT> counters{};
+    std::array<PhaseTotals, PHASE_COUNT> phases{};
+};
+
+// Out-of-line recorders (only called when ENABLED)
+void record(Counter counter, std::uint64_t amount);
+void recordPhase(Phase phase, std::uint64_t nanoseconds);
+
+inline void add(Counter counter, std::uint64_t amount) {
+    if constexpr (ENABLED) {
+        record(counter, amount);
+    }
+}
+
+/*
+    Class: ScopedTimer
+
+    Programmer's Note:
+        - Adds the lifetime of the object to 'phase'; reads the clock only when ENABLED.
+
+    Simpler Terms:
+        A stopwatch that starts when created and stops when the block ends.
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Phase timedPhase) : phase(timedPhase) {
+        if constexpr (ENABLED) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedTimer() {
+        if constexpr (ENABLED) {
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            recordPhase(phase, static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Phase phase;
+    std::chrono::steady_clock::time_point start{};
+};
+
+Snapshot snapshot();                // Current totals
+void reset();                       // Sets every total back to zero
+const char* counterName(Counter counter);
+const char* phaseName(Phase phase);
+
+// {"enabled":true,"counters":{"loans_priced":N,...},"phases":{"pricing":{"calls":N,"ns":N},...}}
+void writeJson(std::ostream& out);
+
+} // namespace perf_counters
+
+#endif // PERF_COUNTERS_H
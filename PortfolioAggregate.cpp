@@ -0,0 +1,263 @@
+// Portfolio Aggregate Class Implementation
+
+#include "PortfolioAggregate.h"
+#include "LoanTape.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+namespace {
+
+// A silent Mortgage with the record's terms, set through the usual setters
+Mortgage toMortgage(const LoanRecord& record) {
+    Mortgage loan(false);
+    loan.setLoanAmount(record.loan_amount);
+    loan.setAnnualInterestRate(record.annual_interest_rate);
+    loan.setTotalYearsToRepay(record.total_years_to_repay);
+    return loan;
+}
+
+size_t paymentCount(const LoanRecord& record) {
+    return static_cast<size_t>(max(0, record.total_years_to_repay * 12));
+}
+
+bool reportUnknown(PortfolioAggregate::LoanId id) {
+    cerr << "ERROR: No loan with id " << id << " in the portfolio." << endl;
+    return false;
+}
+
+// Whether a loan may enter the sums; prints the reason when it may not
+bool acceptLoan(const LoanRecord& record) {
+    const LoanCheck check = checkLoan(record);
+    if (check != LoanCheck::Valid) {
+        cerr << "ERROR: Invalid loan (" << loanCheckName(check) << ") not added to the portfolio." << endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+/*
+    Apply
+
+    Programmer's Note:
+        - Adds (sign = +1) or subtracts (sign = -1) one loan's schedule rows and totals.
+          Curves grow to the loan's term on add; trimMonths() shrinks them on removal.
+
+    Simpler Terms:
+        Puts one loan's numbers into the totals, or takes them back out.
+ */
+void PortfolioAggregate::apply(const LoanRecord& record, double sign) {
+    const Mortgage loan = toMortgage(record);
+    const size_t payments = paymentCount(record);
+
+    if (payments > cash_flow.size()) {
+        cash_flow.resize(payments, 0.0);
+        interest.resize(payments, 0.0);
+        principal.resize(payments, 0.0);
+        balance.resize(payments, 0.0);
+    }
+    if (payments >= loans_by_term.size()) {
+        loans_by_term.resize(payments + 1, 0);
+    }
+    if (sign > 0) {
+        ++loans_by_term[payments];
+    } else {
+        --loans_by_term[payments];
+    }
+
+    size_t month = 0;
+    double loanInterest = 0.0;
+    for (const PaymentRow& row : loan.schedule()) {
+        cash_flow[month] += sign * (row.interest + row.principal);
+        interest[month] += sign * row.interest;
+        principal[month] += sign * row.principal;
+        balance[month] += sign * row.remaining_balance;
+        loanInterest += row.interest;
+        ++month;
+    }
+
+    total_interest += sign * loanInterest;
+    total_payback += sign * loan.getTotalPayback();
+    total_principal += sign * record.loan_amount;
+    rate_weight += sign * record.loan_amount * record.annual_interest_rate;
+    term_weight += sign * record.loan_amount * static_cast<double>(payments);
+}
+
+/*
+    Trim Months
+
+    Programmer's Note:
+        - Drops trailing months that no active loan reaches any more (their sums would
+          otherwise hold only rounding residue).
+        - Once the last loan is gone the scalar totals are reset to exactly 0 for the same
+          reason: residue such as 2.6e-11 of principal would otherwise turn the weighted
+          averages into nonsense.
+
+    Simpler Terms:
+        Shortens the monthly totals when the longest loan leaves, and clears everything
+        when the portfolio is empty.
+ */
+void PortfolioAggregate::trimMonths() {
+    size_t terms = loans_by_term.size();
+    while (terms > 0 && loans_by_term[terms - 1] == 0) {
+        --terms;
+    }
+    loans_by_term.resize(terms);
+
+    const size_t months = terms == 0 ? 0 : terms - 1;    // Longest remaining payment count
+    if (months < cash_flow.size()) {
+        cash_flow.resize(months);
+        interest.resize(months);
+        principal.resize(months);
+        balance.resize(months);
+    }
+
+    if (active_count == 0) {
+        total_interest = 0.0;
+        total_payback = 0.0;
+        total_principal = 0.0;
+        rate_weight = 0.0;
+        term_weight = 0.0;
+    }
+}
+
+/*
+    Add / Remove
+
+    Programmer's Note:
+        - O(term) each; removal subtracts the schedule the loan currently has.
+        - A loan that fails checkLoan is never stored, so it never reaches the sums.
+
+    Simpler Terms:
+        Puts a loan into the portfolio or takes it out.
+ */
+PortfolioAggregate::LoanId PortfolioAggregate::addLoan(double amount, double annualRatePercent, int years) {
+    if (!acceptLoan({ amount, annualRatePercent, years, 0 })) {
+        return INVALID_LOAN;
+    }
+
+    LoanId id;
+    if (!free_ids.empty()) {
+        id = free_ids.back();
+        free_ids.pop_back();
+    } else {
+        id = slots.size();
+        slots.emplace_back();
+    }
+
+    slots[id] = { { amount, annualRatePercent, years, 0 }, true };
+    ++active_count;
+    apply(slots[id].record, 1.0);
+    return id;
+}
+
+bool PortfolioAggregate::removeLoan(LoanId id) {
+    if (!contains(id)) {
+        return reportUnknown(id);
+    }
+
+    apply(slots[id].record, -1.0);
+    slots[id].active = false;
+    free_ids.push_back(id);
+    --active_count;
+    trimMonths();
+    return true;
+}
+
+/*
+    Setters
+
+    Programmer's Note:
+        - Subtract the loan's current schedule, change the one term, add the new schedule.
+        - The changed terms are checked first; an invalid change leaves the loan as it was.
+
+    Simpler Terms:
+        Changes one thing about a loan and updates the totals to match.
+ */
+template <typename Change>
+bool PortfolioAggregate::modify(LoanId id, Change&& change) {
+    if (!contains(id)) {
+        return reportUnknown(id);
+    }
+
+    LoanRecord changed = slots[id].record;
+    change(changed);
+    if (!acceptLoan(changed)) {
+        return false;
+    }
+
+    apply(slots[id].record, -1.0);
+    slots[id].record = changed;
+    apply(slots[id].record, 1.0);
+    trimMonths();
+    return true;
+}
+
+bool PortfolioAggregate::setLoanAmount(LoanId id, double amount) {
+    return modify(id, [amount](LoanRecord& record) { record.loan_amount = amount; });
+}
+
+bool PortfolioAggregate::setAnnualInterestRate(LoanId id, double rate) {
+    return modify(id, [rate](LoanRecord& record) { record.annual_interest_rate = rate; });
+}
+
+bool PortfolioAggregate::setTotalYearsToRepay(LoanId id, int years) {
+    return modify(id, [years](LoanRecord& record) { record.total_years_to_repay = years; });
+}
+
+/*
+    Rebuild
+
+    Programmer's Note:
+        - Clears every sum and adds the active loans back in id order.
+
+    Simpler Terms:
+        Recalculates the totals from nothing, for example once a night.
+ */
+void PortfolioAggregate::rebuild() {
+    loans_by_term.clear();
+    cash_flow.clear();
+    interest.clear();
+    principal.clear();
+    balance.clear();
+    total_interest = 0.0;
+    total_payback = 0.0;
+    total_principal = 0.0;
+    rate_weight = 0.0;
+    term_weight = 0.0;
+
+    for (const Slot& slot : slots) {
+        if (slot.active) {
+            apply(slot.record, 1.0);
+        }
+    }
+    trimMonths();
+}
+
+bool PortfolioAggregate::contains(LoanId id) const {
+    return id < slots.size() && slots[id].active;
+}
+
+const LoanRecord& PortfolioAggregate::loan(LoanId id) const {
+    return slots[id].record;
+}
+
+/*
+    Weighted Averages
+
+    Programmer's Note:
+        - Weighted by loan amount; 0 for an empty portfolio (or one whose amounts sum to 0).
+
+    Simpler Terms:
+        The portfolio's typical rate and term, with bigger loans counting for more.
+ */
+double PortfolioAggregate::weightedAverageRate() const {
+    return active_count != 0 && total_principal != 0.0 ? rate_weight / total_principal : 0.0;
+}
+
+double PortfolioAggregate::weightedAverageTerm() const {
+    return active_count != 0 && total_principal != 0.0 ? term_weight / total_principal : 0.0;
+}
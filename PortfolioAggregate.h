@@ -0,0 +1,101 @@
+// Portfolio Aggregate Class Specification
+
+#ifndef PORTFOLIO_AGGREGATE_H
+#define PORTFOLIO_AGGREGATE_H
+
+#include "BatchPricer.h"
+#include "Mortgage.h"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/*
+    Class: PortfolioAggregate
+
+    Programmer's Note:
+        - Running portfolio totals that follow a changing book: monthly curves (scheduled
+          cash flow, interest, principal, outstanding balance; indexed by month - 1 up to
+          the longest loan), total interest / payback / principal, and principal-weighted
+          average rate and term.
+        - Every change touches only the loan being changed: its old schedule is subtracted
+          and its new one added, O(term) instead of O(portfolio x term). The setters mirror
+          Mortgage's (same units) and a loan's rows are exactly Mortgage::schedule()'s.
+        - Loan ids are handed out by addLoan and stay valid until removeLoan; removed ids
+          are reused. Unknown ids give an ERROR line and false.
+        - Loans are checked with checkLoan (LoanTape.h) before they touch the sums: a NaN
+          or infinite term would poison every running total until rebuild(). An invalid
+          loan gives an ERROR line; addLoan then returns INVALID_LOAN and a setter returns
+          false, and the portfolio is left unchanged.
+        - The sums are plain doubles, so a long run of changes leaves rounding residue
+          (~1e-16 of the largest value involved per change). rebuild() recomputes
+          everything from the current loans, in id order; right after it (or after adding
+          loans only) the curves are the plain loan-by-loan sums. buildPortfolioSchedules
+          adds the same rows in blocks of loans, so the two agree to rounding (~1e-15
+          relative), not bit for bit.
+          Months past the longest remaining loan are dropped, so they never keep residue,
+          and removing the last loan resets every total to exactly 0 (the weighted averages
+          are 0 for an empty portfolio).
+
+    Simpler Terms:
+        Keeps the whole portfolio's totals up to date as loans come, go or change, without
+        recalculating every loan each time.
+ */
+class PortfolioAggregate {
+public:
+    using LoanId = std::size_t;
+    static constexpr LoanId INVALID_LOAN = static_cast<LoanId>(-1);    // addLoan's answer to an invalid loan
+
+    LoanId addLoan(double amount, double annualRatePercent, int years);
+    bool removeLoan(LoanId id);
+
+    bool setLoanAmount(LoanId id, double amount);
+    bool setAnnualInterestRate(LoanId id, double rate);
+    bool setTotalYearsToRepay(LoanId id, int years);
+
+    void rebuild();                                         // Recompute from scratch (drops residue)
+
+    [[nodiscard]] bool contains(LoanId id) const;
+    [[nodiscard]] const LoanRecord& loan(LoanId id) const;  // Terms of a loan that contains(id)
+    [[nodiscard]] std::size_t loanCount() const { return active_count; }
+    [[nodiscard]] std::size_t months() const { return cash_flow.size(); }
+
+    [[nodiscard]] std::span<const double> cashFlowByMonth() const { return cash_flow; }
+    [[nodiscard]] std::span<const double> interestByMonth() const { return interest; }
+    [[nodiscard]] std::span<const double> principalByMonth() const { return principal; }
+    [[nodiscard]] std::span<const double> balanceByMonth() const { return balance; }
+
+    [[nodiscard]] double totalInterest() const { return total_interest; }
+    [[nodiscard]] double totalPayback() const { return total_payback; }      // Sum of getTotalPayback()
+    [[nodiscard]] double totalPrincipal() const { return total_principal; }  // Sum of loan amounts
+    [[nodiscard]] double weightedAverageRate() const;       // Annual percent, weighted by amount
+    [[nodiscard]] double weightedAverageTerm() const;       // Months, weighted by amount
+
+private:
+    struct Slot {
+        LoanRecord record{};
+        bool active = false;
+    };
+
+    template <typename Change>
+    bool modify(LoanId id, Change&& change);
+    void apply(const LoanRecord& record, double sign);
+    void trimMonths();
+
+    std::vector<Slot> slots;
+    std::vector<LoanId> free_ids;
+    std::size_t active_count = 0;
+    std::vector<std::size_t> loans_by_term;     // Active loans per payment count
+
+    std::vector<double> cash_flow;
+    std::vector<double> interest;
+    std::vector<double> principal;
+    std::vector<double> balance;
+
+    double total_interest = 0.0;
+    double total_payback = 0.0;
+    double total_principal = 0.0;
+    double rate_weight = 0.0;                   // Sum of amount * annual rate
+    double term_weight = 0.0;                   // Sum of amount * payments
+};
+
+#endif // PORTFOLIO_AGGREGATE_H
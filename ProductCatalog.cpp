@@ -0,0 +1,91 @@
+// Product Catalog Compile-Time Checks
+
+#include "ProductCatalog.h"
+#include <array>
+#include <ranges>
+
+/*
+    Compile-Time Checks
+
+    Programmer's Note:
+        - Everything below is evaluated by the compiler; a wrong value fails the build.
+        - Checks powInt, the double-double helpers, the constexpr Mortgage path (against the sample schedule in
+          mortgage.txt), constexpr schedule generation, and the catalog table.
+        - The run-time comparison (table vs std::pow path) is in mortgage_bench.
+
+    Simpler Terms:
+        The compiler double-checks the built-in price list every time the program is built.
+ */
+namespace {
+
+// Rounds a non-negative dollar amount to whole cents
+constexpr long long toCents(double dollars) {
+    return static_cast<long long>(dollars * 100.0 + 0.5);
+}
+
+// Loan with the given amount, rate (percent) and term, built at compile time
+constexpr Mortgage makeLoan(double amount, double rate, int years) {
+    Mortgage loan(false);
+    loan.setLoanAmount(amount);
+    loan.setAnnualInterestRate(rate);
+    loan.setTotalYearsToRepay(years);
+    return loan;
+}
+
+// First or last row of the 30-year sample schedule from mortgage.txt
+constexpr PaymentRow sampleScheduleRow(int index) {
+    const Mortgage loan = makeLoan(250000.0, 4.75, 30);
+    std::array<PaymentRow, 360> rows{};
+    loan.fillPaymentSchedule(rows);
+    return rows[static_cast<std::size_t>(index)];
+}
+
+// powInt on exactly representable cases
+static_assert(constexpr_math::powInt(2.0, 10) == 1024.0);
+static_assert(constexpr_math::powInt(1.5, -2) == 1.0 / 2.25);
+static_assert(constexpr_math::powInt(1.0000001, 0) == 1.0);
+
+// Sample loan: Monthly Payment $1304.12, Total Pay Back $469482.60
+static_assert(toCents(makeLoan(250000.0, 4.75, 30).getMonthlyPayment()) == 130412);
+static_assert(toCents(makeLoan(250000.0, 4.75, 30).getTotalPayback()) == 46948260);
+
+// A zero rate repays the principal in equal parts; a zero term prices to zero, as at run time
+static_assert(toCents(makeLoan(250000.0, 0.0, 30).getMonthlyPayment()) == 69444);
+static_assert(makeLoan(250000.0, 4.75, 0).getMonthlyPayment() == 0.0);
+
+// Double-double helpers: 1/3 carries its rounding error, and the tiny-rate limit is 1/n
+static_assert(constexpr_math::divide({ 1.0, 0.0 }, { 3.0, 0.0 }).hi == 1.0 / 3.0);
+static_assert(constexpr_math::divide({ 1.0, 0.0 }, { 3.0, 0.0 }).lo != 0.0);
+static_assert(annuity_math::paymentFactorExtended(1e-12, 360) > 1.0 / 360);
+static_assert(annuity_math::paymentFactorExtended(0.0, 360) == 1.0 / 360);
+
+// Schedule rows: payment 1 interest $989.58, principal $314.54; payment 360 leaves $0.00
+static_assert(toCents(sampleScheduleRow(0).interest) == 98958);
+static_assert(toCents(sampleScheduleRow(0).principal) == 31454);
+static_assert(toCents(sampleScheduleRow(359).remaining_balance) == 0);
+
+// The lazy schedule is a sized forward view that composes with std::views
+static_assert(std::ranges::view<ScheduleRange> && std::ranges::forward_range<ScheduleRange>);
+static_assert(std::ranges::sized_range<ScheduleRange>);
+static_assert(std::ranges::distance(makeLoan(250000.0, 4.75, 30).schedule() | std::views::drop(300)) == 60);
+static_assert(toCents([] {
+    auto lastRow = makeLoan(250000.0, 4.75, 30).schedule() | std::views::drop(359);
+    return (*lastRow.begin()).remaining_balance;
+}()) == 0);
+
+// Catalog lookups agree with the constexpr Mortgage path to the cent
+static_assert(StandardProductCatalog::contains(38, 30));
+static_assert(!StandardProductCatalog::contains(38, 25));
+static_assert(!StandardProductCatalog::contains(200, 30));
+static_assert(toCents(StandardProductCatalog::monthlyPayment(250000.0, 38, 30)) == 130412);
+static_assert(toCents(StandardProductCatalog::monthlyPayment(400000.0, 49, 30))
+              == toCents(makeLoan(400000.0, 6.125, 30).getMonthlyPayment()));
+static_assert(toCents(StandardProductCatalog::monthlyPayment(1000000.0, 8, 10))
+              == toCents(makeLoan(1000000.0, 1.0, 10).getMonthlyPayment()));
+static_assert(toCents(StandardProductCatalog::monthlyPayment(75000.0, 160, 40))
+              == toCents(makeLoan(75000.0, 20.0, 40).getMonthlyPayment()));
+
+// The per-dollar factor is exactly a one-dollar constexpr Mortgage
+static_assert(StandardProductCatalog::paymentFactor(57, 15) == makeLoan(1.0, 7.125, 15).getMonthlyPayment());
+
+} // namespace
@@ -0,0 +1,22 @@
+// Product Catalog Specification
+
+#ifndef PRODUCT_CATALOG_H
+#define PRODUCT_CATALOG_H
+
+#include "PaymentFactorTable.h"
+
+/*
+    Standard Product Catalog
+
+    Programmer's Note:
+        - The fixed-rate products we quote: 10/15/20/30/40-year terms,
+          annual rates 1.000% to 20.000% in 1/8-point steps.
+        - Payment factors are computed at compile time; ProductCatalog.cpp holds the
+          static_assert checks against the constexpr Mortgage path.
+
+    Simpler Terms:
+        The list of loan products, with their payments worked out ahead of time.
+ */
+using StandardProductCatalog = PaymentFactorTable<8, 160, 10, 15, 20, 30, 40>;
+
+#endif // PRODUCT_CATALOG_H
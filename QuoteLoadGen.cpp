@@ -0,0 +1,303 @@
+/*
+    Program     : Quote Load Generator (quote_loadgen)
+
+    Description:
+        Drives a running quote server (Lab13aMortgage --serve <socket>) with
+        pipelined requests from several connections and reports throughput,
+        client-side latency percentiles, and any reply that does not match
+        the batch pricer:
+
+            quote_loadgen <socket> [--connections N] [--depth D] [--seconds S]
+
+        Linux only (Unix domain sockets).
+*/
+
+#include "BatchPricer.h"
+#include "QuoteServer.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+/*
+    Struct: LoadResult
+
+    Programmer's Note:
+        - What one connection saw; merged across connections at the end.
+
+    Simpler Terms:
+        The tally for one simulated client.
+ */
+struct LoadResult {
+    uint64_t replies = 0;
+    uint64_t mismatches = 0;
+    LatencyHistogram latency;
+    bool failed = false;
+};
+
+/*
+    Function: makeRequestPool
+
+    Programmer's Note:
+        - 4096 reproducible loans (same ranges as mortgage_bench) and their expected quotes
+          from priceLoans. Request i uses loan i % 4096.
+
+    Simpler Terms:
+        The made-up loans the clients ask about, with the answers they should get back.
+ */
+static void makeRequestPool(vector<LoanRecord>& loans, vector<LoanQuote>& expected) {
+    mt19937_64 rng(12345);
+    uniform_real_distribution<double> amount(50'000.0, 1'500'000.0);
+    uniform_int_distribution<int> eighths(16, 80);
+    const int terms[] = { 10, 15, 20, 30, 40 };
+
+    loans.resize(4096);
+    for (LoanRecord& loan : loans) {
+        loan = { amount(rng), eighths(rng) / 8.0, terms[rng() % 5], 0 };
+    }
+    expected.resize(loans.size());
+    priceLoans(loans, expected);
+}
+
+/*
+    Function: connectTo
+
+    Programmer's Note:
+        - Blocking Unix-socket connection; returns -1 after printing an ERROR line.
+
+    Simpler Terms:
+        Opens a line to the quote server.
+ */
+static int connectTo(const string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        cerr << "ERROR: Socket path is too long." << endl;
+        return -1;
+    }
+    copy(path.begin(), path.end(), address.sun_path);
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+        cerr << "ERROR: Could not connect to " << path << ": " << strerror(errno) << endl;
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+// Writes all of 'size' bytes; false if the connection failed
+static bool sendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        const ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+// Same value to within the batch kernel's few-ULP difference from Mortgage (see PaymentKernels.h)
+static bool sameQuote(const LoanQuote& a, const LoanQuote& b) {
+    return fabs(a.monthly_payment - b.monthly_payment) <= 1e-12 * fabs(b.monthly_payment)
+        && fabs(a.total_payback - b.total_payback) <= 1e-12 * fabs(b.total_payback);
+}
+
+/*
+    Function: runConnection
+
+    Programmer's Note:
+        - Keeps 'depth' requests in flight: sends a full window, then sends one new request
+          (written together, per read) for every reply that comes back, until the deadline;
+          then waits for the outstanding replies.
+        - Request ids count up per connection, so id % depth names a free send-time slot.
+        - Latency is from the send() of a request's window to the read() that completed
+          its reply.
+
+    Simpler Terms:
+        One simulated client asking questions as fast as the server answers them.
+ */
+static void runConnection(const string& path, size_t depth, Clock::time_point deadline,
+                          const vector<LoanRecord>& loans, const vector<LoanQuote>& expected, LoadResult& result) {
+    const int fd = connectTo(path);
+    if (fd < 0) {
+        result.failed = true;
+        return;
+    }
+
+    vector<Clock::time_point> sentAt(depth);
+    vector<QuoteRequest> outgoing;
+    vector<char> input;
+    char chunk[64 * 1024];
+    uint64_t nextId = 0;
+    uint64_t outstanding = 0;
+
+    const auto sendRequests = [&](size_t count) {
+        outgoing.clear();
+        const Clock::time_point now = Clock::now();
+        for (size_t i = 0; i < count; ++i, ++nextId) {
+            outgoing.push_back({ nextId, loans[nextId % loans.size()] });
+            sentAt[nextId % depth] = now;
+        }
+        outstanding += count;
+        return sendAll(fd, reinterpret_cast<const char*>(outgoing.data()), outgoing.size() * sizeof(QuoteRequest));
+    };
+
+    bool ok = sendRequests(depth);
+    while (ok && outstanding > 0) {
+        const ssize_t received = read(fd, chunk, sizeof(chunk));
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            ok = false;
+            break;
+        }
+
+        const Clock::time_point now = Clock::now();
+        input.insert(input.end(), chunk, chunk + received);
+        const size_t complete = input.size() / sizeof(QuoteReply);
+        for (size_t i = 0; i < complete; ++i) {
+            QuoteReply reply;
+            memcpy(&reply, input.data() + i * sizeof(QuoteReply), sizeof(reply));
+            result.latency.record(static_cast<uint64_t>(
+                chrono::duration_cast<chrono::nanoseconds>(now - sentAt[reply.id % depth]).count()));
+            if (!sameQuote(reply.quote, expected[reply.id % loans.size()])) {
+                ++result.mismatches;
+            }
+        }
+        input.erase(input.begin(), input.begin() + static_cast<ptrdiff_t>(complete * sizeof(QuoteReply)));
+        result.replies += complete;
+        outstanding -= complete;
+
+        if (complete > 0 && now < deadline) {
+            ok = sendRequests(complete);
+        }
+    }
+
+    if (!ok) {
+        cerr << "ERROR: Connection to the quote server was lost." << endl;
+        result.failed = true;
+    }
+    close(fd);
+}
+
+/*
+    Function: parseArgument
+
+    Programmer's Note:
+        - Parses a whole command-line value with std::from_chars; false for empty text,
+          trailing characters or a value out of range.
+
+    Simpler Terms:
+        Reads a number typed on the command line, and says so if it isn't one.
+ */
+template <typename T>
+static bool parseArgument(const char* text, T& value) {
+    const char* last = text + strlen(text);
+    const auto [end, error] = from_chars(text, last, value);
+    return error == errc() && end == last;
+}
+
+/*
+    Function: main
+
+    Programmer's Note:
+        - Defaults: 4 connections, 64 requests in flight on each, 5 seconds.
+        - Exit status 1 if a connection failed or any reply was wrong.
+
+    Simpler Terms:
+        Starts the simulated clients and prints how the server did.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "ERROR: usage: quote_loadgen <socket> [--connections N] [--depth D] [--seconds S]" << endl;
+        return 1;
+    }
+
+    const string path = argv[1];
+    size_t connections = 4;
+    size_t depth = 64;
+    double seconds = 5.0;
+    for (int arg = 2; arg < argc; ++arg) {
+        const string option = argv[arg];
+        if (arg + 1 >= argc) {
+            cerr << "ERROR: missing value for " << option << "." << endl;
+            cerr << "ERROR: usage: quote_loadgen <socket> [--connections N] [--depth D] [--seconds S]" << endl;
+            return 1;
+        }
+
+        const char* value = argv[++arg];
+        bool valid = false;
+        if (option == "--connections") {
+            valid = parseArgument(value, connections);
+            connections = max<size_t>(1, connections);
+        } else if (option == "--depth") {
+            valid = parseArgument(value, depth);
+            depth = max<size_t>(1, depth);
+        } else if (option == "--seconds") {
+            valid = parseArgument(value, seconds) && seconds >= 0.0 && seconds <= 1e6;
+        } else {
+            cerr << "ERROR: unrecognized option " << option << "." << endl;
+            return 1;
+        }
+
+        if (!valid) {
+            cerr << "ERROR: usage: quote_loadgen <socket> [--connections N] [--depth D] [--seconds S]" << endl;
+            return 1;
+        }
+    }
+
+    vector<LoanRecord> loans;
+    vector<LoanQuote> expected;
+    makeRequestPool(loans, expected);
+
+    vector<LoadResult> results(connections);
+    vector<thread> clients;
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point deadline = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(seconds));
+    for (size_t c = 0; c < connections; ++c) {
+        clients.emplace_back(runConnection, cref(path), depth, deadline, cref(loans), cref(expected), ref(results[c]));
+    }
+    for (thread& client : clients) {
+        client.join();
+    }
+    const double elapsed = chrono::duration<double>(Clock::now() - start).count();
+
+    LoadResult total;
+    for (const LoadResult& result : results) {
+        total.replies += result.replies;
+        total.mismatches += result.mismatches;
+        total.latency.merge(result.latency);
+        total.failed = total.failed || result.failed;
+    }
+
+    printf("connections %zu, depth %zu, %.1f s\n", connections, depth, elapsed);
+    printf("replies %llu, %.0f/s, mismatches %llu\n", static_cast<unsigned long long>(total.replies),
+           static_cast<double>(total.replies) / elapsed, static_cast<unsigned long long>(total.mismatches));
+    printf("latency p50 %.1f us, p99 %.1f us, max %.1f us\n", total.latency.percentileMicros(50.0),
+           total.latency.percentileMicros(99.0), total.latency.maxMicros());
+    return total.failed || total.mismatches > 0 ? 1 : 0;
+}
@@ -0,0 +1,602 @@
+// Quote Server Implementation
+
+#include "QuoteServer.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#ifdef __linux__
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr size_t MAX_EVENTS = 256;                          // Events taken per epoll round
+constexpr size_t READ_CHUNK = 64 * 1024;                    // Bytes read per readable event
+constexpr size_t MAX_OUTPUT_BACKLOG = size_t{ 1 } << 20;    // Unsent bytes before reads pause
+
+/*
+    Is Quotable
+
+    Programmer's Note:
+        - Rejects values the kernel would turn into nonsense (NaN, negative amounts) and
+          terms whose payment count could overflow.
+
+    Simpler Terms:
+        Checks that a requested loan makes sense before pricing it.
+ */
+bool isQuotable(const LoanRecord& loan) {
+    return isfinite(loan.loan_amount) && loan.loan_amount >= 0.0
+        && isfinite(loan.annual_interest_rate) && loan.annual_interest_rate >= 0.0
+        && loan.total_years_to_repay >= 1 && loan.total_years_to_repay <= 100;
+}
+
+/*
+    Print Stats
+
+    Programmer's Note:
+        - One INFO line on cerr; used for the periodic report and the final totals.
+
+    Simpler Terms:
+        Shows how busy and how fast the server has been.
+ */
+void printStats(const char* label, const QuoteServerStats& stats) {
+    char line[256];
+    snprintf(line, sizeof(line),
+             "INFO: %s: %llu requests in %.1f s (%.0f/s), %llu batches (largest %zu), "
+             "latency p50 %.1f us, p99 %.1f us, max %.1f us",
+             label, static_cast<unsigned long long>(stats.requests), stats.seconds, stats.qps,
+             static_cast<unsigned long long>(stats.batches), stats.largest_batch,
+             stats.p50_micros, stats.p99_micros, stats.max_micros);
+    cerr << line << endl;
+}
+
+// Fills the rate and latency fields of 'stats' from its request count and a histogram
+void summarize(QuoteServerStats& stats, double seconds, const LatencyHistogram& latency) {
+    stats.seconds = seconds;
+    stats.qps = seconds > 0.0 ? static_cast<double>(stats.requests) / seconds : 0.0;
+    stats.p50_micros = latency.percentileMicros(50.0);
+    stats.p99_micros = latency.percentileMicros(99.0);
+    stats.max_micros = latency.maxMicros();
+}
+
+#ifdef __linux__
+bool reportSystemError(const string& what) {
+    cerr << "ERROR: " << what << ": " << strerror(errno) << endl;
+    return false;
+}
+#endif
+
+} // namespace
+
+/*
+    Latency Histogram
+
+    Programmer's Note:
+        - Index: values below 16 map to themselves; otherwise the power of two selects a
+          group of 16 buckets and the next four bits below the leading one select the bucket.
+
+    Simpler Terms:
+        Sorts each measured time into a small range and counts it there.
+ */
+size_t LatencyHistogram::bucketIndex(uint64_t nanoseconds) {
+    constexpr uint64_t linear = uint64_t{ 1 } << SUB_BUCKET_BITS;
+    if (nanoseconds < linear) {
+        return static_cast<size_t>(nanoseconds);
+    }
+    const int exponent = bit_width(nanoseconds) - 1;
+    const uint64_t sub = (nanoseconds >> (exponent - SUB_BUCKET_BITS)) & (linear - 1);
+    return (static_cast<size_t>(exponent - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS) + static_cast<size_t>(sub);
+}
+
+uint64_t LatencyHistogram::bucketUpperEdge(size_t index) {
+    constexpr size_t linear = size_t{ 1 } << SUB_BUCKET_BITS;
+    if (index < linear) {
+        return index;
+    }
+    const int shift = static_cast<int>(index >> SUB_BUCKET_BITS) - 1;
+    const uint64_t lower = static_cast<uint64_t>(linear + (index & (linear - 1))) << shift;
+    return lower + ((uint64_t{ 1 } << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    ++buckets[bucketIndex(nanoseconds)];
+    ++total;
+    largest = max(largest, nanoseconds);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    total += other.total;
+    largest = max(largest, other.largest);
+}
+
+void LatencyHistogram::reset() {
+    buckets.fill(0);
+    total = 0;
+    largest = 0;
+}
+
+double LatencyHistogram::percentileMicros(double percent) const {
+    if (total == 0) {
+        return 0.0;
+    }
+    const uint64_t rank = max<uint64_t>(1, static_cast<uint64_t>(ceil(percent / 100.0 * static_cast<double>(total))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return static_cast<double>(min(bucketUpperEdge(i), largest)) / 1000.0;
+        }
+    }
+    return maxMicros();
+}
+
+QuoteServer::QuoteServer(QuoteServerConfig settings) : config(move(settings)) {
+    config.max_batch = max<size_t>(config.max_batch, 1);
+}
+
+QuoteServer::~QuoteServer() {
+#ifdef __linux__
+    for (auto& [fd, connection] : connections) {
+        ::close(fd);
+    }
+    if (listen_fd >= 0) {
+        ::close(listen_fd);
+        ::unlink(config.socket_path.c_str());
+    }
+    if (epoll_fd >= 0) {
+        ::close(epoll_fd);
+    }
+    if (stop_fd >= 0) {
+        ::close(stop_fd);
+    }
+#endif
+}
+
+QuoteServerStats QuoteServer::stats() const {
+    QuoteServerStats result = totals;
+    summarize(result, chrono::duration<double>(Clock::now() - started).count(), total_latency);
+    return result;
+}
+
+/*
+    Report Interval
+
+    Programmer's Note:
+        - Prints the interval's numbers and starts a new interval.
+
+    Simpler Terms:
+        The periodic "how is it going" line.
+ */
+void QuoteServer::reportInterval(Clock::time_point now) {
+    QuoteServerStats interval;
+    interval.requests = interval_requests;
+    interval.batches = interval_batches;
+    interval.largest_batch = interval_largest_batch;
+    summarize(interval, chrono::duration<double>(now - interval_started).count(), interval_latency);
+    printStats("quote server", interval);
+
+    interval_started = now;
+    interval_requests = 0;
+    interval_batches = 0;
+    interval_largest_batch = 0;
+    interval_latency.reset();
+}
+
+/*
+    Price Batch
+
+    Programmer's Note:
+        - Loads pending[first, last) into the reusable LoanBook, prices them with one kernel
+          call, and appends each reply to its connection's output. Total payback is
+          payment * months, exactly as priceLoans computes it.
+        - Requests that fail isQuotable() are priced as a placeholder and answered with NaN.
+
+    Simpler Terms:
+        Works out the answers for a group of questions in one go.
+ */
+void QuoteServer::priceBatch(size_t first, size_t last) {
+    book.clear();
+    for (size_t i = first; i < last; ++i) {
+        const LoanRecord& loan = pending[i].request.loan;
+        if (isQuotable(loan)) {
+            book.addLoan(loan.loan_amount, loan.annual_interest_rate, loan.total_years_to_repay);
+        } else {
+            book.addLoan(0.0, 0.0, 1);
+        }
+    }
+
+    payments.resize(book.size());
+    book.computeMonthlyPayments(payments);
+
+    for (size_t i = first; i < last; ++i) {
+        const QuoteRequest& request = pending[i].request;
+        QuoteReply reply{ request.id, { numeric_limits<double>::quiet_NaN(), numeric_limits<double>::quiet_NaN() } };
+        if (isQuotable(request.loan)) {
+            const double monthly_payment = payments[i - first];
+            reply.quote = { monthly_payment, monthly_payment * (request.loan.total_years_to_repay * 12) };
+        }
+
+        Connection* connection = pending[i].connection;
+        const char* bytes = reinterpret_cast<const char*>(&reply);
+        connection->output.insert(connection->output.end(), bytes, bytes + sizeof(reply));
+        if (touched.empty() || touched.back() != connection) {
+            touched.push_back(connection);
+        }
+    }
+
+    ++totals.batches;
+    ++interval_batches;
+    totals.largest_batch = max(totals.largest_batch, last - first);
+    interval_largest_batch = max(interval_largest_batch, last - first);
+}
+
+#ifdef __linux__
+
+/*
+    Open
+
+    Programmer's Note:
+        - Non-blocking listening socket, an epoll instance, and an eventfd that
+          requestStop() writes to so a blocked epoll_wait wakes up.
+
+    Simpler Terms:
+        Opens the "front door" other programs connect to.
+ */
+bool QuoteServer::open() {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (config.socket_path.empty() || config.socket_path.size() >= sizeof(address.sun_path)) {
+        cerr << "ERROR: Invalid socket path \"" << config.socket_path << "\"." << endl;
+        return false;
+    }
+    copy(config.socket_path.begin(), config.socket_path.end(), address.sun_path);
+
+    listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        return reportSystemError("Could not create socket");
+    }
+    ::unlink(config.socket_path.c_str());   // Replace a socket left by an earlier run
+    if (::bind(listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+        return reportSystemError("Could not bind " + config.socket_path);
+    }
+    if (::listen(listen_fd, SOMAXCONN) < 0) {
+        return reportSystemError("Could not listen on " + config.socket_path);
+    }
+
+    epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    stop_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd < 0 || stop_fd < 0) {
+        return reportSystemError("Could not create the event loop");
+    }
+
+    for (int fd : { listen_fd, stop_fd }) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            return reportSystemError("Could not watch the listening socket");
+        }
+    }
+    return true;
+}
+
+void QuoteServer::requestStop() {
+    if (stop_fd >= 0) {
+        const uint64_t one = 1;
+        [[maybe_unused]] const ssize_t written = ::write(stop_fd, &one, sizeof(one));
+    }
+}
+
+/*
+    Run
+
+    Programmer's Note:
+        - One round: wait for events, accept new connections, read every readable
+          connection once (at most 64 KiB, so no client can starve the others), write to
+          writable ones, then price everything read in the round (priceRound) and close
+          connections that failed, or that hung up and have no replies left to send.
+        - The wait is bounded only by the next stats report, so an idle server sleeps.
+
+    Simpler Terms:
+        The server's main loop: wait for questions, answer them, repeat.
+ */
+bool QuoteServer::run() {
+    if (epoll_fd < 0) {
+        cerr << "ERROR: The quote server must be opened before it can run." << endl;
+        return false;
+    }
+
+    const auto interval = chrono::duration_cast<Clock::duration>(chrono::duration<double>(config.stats_interval_seconds));
+    started = Clock::now();
+    interval_started = started;
+    epoll_event events[MAX_EVENTS];
+    bool stopping = false;
+
+    while (!stopping) {
+        int timeout = -1;
+        if (config.stats_interval_seconds > 0.0) {
+            const auto remaining = interval_started + interval - Clock::now();
+            timeout = static_cast<int>(max<int64_t>(0, chrono::ceil<chrono::milliseconds>(remaining).count()));
+        }
+
+        const int ready = ::epoll_wait(epoll_fd, events, static_cast<int>(MAX_EVENTS), timeout);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return reportSystemError("epoll_wait failed");
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == stop_fd) {
+                stopping = true;
+                continue;
+            }
+            if (fd == listen_fd) {
+                acceptConnections();
+                continue;
+            }
+
+            const auto found = connections.find(fd);
+            if (found == connections.end()) {
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                readRequests(*found->second);
+            }
+            if (events[i].events & EPOLLOUT) {
+                writeReplies(*found->second);
+            }
+        }
+
+        priceRound();
+
+        vector<int> closed;
+        for (const auto& [fd, connection] : connections) {
+            const bool drained = connection->output_sent == connection->output.size();
+            if (connection->closing || (connection->input_done && drained)) {
+                closed.push_back(fd);
+            }
+        }
+        for (int fd : closed) {
+            closeConnection(fd);
+        }
+
+        const Clock::time_point now = Clock::now();
+        if (config.stats_interval_seconds > 0.0 && now - interval_started >= interval) {
+            reportInterval(now);
+        }
+    }
+
+    printStats("quote server stopped", stats());
+    while (!connections.empty()) {
+        closeConnection(connections.begin()->first);
+    }
+    return true;
+}
+
+/*
+    Accept Connections
+
+    Programmer's Note:
+        - Accepts until the backlog is empty; new connections start watching for input.
+
+    Simpler Terms:
+        Lets waiting clients in.
+ */
+void QuoteServer::acceptConnections() {
+    for (;;) {
+        const int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                reportSystemError("Could not accept a connection");
+            }
+            return;
+        }
+
+        auto connection = make_unique<Connection>();
+        connection->fd = fd;
+        connection->interest = EPOLLIN;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            reportSystemError("Could not watch a connection");
+            ::close(fd);
+            continue;
+        }
+        connections.emplace(fd, move(connection));
+    }
+}
+
+/*
+    Read Requests
+
+    Programmer's Note:
+        - One read per event; complete 32-byte requests are queued with the time the read
+          finished, and a partial request waits in the connection's input buffer.
+        - End of file stops reading (EPOLLIN is dropped) but keeps the connection open
+          until every queued reply has been sent; a read error closes it after this round.
+
+    Simpler Terms:
+        Collects the questions a client has sent.
+ */
+void QuoteServer::readRequests(Connection& connection) {
+    char chunk[READ_CHUNK];
+    ssize_t received;
+    do {
+        received = ::read(connection.fd, chunk, sizeof(chunk));
+    } while (received < 0 && errno == EINTR);
+
+    if (received == 0) {
+        connection.input_done = true;
+        updateInterest(connection);
+        return;
+    }
+    if (received < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            connection.closing = true;
+        }
+        return;
+    }
+
+    connection.input.insert(connection.input.end(), chunk, chunk + received);
+    const size_t complete = connection.input.size() / sizeof(QuoteRequest);
+    const Clock::time_point arrival = Clock::now();
+    for (size_t i = 0; i < complete; ++i) {
+        PendingRequest entry{ &connection, {}, arrival };
+        memcpy(&entry.request, connection.input.data() + i * sizeof(QuoteRequest), sizeof(QuoteRequest));
+        pending.push_back(entry);
+    }
+    connection.input.erase(connection.input.begin(),
+                           connection.input.begin() + static_cast<ptrdiff_t>(complete * sizeof(QuoteRequest)));
+}
+
+/*
+    Price Round
+
+    Programmer's Note:
+        - Prices everything read this round in batches of at most max_batch, writes the
+          replies to each connection that received any, and records each request's latency.
+
+    Simpler Terms:
+        Answers every question that came in since the last round.
+ */
+void QuoteServer::priceRound() {
+    if (pending.empty()) {
+        return;
+    }
+
+    for (size_t first = 0; first < pending.size(); first += config.max_batch) {
+        priceBatch(first, min(pending.size(), first + config.max_batch));
+    }
+    for (Connection* connection : touched) {
+        writeReplies(*connection);
+    }
+
+    const Clock::time_point now = Clock::now();
+    for (const PendingRequest& entry : pending) {
+        const auto nanoseconds = static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(now - entry.arrival).count());
+        interval_latency.record(nanoseconds);
+        total_latency.record(nanoseconds);
+    }
+    totals.requests += pending.size();
+    interval_requests += pending.size();
+
+    pending.clear();
+    touched.clear();
+}
+
+/*
+    Write Replies
+
+    Programmer's Note:
+        - Sends as much queued output as the socket takes. Sent bytes are dropped from the
+          front once they make up half the buffer, so a steady stream never grows it.
+
+    Simpler Terms:
+        Sends the answers back to a client.
+ */
+void QuoteServer::writeReplies(Connection& connection) {
+    while (connection.output_sent < connection.output.size()) {
+        const ssize_t sent = ::send(connection.fd, connection.output.data() + connection.output_sent,
+                                    connection.output.size() - connection.output_sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent > 0) {
+            connection.output_sent += static_cast<size_t>(sent);
+            perf_counters::add(perf_counters::Counter::BytesWritten, static_cast<uint64_t>(sent));
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            connection.closing = true;
+        }
+        break;
+    }
+
+    if (connection.output_sent == connection.output.size()) {
+        connection.output.clear();
+        connection.output_sent = 0;
+    } else if (connection.output_sent * 2 >= connection.output.size()) {
+        connection.output.erase(connection.output.begin(),
+                                connection.output.begin() + static_cast<ptrdiff_t>(connection.output_sent));
+        connection.output_sent = 0;
+    }
+    updateInterest(connection);
+}
+
+/*
+    Update Interest
+
+    Programmer's Note:
+        - Watch for writability only while replies are queued, and for input only while
+          the queue is under MAX_OUTPUT_BACKLOG and the client has not sent end of file.
+          epoll_ctl is called only on a change.
+
+    Simpler Terms:
+        Tells the event loop what to wait for on this connection.
+ */
+void QuoteServer::updateInterest(Connection& connection) {
+    if (connection.closing) {
+        return;
+    }
+    const size_t backlog = connection.output.size() - connection.output_sent;
+    const uint32_t wanted = (backlog < MAX_OUTPUT_BACKLOG && !connection.input_done ? uint32_t{ EPOLLIN } : 0u)
+                          | (backlog > 0 ? uint32_t{ EPOLLOUT } : 0u);
+    if (wanted == connection.interest) {
+        return;
+    }
+
+    epoll_event event{};
+    event.events = wanted;
+    event.data.fd = connection.fd;
+    if (::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection.fd, &event) < 0) {
+        connection.closing = true;
+        return;
+    }
+    connection.interest = wanted;
+}
+
+void QuoteServer::closeConnection(int fd) {
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections.erase(fd);
+}
+
+#else // !__linux__
+
+bool QuoteServer::open() {
+    cerr << "ERROR: The quote server needs Linux (epoll)." << endl;
+    return false;
+}
+
+bool QuoteServer::run() {
+    cerr << "ERROR: The quote server needs Linux (epoll)." << endl;
+    return false;
+}
+
+void QuoteServer::requestStop() {
+}
+
+#endif // __linux__
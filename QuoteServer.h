@@ -0,0 +1,193 @@
+// Quote Server Specification
+
+#ifndef QUOTE_SERVER_H
+#define QUOTE_SERVER_H
+
+#include "BatchPricer.h"
+#include "LoanBook.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+    Quote Wire Format
+
+    Programmer's Note:
+        - Requests and replies are fixed-size binary records in native byte order, like the
+          binary batch files: a QuoteRequest is 32 bytes (id + LoanRecord), a QuoteReply is
+          24 bytes (id + LoanQuote).
+        - Clients may send any number of requests without waiting (pipelining). Replies on a
+          connection come back in request order and carry the request's id.
+        - A loan with a non-finite or negative amount or rate, or a term outside 1..100 years,
+          is answered with NaN values (as malformed lines are in batch mode).
+
+    Simpler Terms:
+        What a quote question and its answer look like on the wire.
+ */
+struct QuoteRequest {
+    std::uint64_t id;               // Chosen by the client, echoed in the reply
+    LoanRecord loan;
+};
+
+struct QuoteReply {
+    std::uint64_t id;
+    LoanQuote quote;
+};
+
+static_assert(sizeof(QuoteRequest) == 32 && sizeof(QuoteReply) == 24, "quote records are part of the wire format");
+
+/*
+    Class: LatencyHistogram
+
+    Programmer's Note:
+        - Log-linear buckets over nanoseconds: exact below 16 ns, then 16 buckets per power
+          of two (~6% resolution) up to 2^64 ns, in a fixed 8 KiB table. Recording is O(1)
+          and memory does not grow with the number of samples.
+        - percentileMicros() reports the upper edge of the bucket holding that rank (capped
+          at the largest sample), so percentiles are never understated.
+
+    Simpler Terms:
+        Counts how long requests took, so the typical and worst cases can be reported.
+ */
+class LatencyHistogram {
+public:
+    void record(std::uint64_t nanoseconds);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    [[nodiscard]] std::uint64_t count() const { return total; }
+    [[nodiscard]] double percentileMicros(double percent) const;
+    [[nodiscard]] double maxMicros() const { return static_cast<double>(largest) / 1000.0; }
+
+private:
+    static constexpr int SUB_BUCKET_BITS = 4;
+
+    static std::size_t bucketIndex(std::uint64_t nanoseconds);
+    static std::uint64_t bucketUpperEdge(std::size_t index);
+
+    std::array<std::uint64_t, std::size_t{ 64 } << SUB_BUCKET_BITS> buckets{};
+    std::uint64_t total = 0;
+    std::uint64_t largest = 0;
+};
+
+/*
+    Quote Server Configuration / Statistics
+
+    Programmer's Note:
+        - max_batch caps the requests priced in one kernel call; a round with more pending
+          requests is priced in several calls.
+        - stats_interval_seconds > 0 prints an INFO line to cerr at that interval with the
+          requests, QPS, batch sizes and p50/p99 latency since the previous line.
+        - Latency is measured in the server, from the read that completed a request until
+          its reply has been handed to the socket (or queued, if the client is not reading).
+
+    Simpler Terms:
+        Settings for the quote service and the numbers it reports about itself.
+ */
+struct QuoteServerConfig {
+    std::string socket_path;                // Unix domain socket to listen on
+    std::size_t max_batch = 4096;           // Most requests priced in one kernel call
+    double stats_interval_seconds = 0.0;    // 0 = report only when the server stops
+};
+
+struct QuoteServerStats {
+    std::uint64_t requests = 0;
+    std::uint64_t batches = 0;
+    std::size_t largest_batch = 0;
+    double seconds = 0.0;
+    double qps = 0.0;
+    double p50_micros = 0.0;
+    double p99_micros = 0.0;
+    double max_micros = 0.0;
+};
+
+/*
+    Class: QuoteServer
+
+    Programmer's Note:
+        - A single-threaded, event-driven quoting daemon on a Unix domain socket (epoll,
+          level-triggered, non-blocking sockets). Linux only; elsewhere open() prints an
+          ERROR line and returns false.
+        - Micro-batching: every request read during one epoll round (across all connections)
+          is priced together with the LoanBook SIMD kernel, then the replies are written.
+          Nothing waits for a batch to fill, so a lone request is answered at once, and
+          batches grow by themselves as load rises.
+        - A connection whose unsent replies exceed 1 MiB is not read again until the client
+          has taken them, so a slow reader cannot make the server buffer without bound.
+        - requestStop() may be called from any thread or a signal handler; run() then
+          returns after the current round, closing every connection.
+        - The socket file is replaced if it exists and removed when the server is destroyed.
+
+    Simpler Terms:
+        A background program that answers loan quote questions from other programs on the
+        same machine, pricing many questions at once when they arrive together.
+ */
+class QuoteServer {
+public:
+    explicit QuoteServer(QuoteServerConfig config);
+    ~QuoteServer();
+
+    QuoteServer(const QuoteServer&) = delete;
+    QuoteServer& operator=(const QuoteServer&) = delete;
+
+    bool open();                                // Bind and listen; false after an ERROR line
+    bool run();                                 // Serve until requestStop()
+    void requestStop();                         // Async-signal-safe
+
+    [[nodiscard]] QuoteServerStats stats() const;  // Totals since run() started
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Connection {
+        int fd = -1;
+        std::vector<char> input;            // Bytes of a request not yet complete
+        std::vector<char> output;           // Encoded replies not yet written
+        std::size_t output_sent = 0;
+        std::uint32_t interest = 0;         // Current epoll event mask
+        bool input_done = false;            // Client sent end of file; replies still go out
+        bool closing = false;               // Socket error: close after this round
+    };
+
+    struct PendingRequest {
+        Connection* connection;
+        QuoteRequest request;
+        Clock::time_point arrival;
+    };
+
+    void acceptConnections();
+    void readRequests(Connection& connection);
+    void priceBatch(std::size_t first, std::size_t last);
+    void priceRound();
+    void writeReplies(Connection& connection);
+    void updateInterest(Connection& connection);
+    void closeConnection(int fd);
+    void reportInterval(Clock::time_point now);
+
+    QuoteServerConfig config;
+    int listen_fd = -1;
+    int epoll_fd = -1;
+    int stop_fd = -1;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+
+    std::vector<PendingRequest> pending;
+    std::vector<Connection*> touched;
+    LoanBook book;
+    std::vector<double> payments;
+
+    Clock::time_point started;
+    Clock::time_point interval_started;
+    std::uint64_t interval_requests = 0;
+    std::uint64_t interval_batches = 0;
+    std::size_t interval_largest_batch = 0;
+    LatencyHistogram interval_latency;
+    QuoteServerStats totals;
+    LatencyHistogram total_latency;
+};
+
+#endif // QUOTE_SERVER_H
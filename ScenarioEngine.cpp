@@ -0,0 +1,181 @@
+// Scenario Engine Implementation
+
+#include "ScenarioEngine.h"
+#include "Mortgage.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+constexpr int PSA_RAMP_MONTHS = 30;          // Standard PSA: CPR ramps up over 30 months
+constexpr double PSA_MONTHLY_STEP = 0.002;   // ... by 0.2% per month (6% CPR at month 30)
+
+/*
+    Single Monthly Mortality
+
+    Programmer's Note:
+        - Converts an annual prepayment rate (decimal) to the equivalent monthly fraction.
+
+    Simpler Terms:
+        Turns "x% of loans prepay per year" into a per-month fraction.
+ */
+double singleMonthlyMortality(double cpr) {
+    cpr = clamp(cpr, 0.0, 1.0);
+    return 1.0 - pow(1.0 - cpr, 1.0 / 12.0);
+}
+
+} // namespace
+
+/*
+    ScenarioEngine Constructor
+
+    Programmer's Note:
+        - Payment and monthly rate are derived exactly as Mortgage does, then the
+          no-prepayment schedule is computed once; its interest is the baseline for
+          interest_saved and its balances are the first cached scenario.
+
+    Simpler Terms:
+        Sets up the loan and works out the regular payment plan to compare against.
+ */
+ScenarioEngine::ScenarioEngine(double loanAmount, double annualRatePercent, int years)
+    : loan_amount(loanAmount),
+      monthly_interest_rate(annualRatePercent / 100.0 / 12.0),
+      monthly_payment(0.0),
+      number_of_payments(0) {
+    Mortgage loan(false);
+    loan.setLoanAmount(loanAmount);
+    loan.setAnnualInterestRate(annualRatePercent);
+    loan.setTotalYearsToRepay(years);
+    monthly_payment = loan.getMonthlyPayment();
+    number_of_payments = max(0, loan.getNumberOfPayments());
+
+    const size_t months = static_cast<size_t>(number_of_payments);
+    extra_principal.assign(months, 0.0);
+    prepayment_rate.assign(months, 0.0);
+    balance.assign(months, 0.0);
+    cumulative_interest.assign(months, 0.0);
+    next_extra.resize(months);
+    next_rate.resize(months);
+
+    recompute(1);
+    base_interest = current.total_interest;
+    current.interest_saved = 0.0;
+}
+
+/*
+    Build Inputs
+
+    Programmer's Note:
+        - buildExtraPrincipal spreads the scenario's extra payments (and the biweekly
+          thirteenth payment) over the months they fall in.
+        - buildPrepaymentRates computes each month's SMM from the CPR or PSA assumption,
+          treating the loan as new (month 1 = loan age 1).
+
+    Simpler Terms:
+        Turns a "what if" into the extra amount and prepayment rate for every month.
+ */
+void ScenarioEngine::buildExtraPrincipal(const PrepaymentScenario& scenario, vector<double>& out) const {
+    fill(out.begin(), out.end(), scenario.biweekly ? monthly_payment / 12.0 : 0.0);
+
+    for (const ExtraPayment& extra : scenario.extra_payments) {
+        const int first = max(extra.first_month, 1);
+        const int last = min(extra.last_month, number_of_payments);
+        for (int month = first; month <= last; ++month) {
+            out[static_cast<size_t>(month - 1)] += extra.amount;
+        }
+    }
+}
+
+void ScenarioEngine::buildPrepaymentRates(double cprPercent, double psaPercent, vector<double>& out) const {
+    if (psaPercent > 0.0) {
+        for (size_t i = 0; i < out.size(); ++i) {
+            const int age = min(static_cast<int>(i) + 1, PSA_RAMP_MONTHS);
+            out[i] = singleMonthlyMortality(age * PSA_MONTHLY_STEP * psaPercent / 100.0);
+        }
+    } else {
+        fill(out.begin(), out.end(), cprPercent > 0.0 ? singleMonthlyMortality(cprPercent / 100.0) : 0.0);
+    }
+}
+
+/*
+    Evaluate
+
+    Programmer's Note:
+        - Builds the new scenario's inputs, finds the first month where they differ from
+          the cached inputs, swaps them in, and recomputes from that month on.
+        - Cost: O(term) to build and compare the inputs (plain stores and compares) plus
+          the monthly loop from the first changed month only.
+
+    Simpler Terms:
+        Works out a "what if", redoing only the months that actually change.
+ */
+const ScenarioResult& ScenarioEngine::evaluate(const PrepaymentScenario& scenario) {
+    size_t firstChange = static_cast<size_t>(number_of_payments);
+
+    buildExtraPrincipal(scenario, next_extra);
+    firstChange = min(firstChange, static_cast<size_t>(
+        mismatch(extra_principal.begin(), extra_principal.end(), next_extra.begin()).first - extra_principal.begin()));
+    extra_principal.swap(next_extra);
+
+    if (scenario.cpr_percent != cached_cpr || scenario.psa_percent != cached_psa) {
+        buildPrepaymentRates(scenario.cpr_percent, scenario.psa_percent, next_rate);
+        firstChange = min(firstChange, static_cast<size_t>(
+            mismatch(prepayment_rate.begin(), prepayment_rate.end(), next_rate.begin()).first - prepayment_rate.begin()));
+        prepayment_rate.swap(next_rate);
+        cached_cpr = scenario.cpr_percent;
+        cached_psa = scenario.psa_percent;
+    }
+
+    if (firstChange < static_cast<size_t>(number_of_payments)) {
+        recompute(static_cast<int>(firstChange) + 1);
+    } else {
+        current.recomputed_from = number_of_payments + 1;
+    }
+    return current;
+}
+
+/*
+    Recompute
+
+    Programmer's Note:
+        - Restarts the monthly loop at 'firstMonth' from the cached balance and interest
+          of the month before. Each month: interest on the balance, the scheduled principal
+          (never more than is owed, which is outputPaymentSchedule's negative-balance clamp),
+          then extra principal and SMM * remaining balance, capped at what is left.
+        - Months after payoff are zero-filled without further arithmetic.
+        - The balance never increases, so the payoff month is found by binary search.
+
+    Simpler Terms:
+        Redoes the month-by-month math starting from the first month that changed.
+ */
+void ScenarioEngine::recompute(int firstMonth) {
+    const size_t first = static_cast<size_t>(firstMonth - 1);
+    const size_t months = static_cast<size_t>(number_of_payments);
+    double remaining = first > 0 ? balance[first - 1] : loan_amount;
+    double interestPaid = first > 0 ? cumulative_interest[first - 1] : 0.0;
+
+    size_t i = first;
+    for (; i < months && remaining > 0.0; ++i) {
+        const double interest = monthly_interest_rate * remaining;
+        remaining -= min(monthly_payment - interest, remaining);
+
+        const double prepayment = extra_principal[i] + prepayment_rate[i] * remaining;
+        remaining -= min(prepayment, remaining);
+
+        interestPaid += interest;
+        balance[i] = remaining;
+        cumulative_interest[i] = interestPaid;
+    }
+    fill(balance.begin() + static_cast<ptrdiff_t>(i), balance.end(), 0.0);
+    fill(cumulative_interest.begin() + static_cast<ptrdiff_t>(i), cumulative_interest.end(), interestPaid);
+
+    const auto paidOff = partition_point(balance.begin(), balance.end(), [](double b) { return b > 0.0; });
+    current.payoff_month = paidOff == balance.end() ? number_of_payments
+                                                    : static_cast<int>(paidOff - balance.begin()) + 1;
+    current.total_interest = months > 0 ? cumulative_interest.back() : 0.0;
+    current.interest_saved = base_interest - current.total_interest;
+    current.balance_curve = balance;
+    current.recomputed_from = firstMonth;
+}
@@ -0,0 +1,133 @@
+// Scenario Engine Specification
+
+#ifndef SCENARIO_ENGINE_H
+#define SCENARIO_ENGINE_H
+
+#include <span>
+#include <vector>
+
+/*
+    Struct: ExtraPayment
+
+    Programmer's Note:
+        - Extra principal of 'amount' paid every month from first_month through last_month
+          (1-based, inclusive). A lump sum is first_month == last_month.
+        - Months outside the loan term are ignored.
+
+    Simpler Terms:
+        Money paid on top of the regular payment, once or every month for a while.
+ */
+struct ExtraPayment {
+    int first_month;
+    int last_month;
+    double amount;
+};
+
+/*
+    Struct: PrepaymentScenario
+
+    Programmer's Note:
+        - extra_payments: scheduled extra principal (recurring or lump sums); amounts that
+          fall in the same month add up.
+        - biweekly: half the monthly payment every two weeks, i.e. 26 half payments or
+          13 full payments a year. Modeled as one twelfth of a payment of extra principal
+          each month, the usual servicer approximation.
+        - cpr_percent: constant prepayment rate (annual %). Each month the borrower also
+          prepays SMM = 1 - (1 - CPR)^(1/12) of the balance left after the scheduled payment.
+        - psa_percent: PSA speed (100 = standard model: CPR rises 0.2% a month to 6% at month 30,
+          then stays at 6%), scaled by psa_percent / 100. Used instead of cpr_percent when > 0.
+        - The level payment never changes (prepayments are curtailments, not re-amortizations),
+          so every kind of prepayment shortens the loan. Prepayment can never exceed what
+          is still owed; the loan simply pays off early.
+
+    Simpler Terms:
+        A "what if": what happens if the borrower pays extra, pays every two weeks,
+        or pays the loan down early at a typical market rate.
+ */
+struct PrepaymentScenario {
+    std::vector<ExtraPayment> extra_payments;
+    bool biweekly = false;
+    double cpr_percent = 0.0;
+    double psa_percent = 0.0;
+};
+
+/*
+    Struct: ScenarioResult
+
+    Programmer's Note:
+        - balance_curve holds the balance after each month (number_of_payments entries,
+          zero after payoff) and stays valid until the next evaluate() on the same engine.
+        - recomputed_from is the first month evaluate() actually recalculated
+          (number_of_payments + 1 when the scenario changed nothing).
+
+    Simpler Terms:
+        When the loan is paid off, how much interest that costs and saves, and what is
+        owed each month.
+ */
+struct ScenarioResult {
+    int payoff_month = 0;               // Month the balance reaches zero
+    double total_interest = 0.0;        // Interest paid over the life of the loan
+    double interest_saved = 0.0;        // Base schedule interest minus total_interest
+    std::span<const double> balance_curve;
+    int recomputed_from = 0;
+};
+
+/*
+    Class: ScenarioEngine
+
+    Programmer's Note:
+        - Runs prepayment scenarios against one loan, month by month, with the same
+          amortization rules as Mortgage::outputPaymentSchedule (the empty scenario
+          reproduces its balances exactly).
+        - Keeps the last scenario's per-month inputs (extra principal and prepayment rate)
+          and results (balance and cumulative interest). evaluate() finds the first month
+          whose inputs differ and recomputes only from that month, starting from the
+          cached balance at the month before. Sweeps that move a change from late months
+          to early months, or vary one lump sum, therefore cost much less than a full
+          schedule each.
+        - The prepayment-rate column is rebuilt only when cpr_percent or psa_percent changes.
+        - Not thread-safe; use one engine per thread for parallel sweeps.
+
+    Simpler Terms:
+        Tries many "what if" payment plans for a loan quickly, by reusing the months
+        that a change does not affect.
+ */
+class ScenarioEngine {
+public:
+    ScenarioEngine(double loanAmount, double annualRatePercent, int years);
+
+    // Runs 'scenario', reusing the months it shares with the previous evaluate()
+    const ScenarioResult& evaluate(const PrepaymentScenario& scenario);
+
+    [[nodiscard]] int numberOfPayments() const { return number_of_payments; }
+    [[nodiscard]] double monthlyPayment() const { return monthly_payment; }
+    [[nodiscard]] double baseInterest() const { return base_interest; }     // Interest with no prepayment
+    [[nodiscard]] const ScenarioResult& result() const { return current; }
+
+private:
+    double loan_amount;
+    double monthly_interest_rate;
+    double monthly_payment;
+    int number_of_payments;
+    double base_interest = 0.0;
+
+    // Per-month inputs of the cached scenario (index = month - 1)
+    std::vector<double> extra_principal;
+    std::vector<double> prepayment_rate;            // Single monthly mortality (SMM)
+    double cached_cpr = 0.0;
+    double cached_psa = 0.0;
+
+    // Per-month results of the cached scenario
+    std::vector<double> balance;                    // Balance after each month
+    std::vector<double> cumulative_interest;        // Interest paid through each month
+
+    std::vector<double> next_extra;                 // Scratch inputs for the next scenario
+    std::vector<double> next_rate;
+    ScenarioResult current;
+
+    void buildExtraPrincipal(const PrepaymentScenario& scenario, std::vector<double>& out) const;
+    void buildPrepaymentRates(double cprPercent, double psaPercent, std::vector<double>& out) const;
+    void recompute(int firstMonth);
+};
+
+#endif // SCENARIO_ENGINE_H
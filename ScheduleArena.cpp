@@ -0,0 +1,81 @@
+// Schedule Arena Class Implementation
+
+#include "ScheduleArena.h"
+#include <algorithm>
+
+using namespace std;
+
+ScheduleArena::ScheduleArena(size_t rowsPerChunk) : chunk_rows(max<size_t>(rowsPerChunk, 1)) {
+}
+
+/*
+    Allocate
+
+    Programmer's Note:
+        - Takes the rows from the current chunk if they fit; otherwise moves on to the next
+          kept chunk that is large enough (the skipped tail is reused after reset()), and
+          only allocates a new chunk when none is left.
+        - Rows are left uninitialized; fillPaymentSchedule overwrites every field.
+
+    Simpler Terms:
+        Hands out the next free piece of the scratch area.
+ */
+span<PaymentRow> ScheduleArena::allocate(size_t rows) {
+    if (rows == 0) {
+        return {};
+    }
+
+    while (current < chunks.size() && chunks[current].capacity - used < rows) {
+        ++current;
+        used = 0;
+    }
+
+    if (current == chunks.size()) {
+        const size_t capacity = max(chunk_rows, rows);
+        chunks.push_back({ unique_ptr<PaymentRow[]>(new PaymentRow[capacity]), capacity });
+        used = 0;
+    }
+
+    PaymentRow* first = chunks[current].rows.get() + used;
+    used += rows;
+    rows_in_use += rows;
+    return { first, rows };
+}
+
+/*
+    Schedule
+
+    Programmer's Note:
+        - Same rows as outputPaymentSchedule prints, bit for bit.
+
+    Simpler Terms:
+        Builds a loan's payment plan in the scratch area.
+ */
+span<const PaymentRow> ScheduleArena::schedule(const Mortgage& loan) {
+    const span<PaymentRow> rows = allocate(static_cast<size_t>(max(0, loan.getNumberOfPayments())));
+    loan.fillPaymentSchedule(rows);
+    return rows;
+}
+
+/*
+    Reset / Capacity
+
+    Programmer's Note:
+        - reset() is O(1); previously returned spans become invalid.
+
+    Simpler Terms:
+        Starts the scratch area over for the next batch.
+ */
+void ScheduleArena::reset() {
+    current = 0;
+    used = 0;
+    rows_in_use = 0;
+}
+
+size_t ScheduleArena::capacityRows() const {
+    size_t total = 0;
+    for (const Chunk& chunk : chunks) {
+        total += chunk.capacity;
+    }
+    return total;
+}
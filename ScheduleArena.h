@@ -0,0 +1,63 @@
+// Schedule Arena Class Specification
+
+#ifndef SCHEDULE_ARENA_H
+#define SCHEDULE_ARENA_H
+
+#include "Mortgage.h"
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+/*
+    Class: ScheduleArena
+
+    Programmer's Note:
+        - Bump allocator for PaymentRow storage: rows are handed out from large chunks
+          (64K rows = 2.5 MiB by default) and never freed one by one.
+        - reset() rewinds to the first chunk but keeps every chunk, so once a batch has
+          run (warm-up) later batches of the same size make no heap allocations at all.
+        - Each allocation is contiguous; a request larger than the chunk size gets a
+          chunk of its own size.
+        - Spans stay valid until reset() or destruction. Not thread-safe; use one arena
+          per thread.
+
+    Simpler Terms:
+        A big reusable scratch area for payment plans, so building millions of them does
+        not ask the system for memory millions of times.
+ */
+class ScheduleArena {
+public:
+    static constexpr std::size_t DEFAULT_CHUNK_ROWS = std::size_t{ 1 } << 16;
+
+    explicit ScheduleArena(std::size_t rowsPerChunk = DEFAULT_CHUNK_ROWS);
+
+    ScheduleArena(const ScheduleArena&) = delete;
+    ScheduleArena& operator=(const ScheduleArena&) = delete;
+
+    // Uninitialized storage for 'rows' rows
+    [[nodiscard]] std::span<PaymentRow> allocate(std::size_t rows);
+
+    // The loan's full schedule (Mortgage::fillPaymentSchedule) in arena storage
+    [[nodiscard]] std::span<const PaymentRow> schedule(const Mortgage& loan);
+
+    void reset();                                       // Rewind; keeps all chunks for reuse
+
+    [[nodiscard]] std::size_t rowsInUse() const { return rows_in_use; }
+    [[nodiscard]] std::size_t capacityRows() const;     // Rows held across all chunks
+    [[nodiscard]] std::size_t chunkCount() const { return chunks.size(); }
+
+private:
+    struct Chunk {
+        std::unique_ptr<PaymentRow[]> rows;
+        std::size_t capacity;
+    };
+
+    std::size_t chunk_rows;
+    std::vector<Chunk> chunks;
+    std::size_t current = 0;            // Chunk being filled
+    std::size_t used = 0;               // Rows used in the current chunk
+    std::size_t rows_in_use = 0;
+};
+
+#endif // SCHEDULE_ARENA_H
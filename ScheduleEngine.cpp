@@ -0,0 +1,211 @@
+// Schedule Engine Implementation
+
+#include "ScheduleEngine.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+constexpr size_t MIN_BLOCK_LOANS = 64;      // Smallest block of loans with its own partial totals
+constexpr size_t MAX_BLOCKS = 1024;         // Caps partial-total memory at MAX_BLOCKS * longest term
+constexpr size_t MONTH_GRAIN = 8;           // Months per stolen piece of the final reduction
+
+struct MonthTotals {
+    double interest;
+    double principal;
+    double balance;
+};
+
+/*
+    Aggregation Blocks
+
+    Programmer's Note:
+        - Loans are cut into fixed blocks of at least MIN_BLOCK_LOANS loans, at most
+          MAX_BLOCKS of them. The block size depends only on the number of loans, never
+          on the thread count, so the summation order (and every total) is the same on
+          any pool.
+
+    Simpler Terms:
+        Decides how many loans go into each group that is added up on its own.
+ */
+size_t blockLoans(size_t loanCount) {
+    return max(MIN_BLOCK_LOANS, (loanCount + MAX_BLOCKS - 1) / MAX_BLOCKS);
+}
+
+/*
+    Prepare Layout
+
+    Programmer's Note:
+        - Computes each loan's row offset from its term and sizes all output arrays,
+          so the parallel phases only ever write into their own slots.
+
+    Simpler Terms:
+        Works out where each loan's plan goes before anything is computed.
+ */
+PortfolioSchedule prepareLayout(span<const LoanRecord> loans) {
+    PortfolioSchedule schedule;
+    schedule.row_offset.resize(loans.size() + 1);
+
+    size_t total = 0;
+    size_t longest = 0;
+    for (size_t i = 0; i < loans.size(); ++i) {
+        const size_t payments = static_cast<size_t>(max(0, loans[i].total_years_to_repay * 12));
+        schedule.row_offset[i] = total;
+        total += payments;
+        longest = max(longest, payments);
+    }
+    schedule.row_offset[loans.size()] = total;
+
+    schedule.rows.resize(total);
+    schedule.interest_by_month.assign(longest, 0.0);
+    schedule.principal_by_month.assign(longest, 0.0);
+    schedule.balance_by_month.assign(longest, 0.0);
+    return schedule;
+}
+
+/*
+    Fill Loan Schedules
+
+    Programmer's Note:
+        - Uses one silent Mortgage per call so rows match Mortgage::fillPaymentSchedule exactly.
+
+    Simpler Terms:
+        Works out the payment plans for loans first..last-1.
+ */
+void fillLoanSchedules(span<const LoanRecord> loans, PortfolioSchedule& schedule, size_t first, size_t last) {
+    Mortgage loan(false);
+
+    for (size_t i = first; i < last; ++i) {
+        loan.setLoanAmount(loans[i].loan_amount);
+        loan.setAnnualInterestRate(loans[i].annual_interest_rate);
+        loan.setTotalYearsToRepay(loans[i].total_years_to_repay);
+
+        const size_t begin = schedule.row_offset[i];
+        loan.fillPaymentSchedule(span<PaymentRow>(schedule.rows.data() + begin,
+                                                  schedule.row_offset[i + 1] - begin));
+    }
+}
+
+/*
+    Build Block
+
+    Programmer's Note:
+        - Fills the schedules of loans [first, last) and, while those rows are still in
+          cache, adds them into the block's own partial totals ('totals', one entry per
+          month, zeroed by the caller) in loan order. Each row is read once, sequentially.
+
+    Simpler Terms:
+        Works out the payment plans for one group of loans and the group's monthly totals.
+ */
+void buildBlock(span<const LoanRecord> loans, PortfolioSchedule& schedule, MonthTotals* totals,
+                size_t first, size_t last) {
+    fillLoanSchedules(loans, schedule, first, last);
+
+    for (size_t loan = first; loan < last; ++loan) {
+        const size_t begin = schedule.row_offset[loan];
+        const size_t payments = schedule.row_offset[loan + 1] - begin;
+        const PaymentRow* rows = schedule.rows.data() + begin;
+
+        for (size_t month = 0; month < payments; ++month) {
+            totals[month].interest += rows[month].interest;
+            totals[month].principal += rows[month].principal;
+            totals[month].balance += rows[month].remaining_balance;
+        }
+    }
+}
+
+/*
+    Reduce Months
+
+    Programmer's Note:
+        - For each month in [first, last), adds the block partials in block order.
+
+    Simpler Terms:
+        Adds up the groups' totals into the portfolio totals for some months.
+ */
+void reduceMonths(PortfolioSchedule& schedule, const vector<MonthTotals>& partials, size_t blocks,
+                  size_t first, size_t last) {
+    const size_t months = schedule.interest_by_month.size();
+
+    for (size_t month = first; month < last; ++month) {
+        MonthTotals sum{ 0.0, 0.0, 0.0 };
+        for (size_t block = 0; block < blocks; ++block) {
+            const MonthTotals& partial = partials[block * months + month];
+            sum.interest += partial.interest;
+            sum.principal += partial.principal;
+            sum.balance += partial.balance;
+        }
+        schedule.interest_by_month[month] = sum.interest;
+        schedule.principal_by_month[month] = sum.principal;
+        schedule.balance_by_month[month] = sum.balance;
+    }
+}
+
+} // namespace
+
+/*
+    Build Portfolio Schedules (Parallel)
+
+    Programmer's Note:
+        - Phase 1: loan blocks across the work-stealing pool; each block fills its loans'
+          schedules and its partial monthly totals (buildBlock). Parallelism grows with
+          the number of loans (up to MAX_BLOCKS blocks), not with the term.
+        - Phase 2: the partials are reduced month by month in block order, which keeps
+          the summation order identical to the serial builder. This pass only touches
+          blocks * months entries, a small fraction of the rows.
+
+    Simpler Terms:
+        Builds all payment plans and portfolio totals using every core.
+ */
+PortfolioSchedule buildPortfolioSchedules(span<const LoanRecord> loans, WorkStealingPool& pool) {
+    perf_counters::ScopedTimer timer(perf_counters::Phase::ScheduleBuild);
+    PortfolioSchedule schedule = prepareLayout(loans);
+    perf_counters::add(perf_counters::Counter::RowsGenerated, schedule.rows.size());
+
+    const size_t months = schedule.interest_by_month.size();
+    const size_t perBlock = blockLoans(loans.size());
+    const size_t blocks = (loans.size() + perBlock - 1) / perBlock;
+    vector<MonthTotals> partials(blocks * months, MonthTotals{ 0.0, 0.0, 0.0 });
+
+    pool.parallelFor(blocks, 1, [&](size_t first, size_t last) {
+        for (size_t block = first; block < last; ++block) {
+            buildBlock(loans, schedule, partials.data() + block * months,
+                       block * perBlock, min(loans.size(), (block + 1) * perBlock));
+        }
+    });
+
+    pool.parallelFor(months, MONTH_GRAIN, [&](size_t first, size_t last) {
+        reduceMonths(schedule, partials, blocks, first, last);
+    });
+
+    return schedule;
+}
+
+/*
+    Build Portfolio Schedules (Serial)
+
+    Programmer's Note:
+        - Reference implementation: same blocks and reduction order, one thread.
+
+    Simpler Terms:
+        Builds all payment plans and portfolio totals one loan at a time.
+ */
+PortfolioSchedule buildPortfolioSchedulesSerial(span<const LoanRecord> loans) {
+    perf_counters::ScopedTimer timer(perf_counters::Phase::ScheduleBuild);
+    PortfolioSchedule schedule = prepareLayout(loans);
+    perf_counters::add(perf_counters::Counter::RowsGenerated, schedule.rows.size());
+    const size_t months = schedule.interest_by_month.size();
+    const size_t perBlock = blockLoans(loans.size());
+    const size_t blocks = (loans.size() + perBlock - 1) / perBlock;
+    vector<MonthTotals> partials(blocks * months, MonthTotals{ 0.0, 0.0, 0.0 });
+
+    for (size_t block = 0; block < blocks; ++block) {
+        buildBlock(loans, schedule, partials.data() + block * months,
+                   block * perBlock, min(loans.size(), (block + 1) * perBlock));
+    }
+    reduceMonths(schedule, partials, blocks, 0, months);
+    return schedule;
+}
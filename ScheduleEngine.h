@@ -0,0 +1,62 @@
+// Schedule Engine Specification
+
+#ifndef SCHEDULE_ENGINE_H
+#define SCHEDULE_ENGINE_H
+
+#include "BatchPricer.h"
+#include "Mortgage.h"
+#include "WorkStealingPool.h"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/*
+    Struct: PortfolioSchedule
+
+    Programmer's Note:
+        - Every loan's amortization schedule, stored back to back in 'rows';
+          loan i owns rows [row_offset[i], row_offset[i + 1]).
+        - Portfolio aggregates are indexed by month - 1 and cover the longest loan.
+          Loans that are already paid off contribute zero to later months.
+        - Each aggregate month is summed over fixed blocks of loans (in loan order within a
+          block), then over the blocks in order. The blocks depend only on the number of
+          loans, so the parallel and serial builders produce bit-identical results.
+
+    Simpler Terms:
+        The payment plan of every loan, plus the totals for the whole portfolio
+        month by month.
+ */
+struct PortfolioSchedule {
+    std::vector<std::size_t> row_offset;        // Start of each loan's rows (size = loans + 1)
+    std::vector<PaymentRow> rows;               // All schedules, concatenated in loan order
+
+    std::vector<double> interest_by_month;      // Total interest paid in each month
+    std::vector<double> principal_by_month;     // Total principal repaid in each month
+    std::vector<double> balance_by_month;       // Total outstanding balance after each month
+
+    [[nodiscard]] std::size_t loanCount() const { return row_offset.empty() ? 0 : row_offset.size() - 1; }
+
+    [[nodiscard]] std::span<const PaymentRow> loanSchedule(std::size_t loan) const {
+        return { rows.data() + row_offset[loan], rows.data() + row_offset[loan + 1] };
+    }
+};
+
+/*
+    Portfolio Schedule Builders
+
+    Programmer's Note:
+        - buildPortfolioSchedules splits the loans into blocks across the pool (work
+          stealing evens out 10-year vs 40-year loans); each block builds its schedules
+          and its own partial monthly totals, which a short final pass adds up by month.
+          The parallel work scales with the number of loans, not the length of the term.
+        - buildPortfolioSchedulesSerial is the single-threaded reference with the same
+          summation order; the two always compare equal.
+
+    Simpler Terms:
+        Builds every loan's payment plan and the portfolio totals, using all CPU cores
+        or just one.
+ */
+PortfolioSchedule buildPortfolioSchedules(std::span<const LoanRecord> loans, WorkStealingPool& pool);
+PortfolioSchedule buildPortfolioSchedulesSerial(std::span<const LoanRecord> loans);
+
+#endif // SCHEDULE_ENGINE_H
@@ -0,0 +1,594 @@
+// Schedule Sink Implementation
+
+#include "ScheduleSink.h"
+#include "PerfCounters.h"
+#include "ScheduleWriter.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+constexpr char COLUMNAR_MAGIC[8] = { 'M', 'T', 'G', 'C', 'O', 'L', 'S', '1' };
+
+/*
+    Class: OutputBuffer
+
+    Programmer's Note:
+        - 64 KiB of formatted text handed to the stream in one write when full (or on
+          flush). Callers reserve room for a whole row, format into it with to_chars,
+          then commit the end pointer, so a row is never split across checks.
+
+    Simpler Terms:
+        Collects text in memory and saves it in big pieces.
+ */
+class OutputBuffer {
+public:
+    explicit OutputBuffer(ostream& outStream) : out(outStream) {}
+    ~OutputBuffer() { flush(); }
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    char* reserve(size_t bytes) {
+        if (used + bytes > BUFFER_SIZE) {
+            flush();
+        }
+        return buffer.get() + used;
+    }
+
+    void commit(const char* end) { used = static_cast<size_t>(end - buffer.get()); }
+
+    void append(string_view text) {
+        char* cursor = reserve(text.size());
+        memcpy(cursor, text.data(), text.size());
+        commit(cursor + text.size());
+    }
+
+    void flush() {
+        if (used > 0) {
+            out.write(buffer.get(), static_cast<streamsize>(used));
+            perf_counters::add(perf_counters::Counter::BytesWritten, used);
+            used = 0;
+        }
+    }
+
+private:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+    ostream& out;
+    unique_ptr<char[]> buffer = make_unique<char[]>(BUFFER_SIZE);
+    size_t used = 0;
+};
+
+// Shortest round-trip double (at most 24 characters)
+char* appendNumber(char* cursor, double value) {
+    return to_chars(cursor, cursor + 32, value).ptr;
+}
+
+char* appendNumber(char* cursor, long long value) {
+    return to_chars(cursor, cursor + 24, value).ptr;
+}
+
+char* appendText(char* cursor, string_view text) {
+    memcpy(cursor, text.data(), text.size());
+    return cursor + text.size();
+}
+
+/*
+    Text Sink
+
+    Programmer's Note:
+        - ScheduleWriter's banner / summary / column headers at each beginLoan, then its
+          rows, so one loan is byte for byte what outputPaymentSchedule always wrote.
+
+    Simpler Terms:
+        The familiar schedule report.
+ */
+class TextSink : public ScheduleSink {
+public:
+    explicit TextSink(ostream& out) : writer(out) {}
+
+    void beginLoan(const ScheduleLoanInfo& loan) override {
+        writer.writeBanner();
+        writer.writeSummary(loan.loan_amount, loan.annual_interest_rate, loan.total_years_to_repay,
+                            loan.monthly_payment, loan.total_payback);
+        writer.writeColumnHeaders();
+    }
+
+    void writeRows(span<const PaymentRow> rows) override {
+        for (const PaymentRow& row : rows) {
+            writer.writeRow(row);
+        }
+    }
+
+    void finish() override { writer.flush(); }
+
+private:
+    ScheduleWriter writer;
+};
+
+/*
+    CSV Sink
+
+    Programmer's Note:
+        - Header line on construction; each row is formatted into the buffer in place.
+
+    Simpler Terms:
+        Payment plans as a spreadsheet-friendly file.
+ */
+class CsvSink : public ScheduleSink {
+public:
+    explicit CsvSink(ostream& out) : buffer(out) {
+        buffer.append("loan,payment_number,payment_amount,interest,principal,remaining_balance\n");
+    }
+
+    void beginLoan(const ScheduleLoanInfo& loan) override { loan_index = static_cast<long long>(loan.loan_index); }
+
+    void writeRows(span<const PaymentRow> rows) override {
+        for (const PaymentRow& row : rows) {
+            char* cursor = buffer.reserve(MAX_ROW);
+            cursor = appendNumber(cursor, loan_index);
+            *cursor++ = ',';
+            cursor = appendNumber(cursor, static_cast<long long>(row.payment_number));
+            *cursor++ = ',';
+            cursor = appendNumber(cursor, row.payment_amount);
+            *cursor++ = ',';
+            cursor = appendNumber(cursor, row.interest);
+            *cursor++ = ',';
+            cursor = appendNumber(cursor, row.principal);
+            *cursor++ = ',';
+            cursor = appendNumber(cursor, row.remaining_balance);
+            *cursor++ = '\n';
+            buffer.commit(cursor);
+        }
+    }
+
+    void finish() override { buffer.flush(); }
+
+private:
+    static constexpr size_t MAX_ROW = 2 * 24 + 4 * 32 + 6;
+
+    OutputBuffer buffer;
+    long long loan_index = 0;
+};
+
+/*
+    NDJSON Sink
+
+    Programmer's Note:
+        - One object per line, keys in column order. JSON has no NaN or infinity, so
+          non-finite values become null.
+
+    Simpler Terms:
+        Payment plans as one small JSON record per month.
+ */
+class NdjsonSink : public ScheduleSink {
+public:
+    explicit NdjsonSink(ostream& out) : buffer(out) {}
+
+    void beginLoan(const ScheduleLoanInfo& loan) override { loan_index = static_cast<long long>(loan.loan_index); }
+
+    void writeRows(span<const PaymentRow> rows) override {
+        for (const PaymentRow& row : rows) {
+            char* cursor = buffer.reserve(MAX_ROW);
+            cursor = appendText(cursor, "{\"loan\":");
+            cursor = appendNumber(cursor, loan_index);
+            cursor = appendText(cursor, ",\"payment_number\":");
+            cursor = appendNumber(cursor, static_cast<long long>(row.payment_number));
+            cursor = appendValue(appendText(cursor, ",\"payment_amount\":"), row.payment_amount);
+            cursor = appendValue(appendText(cursor, ",\"interest\":"), row.interest);
+            cursor = appendValue(appendText(cursor, ",\"principal\":"), row.principal);
+            cursor = appendValue(appendText(cursor, ",\"remaining_balance\":"), row.remaining_balance);
+            cursor = appendText(cursor, "}\n");
+            buffer.commit(cursor);
+        }
+    }
+
+    void finish() override { buffer.flush(); }
+
+private:
+    static constexpr size_t MAX_ROW = 2 * 24 + 4 * 32 + 96;    // Numbers plus keys and punctuation
+
+    static char* appendValue(char* cursor, double value) {
+        return isfinite(value) ? appendNumber(cursor, value) : appendText(cursor, "null");
+    }
+
+    OutputBuffer buffer;
+    long long loan_index = 0;
+};
+
+/*
+    Columnar Sink
+
+    Programmer's Note:
+        - Rows are split into six column arrays; a full group (COLUMNAR_GROUP_ROWS) is
+          written as its header plus one ostream::write per column, straight from the arrays.
+        - The loan table is collected as loans begin; finish() writes the last group, the
+          group table, the loan table and the trailer. Offsets are tracked by counting the
+          bytes written, so the stream never has to be seekable.
+
+    Simpler Terms:
+        Payment plans stored column by column, in big groups of rows.
+ */
+class ColumnarSink : public ScheduleSink {
+public:
+    explicit ColumnarSink(ostream& outStream) : out(outStream) {
+        loan_column.reserve(COLUMNAR_GROUP_ROWS);
+        payment_number.reserve(COLUMNAR_GROUP_ROWS);
+        payment_amount.reserve(COLUMNAR_GROUP_ROWS);
+        interest.reserve(COLUMNAR_GROUP_ROWS);
+        principal.reserve(COLUMNAR_GROUP_ROWS);
+        remaining_balance.reserve(COLUMNAR_GROUP_ROWS);
+        write(COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+    }
+
+    void beginLoan(const ScheduleLoanInfo& loan) override {
+        loan_index = static_cast<uint32_t>(loan.loan_index);
+        loans.push_back({ rows_written + interest.size(), static_cast<uint32_t>(max(0, loan.number_of_payments)),
+                          loan.total_years_to_repay, loan.loan_amount, loan.annual_interest_rate,
+                          loan.monthly_payment, loan.total_payback });
+    }
+
+    void writeRows(span<const PaymentRow> rows) override {
+        while (!rows.empty()) {
+            const size_t take = min(rows.size(), COLUMNAR_GROUP_ROWS - interest.size());
+            for (const PaymentRow& row : rows.first(take)) {
+                loan_column.push_back(loan_index);
+                payment_number.push_back(row.payment_number);
+                payment_amount.push_back(row.payment_amount);
+                interest.push_back(row.interest);
+                principal.push_back(row.principal);
+                remaining_balance.push_back(row.remaining_balance);
+            }
+            rows = rows.subspan(take);
+            if (interest.size() == COLUMNAR_GROUP_ROWS) {
+                writeGroup();
+            }
+        }
+    }
+
+    void finish() override {
+        writeGroup();
+
+        ColumnarTrailer trailer{};
+        trailer.group_count = groups.size();
+        trailer.row_count = rows_written;
+        trailer.loan_count = loans.size();
+        trailer.group_table_offset = offset;
+        write(groups.data(), groups.size() * sizeof(ColumnarGroupEntry));
+        trailer.loan_table_offset = offset;
+        write(loans.data(), loans.size() * sizeof(BinaryScheduleLoan));
+        memcpy(trailer.magic, COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+        write(&trailer, sizeof(trailer));
+    }
+
+private:
+    void write(const void* data, size_t bytes) {
+        out.write(static_cast<const char*>(data), static_cast<streamsize>(bytes));
+        perf_counters::add(perf_counters::Counter::BytesWritten, bytes);
+        offset += bytes;
+    }
+
+    // A 4-byte column, zero-padded to a multiple of 8 bytes
+    template <typename T>
+    void writePadded(const vector<T>& column) {
+        static_assert(sizeof(T) == 4);
+        write(column.data(), column.size() * sizeof(T));
+        if (column.size() % 2 != 0) {
+            const uint32_t pad = 0;
+            write(&pad, sizeof(pad));
+        }
+    }
+
+    void writeGroup() {
+        if (interest.empty()) {
+            return;
+        }
+
+        groups.push_back({ offset, interest.size() });
+        const ColumnarGroupHeader header{ interest.size(), rows_written };
+        write(&header, sizeof(header));
+        writePadded(loan_column);
+        writePadded(payment_number);
+        for (const vector<double>* column : { &payment_amount, &interest, &principal, &remaining_balance }) {
+            write(column->data(), column->size() * sizeof(double));
+        }
+
+        rows_written += interest.size();
+        loan_column.clear();
+        payment_number.clear();
+        payment_amount.clear();
+        interest.clear();
+        principal.clear();
+        remaining_balance.clear();
+    }
+
+    ostream& out;
+    uint64_t offset = 0;                    // Bytes written so far
+    uint64_t rows_written = 0;              // Rows in groups already written
+    uint32_t loan_index = 0;
+
+    vector<uint32_t> loan_column;           // Current group, one array per column
+    vector<int32_t> payment_number;
+    vector<double> payment_amount;
+    vector<double> interest;
+    vector<double> principal;
+    vector<double> remaining_balance;
+
+    vector<ColumnarGroupEntry> groups;
+    vector<BinaryScheduleLoan> loans;
+};
+
+/*
+    Row Blocks
+
+    Programmer's Note:
+        - A block is a fixed array of rows plus the list of loan pieces in it. A piece
+          says which rows belong to which loan and whether the loan starts or ends there,
+          which is all deliverBlock needs to replay beginLoan / writeRows / endLoan.
+
+    Simpler Terms:
+        A batch of computed months, labelled with the loans they belong to.
+ */
+struct LoanPiece {
+    ScheduleLoanInfo loan;
+    size_t begin;
+    size_t end;
+    bool starts_loan;
+    bool ends_loan;
+};
+
+struct RowBlock {
+    vector<PaymentRow> rows;                // Capacity: block_rows, never reallocated
+    size_t used = 0;
+    vector<LoanPiece> pieces;
+};
+
+void deliverBlock(const RowBlock& block, ScheduleSink& sink) {
+    for (const LoanPiece& piece : block.pieces) {
+        if (piece.starts_loan) {
+            sink.beginLoan(piece.loan);
+        }
+        if (piece.end > piece.begin) {
+            sink.writeRows(span<const PaymentRow>(block.rows.data() + piece.begin, piece.end - piece.begin));
+        }
+        if (piece.ends_loan) {
+            sink.endLoan();
+        }
+    }
+}
+
+/*
+    Class: BlockPipeline
+
+    Programmer's Note:
+        - Hands filled blocks from the producer to the sink, and empty ones back.
+        - Background mode: a writer thread takes full blocks in order from a queue, delivers
+          them and returns them to the free list; the producer blocks in acquire() only when
+          every block is in flight. close() waits for the queue to drain, then the writer
+          calls sink.finish() and exits.
+        - Inline mode: a single block, delivered by submit() on the calling thread.
+
+    Simpler Terms:
+        The conveyor belt between the part that does the math and the part that saves it.
+ */
+class BlockPipeline {
+public:
+    BlockPipeline(ScheduleSink& targetSink, const ScheduleExportOptions& options)
+        : sink(targetSink), background(options.background_writer) {
+        const size_t blockCount = background ? max<size_t>(options.blocks_in_flight, 2) : 1;
+        storage.resize(blockCount);
+        for (RowBlock& block : storage) {
+            block.rows.resize(max<size_t>(options.block_rows, 1));
+            free_blocks.push_back(&block);
+        }
+        if (background) {
+            writer = thread([this] { writerLoop(); });
+        }
+    }
+
+    ~BlockPipeline() {
+        close();
+    }
+
+    BlockPipeline(const BlockPipeline&) = delete;
+    BlockPipeline& operator=(const BlockPipeline&) = delete;
+
+    RowBlock* acquire() {
+        unique_lock<mutex> lock(queue_mutex);
+        if (free_blocks.empty()) {
+            const auto start = chrono::steady_clock::now();
+            block_returned.wait(lock, [this] { return !free_blocks.empty(); });
+            wait_seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        }
+        RowBlock* block = free_blocks.back();
+        free_blocks.pop_back();
+        block->used = 0;
+        block->pieces.clear();
+        return block;
+    }
+
+    void submit(RowBlock* block) {
+        ++submitted;
+        if (!background) {
+            deliverBlock(*block, sink);
+            free_blocks.push_back(block);
+            return;
+        }
+
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            full_blocks.push_back(block);
+        }
+        block_ready.notify_one();
+    }
+
+    void close() {
+        if (closed) {
+            return;
+        }
+        closed = true;
+
+        if (background) {
+            {
+                lock_guard<mutex> lock(queue_mutex);
+                producer_done = true;
+            }
+            block_ready.notify_one();
+            writer.join();
+        } else {
+            sink.finish();
+        }
+    }
+
+    [[nodiscard]] size_t blocksSubmitted() const { return submitted; }
+    [[nodiscard]] double waitSeconds() const { return wait_seconds; }
+
+private:
+    void writerLoop() {
+        for (;;) {
+            RowBlock* block;
+            {
+                unique_lock<mutex> lock(queue_mutex);
+                block_ready.wait(lock, [this] { return !full_blocks.empty() || producer_done; });
+                if (full_blocks.empty()) {
+                    break;
+                }
+                block = full_blocks.front();
+                full_blocks.pop_front();
+            }
+
+            deliverBlock(*block, sink);
+
+            {
+                lock_guard<mutex> lock(queue_mutex);
+                free_blocks.push_back(block);
+            }
+            block_returned.notify_one();
+        }
+        sink.finish();
+    }
+
+    ScheduleSink& sink;
+    const bool background;
+    bool closed = false;
+    size_t submitted = 0;
+    double wait_seconds = 0.0;
+
+    vector<RowBlock> storage;
+    mutex queue_mutex;                      // Guards the two block lists and producer_done
+    condition_variable block_ready;
+    condition_variable block_returned;
+    deque<RowBlock*> full_blocks;           // Waiting for the writer, in order
+    vector<RowBlock*> free_blocks;
+    bool producer_done = false;
+    thread writer;
+};
+
+} // namespace
+
+/*
+    Parse Schedule Format / Make Schedule Sink
+
+    Programmer's Note:
+        - The names are the lowercase format names, as used on the command line.
+
+    Simpler Terms:
+        Turns a format name into a writer for that format.
+ */
+bool parseScheduleFormat(const string& name, ScheduleFormat& format) {
+    if (name == "text") {
+        format = ScheduleFormat::Text;
+    } else if (name == "csv") {
+        format = ScheduleFormat::Csv;
+    } else if (name == "ndjson") {
+        format = ScheduleFormat::Ndjson;
+    } else if (name == "columnar") {
+        format = ScheduleFormat::Columnar;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+unique_ptr<ScheduleSink> makeScheduleSink(ScheduleFormat format, ostream& out) {
+    switch (format) {
+        case ScheduleFormat::Csv:      return make_unique<CsvSink>(out);
+        case ScheduleFormat::Ndjson:   return make_unique<NdjsonSink>(out);
+        case ScheduleFormat::Columnar: return make_unique<ColumnarSink>(out);
+        default:                       return make_unique<TextSink>(out);
+    }
+}
+
+/*
+    Export Schedules
+
+    Programmer's Note:
+        - The producer (calling thread) converts each record exactly as the Mortgage setters
+          do, so the summary values match outputPaymentSchedule, and writes the rows of
+          Mortgage::schedule() directly into the current block; a full block is submitted
+          and the loan continues in the next one.
+
+    Simpler Terms:
+        Works out every loan's payment plan and feeds it to the chosen file writer.
+ */
+ScheduleExportStats exportSchedules(span<const LoanRecord> loans, ScheduleSink& sink,
+                                    const ScheduleExportOptions& options) {
+    perf_counters::ScopedTimer timer(perf_counters::Phase::ScheduleWrite);
+    const auto start = chrono::steady_clock::now();
+    ScheduleExportStats stats;
+    BlockPipeline pipeline(sink, options);
+    Mortgage loan(false);  // Silent: exports must not log
+
+    RowBlock* block = pipeline.acquire();
+    for (size_t i = 0; i < loans.size(); ++i) {
+        const LoanRecord& record = loans[i];
+        loan.setLoanAmount(record.loan_amount);
+        loan.setAnnualInterestRate(record.annual_interest_rate);
+        loan.setTotalYearsToRepay(record.total_years_to_repay);
+
+        const double annual_interest_rate = record.annual_interest_rate / 100.0;  // As stored by the setter
+        const ScheduleLoanInfo info{ i, record.loan_amount, annual_interest_rate * 100, record.total_years_to_repay,
+                                     loan.getNumberOfPayments(), loan.getMonthlyPayment(), loan.getTotalPayback() };
+        block->pieces.push_back({ info, block->used, block->used, true, false });
+
+        for (const PaymentRow& row : loan.schedule()) {
+            if (block->used == block->rows.size()) {
+                block->pieces.back().end = block->used;
+                pipeline.submit(block);
+                block = pipeline.acquire();
+                block->pieces.push_back({ info, 0, 0, false, false });
+            }
+            block->rows[block->used++] = row;
+            ++stats.rows;
+        }
+
+        LoanPiece& last = block->pieces.back();
+        last.end = block->used;
+        last.ends_loan = true;
+    }
+
+    if (!block->pieces.empty()) {
+        pipeline.submit(block);
+    }
+    pipeline.close();
+
+    perf_counters::add(perf_counters::Counter::RowsGenerated, stats.rows);
+    stats.loans = loans.size();
+    stats.blocks = pipeline.blocksSubmitted();
+    stats.producer_wait_seconds = pipeline.waitSeconds();
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return stats;
+}
@@ -0,0 +1,184 @@
+// Schedule Sink Specification
+
+#ifndef SCHEDULE_SINK_H
+#define SCHEDULE_SINK_H
+
+#include "BatchPricer.h"
+#include "BinarySchedule.h"
+#include "Mortgage.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <span>
+#include <string>
+
+/*
+    Struct: ScheduleLoanInfo
+
+    Programmer's Note:
+        - What a sink is told about a loan before its rows: the loan's position in the
+          export, its terms (rate as a percentage, exactly as the text summary prints it),
+          level payment and total payback.
+
+    Simpler Terms:
+        The loan details that go at the top of each payment plan.
+ */
+struct ScheduleLoanInfo {
+    std::size_t loan_index;             // Position of the loan in the export (0-based)
+    double loan_amount;
+    double annual_interest_rate;        // Percentage, e.g. 4.75
+    int total_years_to_repay;
+    int number_of_payments;
+    double monthly_payment;
+    double total_payback;
+};
+
+/*
+    Class: ScheduleSink
+
+    Programmer's Note:
+        - The output end of a schedule export. For every loan a sink receives beginLoan,
+          then the loan's rows in order as one or more blocks (writeRows), then endLoan;
+          finish() comes once, after the last loan.
+        - A block is a span into the producer's storage, valid only for the call: sinks
+          format straight from it and keep nothing.
+        - Every call of one export comes from a single thread (the background writer when
+          exportSchedules runs one), so sinks need no locking. Sinks must not throw.
+        - New formats plug in by deriving from ScheduleSink; the built-in ones come from
+          makeScheduleSink.
+
+    Simpler Terms:
+        Anything that can receive payment plans: a text report, a CSV file, and so on.
+ */
+class ScheduleSink {
+public:
+    virtual ~ScheduleSink() = default;
+
+    virtual void beginLoan(const ScheduleLoanInfo& loan) = 0;
+    virtual void writeRows(std::span<const PaymentRow> rows) = 0;
+    virtual void endLoan() {}
+    virtual void finish() {}        // No more loans: write trailers and hand over buffered bytes
+};
+
+/*
+    Built-In Schedule Formats
+
+    Programmer's Note:
+        - Text: the outputPaymentSchedule layout (banner, summary, column headers, rows)
+          through ScheduleWriter, byte for byte; several loans give the reports back to back.
+        - Csv: one header line, then "loan,payment_number,payment_amount,interest,principal,
+          remaining_balance" per row. Numbers are shortest round-trip (std::to_chars), so
+          reading them back gives the exact doubles.
+        - Ndjson: one JSON object per row with the same fields and numbers (non-finite
+          values are written as null, which JSON requires).
+        - Columnar: the binary row-group layout below.
+        - All of them format into a 64 KiB buffer (or, for Columnar, write whole column
+          arrays) and hand the stream large blocks; nothing is allocated per row.
+        - makeScheduleSink does not own the stream; Columnar needs one opened in binary mode.
+
+    Simpler Terms:
+        The file types a payment plan can be saved as.
+ */
+enum class ScheduleFormat {
+    Text,
+    Csv,
+    Ndjson,
+    Columnar
+};
+
+bool parseScheduleFormat(const std::string& name, ScheduleFormat& format);     // "text", "csv", "ndjson", "columnar"
+std::unique_ptr<ScheduleSink> makeScheduleSink(ScheduleFormat format, std::ostream& out);
+
+/*
+    Columnar Schedule File Layout (version 1, native little-endian)
+
+    Programmer's Note:
+        - Starts with the 8-byte magic "MTGCOLS1", followed by row groups of up to
+          COLUMNAR_GROUP_ROWS rows each. Rows are in export order (all of loan 0, then loan 1, ...).
+        - A row group is a ColumnarGroupHeader, then its columns one after another:
+              uint32  loan_index[rows]          (padded to a multiple of 8 bytes)
+              int32   payment_number[rows]      (padded to a multiple of 8 bytes)
+              double  payment_amount[rows]
+              double  interest[rows]
+              double  principal[rows]
+              double  remaining_balance[rows]
+        - After the last group: the group table (group_count ColumnarGroupEntry), the loan
+          table (loan_count BinaryScheduleLoan, the same entries as the binary schedule
+          format), then the ColumnarTrailer as the very last 48 bytes. Like Parquet, a
+          reader starts from the trailer, so the writer never has to seek back.
+
+    Simpler Terms:
+        A compact file that stores each column of the payment plans together, so tools
+        that only need, say, the interest can read just that.
+ */
+inline constexpr std::size_t COLUMNAR_GROUP_ROWS = 65536;
+
+struct ColumnarGroupHeader {
+    std::uint64_t row_count;            // Rows in this group
+    std::uint64_t first_row;            // Index of the group's first row in the export
+};
+
+struct ColumnarGroupEntry {
+    std::uint64_t offset;               // Byte offset of the group's ColumnarGroupHeader
+    std::uint64_t row_count;
+};
+
+struct ColumnarTrailer {
+    std::uint64_t group_count;
+    std::uint64_t row_count;
+    std::uint64_t loan_count;
+    std::uint64_t group_table_offset;
+    std::uint64_t loan_table_offset;
+    char magic[8];                      // "MTGCOLS1" again, so truncated files are detected
+};
+
+static_assert(sizeof(ColumnarGroupHeader) == 16, "group header layout is part of the file format");
+static_assert(sizeof(ColumnarGroupEntry) == 16, "group table layout is part of the file format");
+static_assert(sizeof(ColumnarTrailer) == 48, "trailer layout is part of the file format");
+
+/*
+    Schedule Export Options / Statistics
+
+    Programmer's Note:
+        - background_writer runs the sink on its own thread: the calling thread computes
+          rows into blocks of block_rows while the writer formats and writes earlier ones.
+          At most blocks_in_flight blocks exist, so memory stays bounded and a slow disk
+          makes the producer wait (producer_wait_seconds) instead of piling up rows.
+        - Without it, each block is handed to the sink as soon as it fills, on the caller.
+
+    Simpler Terms:
+        Settings for saving many payment plans, and what happened when they were saved.
+ */
+struct ScheduleExportOptions {
+    bool background_writer = true;          // Format and write on a separate thread
+    std::size_t block_rows = 16384;         // Rows per block handed to the sink
+    std::size_t blocks_in_flight = 4;       // Blocks the producer may be ahead of the writer
+};
+
+struct ScheduleExportStats {
+    std::size_t loans = 0;
+    std::size_t rows = 0;
+    std::size_t blocks = 0;                 // Blocks handed to the sink
+    double seconds = 0.0;
+    double producer_wait_seconds = 0.0;     // Time the producer waited for a free block
+};
+
+/*
+    Function: exportSchedules
+
+    Programmer's Note:
+        - Computes every loan's schedule (a silent Mortgage per loan, rows straight from
+          Mortgage::schedule() into the current block, so they are exactly the rows
+          outputPaymentSchedule prints) and streams the blocks to 'sink'. A loan's rows may
+          span blocks; the sink sees beginLoan / writeRows... / endLoan either way.
+        - Calls sink.finish() before returning, once everything has been written.
+
+    Simpler Terms:
+        Works out the payment plans of many loans and saves them in the chosen format,
+        doing the math and the saving at the same time.
+ */
+ScheduleExportStats exportSchedules(std::span<const LoanRecord> loans, ScheduleSink& sink,
+                                    const ScheduleExportOptions& options = {});
+
+#endif // SCHEDULE_SINK_H
@@ -0,0 +1,203 @@
+// ScheduleWriter Class Implementation
+
+#include "ScheduleWriter.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+
+using namespace std;
+
+namespace {
+
+constexpr string_view BANNER_MESSAGE = " Mortgage Payment Schedule ";  // Title inside the banner
+constexpr size_t BANNER_WIDTH = 60;                                     // Width of the '=' borders
+constexpr size_t PADDING = 4;                                           // Space between columns
+
+// Header labels; each column is exactly as wide as its label
+constexpr string_view HEADERS[] = { "Pmt#", "Payment Amount", "Interest", "Principal", "Remaining Balance" };
+
+} // namespace
+
+/*
+    Constructor & Destructor
+
+    Programmer's Note:
+        - The destructor writes out anything still buffered.
+
+    Simpler Terms:
+        Sets up the writer, and makes sure nothing is lost when it is done.
+ */
+ScheduleWriter::ScheduleWriter(ostream& outStream) : out(outStream) {
+}
+
+ScheduleWriter::~ScheduleWriter() {
+    flush();
+}
+
+/*
+    Flush
+
+    Programmer's Note:
+        - One ostream::write per 64 KiB of text.
+
+    Simpler Terms:
+        Sends the collected text to the file.
+ */
+void ScheduleWriter::flush() {
+    if (used > 0) {
+        out.write(buffer, static_cast<streamsize>(used));
+        perf_counters::add(perf_counters::Counter::BytesWritten, used);
+        used = 0;
+    }
+}
+
+/*
+    Buffer Helpers
+
+    Programmer's Note:
+        - reserve() flushes early so the next field always fits.
+        - appendRight() reproduces setw(width) with right alignment: pad on the left,
+          never truncate a value wider than its column.
+
+    Simpler Terms:
+        Small tools that add text and spaces to the buffer.
+ */
+void ScheduleWriter::reserve(size_t bytes) {
+    if (used + bytes > BUFFER_SIZE) {
+        flush();
+    }
+}
+
+void ScheduleWriter::append(const char* text, size_t length) {
+    reserve(length);
+    memcpy(buffer + used, text, length);
+    used += length;
+}
+
+void ScheduleWriter::appendFill(char fill, size_t count) {
+    reserve(count);
+    memset(buffer + used, fill, count);
+    used += count;
+}
+
+void ScheduleWriter::appendRight(const char* text, size_t length, size_t width) {
+    if (length < width) {
+        appendFill(' ', width - length);
+    }
+    append(text, length);
+}
+
+void ScheduleWriter::appendFixed(double value, size_t width) {
+    // Same digits as "fixed << setprecision(2)"
+    char digits[MAX_FIELD];
+    const char* end = to_chars(digits, digits + MAX_FIELD, value, chars_format::fixed, 2).ptr;
+    appendRight(digits, static_cast<size_t>(end - digits), width);
+}
+
+void ScheduleWriter::appendInteger(long long value, size_t width) {
+    char digits[24];
+    const char* end = to_chars(digits, digits + sizeof(digits), value).ptr;
+    appendRight(digits, static_cast<size_t>(end - digits), width);
+}
+
+/*
+    Write Banner
+
+    Programmer's Note:
+        - '=' border, title centered in the border width, '=' border, blank line.
+
+    Simpler Terms:
+        Writes the title box at the top of the file.
+ */
+void ScheduleWriter::writeBanner() {
+    appendFill('=', BANNER_WIDTH);
+    append("\n", 1);
+    appendRight(BANNER_MESSAGE.data(), BANNER_MESSAGE.size(), (BANNER_WIDTH + BANNER_MESSAGE.size()) / 2);
+    append("\n", 1);
+    appendFill('=', BANNER_WIDTH);
+    append("\n\n", 2);
+}
+
+/*
+    Write Summary
+
+    Programmer's Note:
+        - Loan details block, with the same label/column spacing as the original
+          setw-based output.
+
+    Simpler Terms:
+        Writes the loan amount, rate, years, monthly payment and total pay back.
+ */
+void ScheduleWriter::writeSummary(double loanAmount, double annualRatePercent, int years,
+                                  double monthlyPayment, double totalPayback) {
+    constexpr string_view loanLabel = "Loan Amount:";
+    append(loanLabel.data(), loanLabel.size());
+    appendRight("$", 1, 15);
+    appendFixed(loanAmount, 0);
+    append("\n", 1);
+
+    constexpr string_view rateLabel = "Annual Interest Rate:";
+    append(rateLabel.data(), rateLabel.size());
+    appendFixed(annualRatePercent, 9);
+    append("%\n", 2);
+
+    constexpr string_view yearsLabel = "Years to repay:";
+    append(yearsLabel.data(), yearsLabel.size());
+    appendInteger(years, 13);
+    append("\n", 1);
+
+    constexpr string_view paymentLabel = "Monthly Payment:";
+    append(paymentLabel.data(), paymentLabel.size());
+    appendRight("$", 1, 11);
+    appendFixed(monthlyPayment, 0);
+    append("\n", 1);
+
+    constexpr string_view totalLabel = "Total Pay Back:";
+    append(totalLabel.data(), totalLabel.size());
+    appendRight("$", 1, 12);
+    appendFixed(totalPayback, 0);
+    append("\n\n", 2);
+}
+
+/*
+    Write Column Headers
+
+    Programmer's Note:
+        - Each label is left-aligned in (label length + padding) characters,
+          including the last one, exactly as the original output.
+
+    Simpler Terms:
+        Writes the row of column names.
+ */
+void ScheduleWriter::writeColumnHeaders() {
+    for (string_view header : HEADERS) {
+        append(header.data(), header.size());
+        appendFill(' ', PADDING);
+    }
+    append("\n", 1);
+}
+
+/*
+    Write Row
+
+    Programmer's Note:
+        - Right-aligns each value to its header's width, with padding between columns.
+
+    Simpler Terms:
+        Writes one month of the payment plan.
+ */
+void ScheduleWriter::writeRow(const PaymentRow& row) {
+    appendInteger(row.payment_number, HEADERS[0].size());
+    appendFill(' ', PADDING);
+    appendFixed(row.payment_amount, HEADERS[1].size());
+    appendFill(' ', PADDING);
+    appendFixed(row.interest, HEADERS[2].size());
+    appendFill(' ', PADDING);
+    appendFixed(row.principal, HEADERS[3].size());
+    appendFill(' ', PADDING);
+    appendFixed(row.remaining_balance, HEADERS[4].size());
+    append("\n", 1);
+}
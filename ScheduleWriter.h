@@ -0,0 +1,77 @@
+// ScheduleWriter Class Specification
+
+#ifndef SCHEDULE_WRITER_H
+#define SCHEDULE_WRITER_H
+
+#include "Mortgage.h"
+#include <cstddef>
+#include <iosfwd>
+
+/*
+    Class: ScheduleWriter
+
+    Programmer's Note:
+        - Produces the text layout of outputPaymentSchedule (banner, loan summary,
+          column headers, one right-aligned row per payment) byte for byte.
+        - Numbers are formatted with std::to_chars into a fixed 64 KiB buffer that is
+          handed to the stream in large blocks; nothing is allocated and nothing is
+          flushed per row.
+        - Callers supply rows one at a time, so a schedule can be computed and written
+          in a single pass.
+
+    Simpler Terms:
+        Writes the payment plan text quickly by building it in memory
+        and saving it in big pieces.
+ */
+class ScheduleWriter {
+private:
+    static constexpr std::size_t BUFFER_SIZE = 64 * 1024;   // Bytes collected before each write
+    static constexpr std::size_t MAX_FIELD = 400;           // Longest possible formatted double
+
+    std::ostream& out;
+    char buffer[BUFFER_SIZE];
+    std::size_t used = 0;
+
+    void reserve(std::size_t bytes);
+    void append(const char* text, std::size_t length);
+    void appendFill(char fill, std::size_t count);
+    void appendRight(const char* text, std::size_t length, std::size_t width);
+    void appendFixed(double value, std::size_t width);
+    void appendInteger(long long value, std::size_t width);
+
+public:
+    /*
+        Constructor & Destructor
+
+        Programmer's Note:
+            - The writer does not own the stream; the destructor flushes whatever is buffered.
+
+        Simpler Terms:
+            Connects the writer to a file or other output, and saves the rest when done.
+     */
+    explicit ScheduleWriter(std::ostream& outStream);
+    ~ScheduleWriter();
+
+    ScheduleWriter(const ScheduleWriter&) = delete;
+    ScheduleWriter& operator=(const ScheduleWriter&) = delete;
+
+    /*
+        Schedule Sections
+
+        Programmer's Note:
+            - Call in order: writeBanner, writeSummary, writeColumnHeaders, then writeRow
+              once per payment. annualRatePercent is the rate as a percentage (4.75).
+
+        Simpler Terms:
+            The title, the loan details, the column names, and then each month.
+     */
+    void writeBanner();
+    void writeSummary(double loanAmount, double annualRatePercent, int years,
+                      double monthlyPayment, double totalPayback);
+    void writeColumnHeaders();
+    void writeRow(const PaymentRow& row);
+
+    void flush();   // Hands buffered text to the stream (does not flush the stream itself)
+};
+
+#endif // SCHEDULE_WRITER_H
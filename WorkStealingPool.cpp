@@ -0,0 +1,202 @@
+// WorkStealingPool Class Implementation
+
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+using namespace std;
+
+/*
+    Constructor
+
+    Programmer's Note:
+        - Creates threadCount - 1 workers; the thread calling parallelFor is the last one.
+
+    Simpler Terms:
+        Starts the helper threads and gives each one its own to-do list.
+ */
+WorkStealingPool::WorkStealingPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+
+    for (unsigned i = 0; i < threadCount; ++i) {
+        queues.push_back(make_unique<WorkerQueue>());
+    }
+
+    for (unsigned i = 0; i + 1 < threadCount; ++i) {
+        workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+/*
+    Destructor
+
+    Programmer's Note:
+        - Wakes every worker with the stop flag set and joins them.
+
+    Simpler Terms:
+        Tells the helper threads to finish and waits for them.
+ */
+WorkStealingPool::~WorkStealingPool() {
+    {
+        lock_guard<mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/*
+    Thread Count
+
+    Programmer's Note:
+        - Includes the calling thread, which always takes part in parallelFor.
+
+    Simpler Terms:
+        How many threads share the work.
+ */
+unsigned WorkStealingPool::threadCount() const {
+    return static_cast<unsigned>(queues.size());
+}
+
+/*
+    Parallel For
+
+    Programmer's Note:
+        - Seeds the caller's deque with the whole range, wakes the workers,
+          and helps until every item has been processed.
+
+    Simpler Terms:
+        Hands out the job, joins in, and returns when all of it is done.
+ */
+void WorkStealingPool::parallelFor(size_t count, size_t grainSize,
+                                   const function<void(size_t, size_t)>& rangeBody) {
+    if (count == 0) {
+        return;
+    }
+
+    lock_guard<mutex> job(job_mutex);
+    const size_t callerIndex = queues.size() - 1;
+
+    body = &rangeBody;
+    grain = max<size_t>(1, grainSize);
+    remaining.store(count);
+    {
+        lock_guard<mutex> lock(queues[callerIndex]->mutex);
+        queues[callerIndex]->ranges.push_back({ 0, count });
+    }
+
+    {
+        lock_guard<mutex> lock(sleep_mutex);
+        ++generation;
+    }
+    wake.notify_all();
+
+    runRanges(callerIndex);
+    body = nullptr;
+}
+
+/*
+    Worker Loop
+
+    Programmer's Note:
+        - Sleeps until a new job generation starts (or the pool stops), then works on it.
+
+    Simpler Terms:
+        What each helper thread does all day: wait for work, then do it.
+ */
+void WorkStealingPool::workerLoop(size_t index) {
+    size_t seen = 0;
+
+    while (true) {
+        {
+            unique_lock<mutex> lock(sleep_mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        runRanges(index);
+    }
+}
+
+/*
+    Run Ranges
+
+    Programmer's Note:
+        - Takes work from the local deque, or steals it, until the job is finished.
+        - Large ranges are split in half repeatedly; the upper halves go back on the
+          local deque where other threads can steal them.
+
+    Simpler Terms:
+        Keeps doing pieces of the job until nothing is left.
+ */
+void WorkStealingPool::runRanges(size_t index) {
+    while (remaining.load(memory_order_acquire) > 0) {
+        Range range;
+        if (!popLocal(index, range) && !steal(index, range)) {
+            this_thread::yield();  // Others still hold the last pieces
+            continue;
+        }
+
+        while (range.end - range.begin > grain) {
+            const size_t mid = range.begin + (range.end - range.begin) / 2;
+            {
+                lock_guard<mutex> lock(queues[index]->mutex);
+                queues[index]->ranges.push_back({ mid, range.end });
+            }
+            range.end = mid;
+        }
+
+        (*body)(range.begin, range.end);
+        remaining.fetch_sub(range.end - range.begin, memory_order_acq_rel);
+    }
+}
+
+/*
+    Pop Local
+
+    Programmer's Note:
+        - Newest range from this thread's own deque (best cache locality).
+
+    Simpler Terms:
+        Takes the next piece from my own list.
+ */
+bool WorkStealingPool::popLocal(size_t index, Range& range) {
+    WorkerQueue& queue = *queues[index];
+    lock_guard<mutex> lock(queue.mutex);
+    if (queue.ranges.empty()) {
+        return false;
+    }
+    range = queue.ranges.back();
+    queue.ranges.pop_back();
+    return true;
+}
+
+/*
+    Steal
+
+    Programmer's Note:
+        - Oldest (largest) range from another thread's deque, scanning victims
+          starting after this thread so thieves spread across victims.
+
+    Simpler Terms:
+        Takes a piece from a teammate who still has work.
+ */
+bool WorkStealingPool::steal(size_t index, Range& range) {
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        WorkerQueue& victim = *queues[(index + offset) % queues.size()];
+        lock_guard<mutex> lock(victim.mutex);
+        if (!victim.ranges.empty()) {
+            range = victim.ranges.front();
+            victim.ranges.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
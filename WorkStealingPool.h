@@ -0,0 +1,97 @@
+// WorkStealingPool Class Specification
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+    Class: WorkStealingPool
+
+    Programmer's Note:
+        - Fixed set of worker threads, each with its own deque of index ranges.
+        - A worker takes ranges from the back of its own deque and splits anything larger
+          than the grain size in half, pushing the other half back; idle workers steal
+          from the front of other deques. Expensive pieces of work (e.g. 40-year loans)
+          therefore spread out on their own, without any up-front cost estimate.
+        - parallelFor blocks until the whole range is done; the calling thread works too.
+        - One parallelFor runs at a time; concurrent callers are serialized.
+          The body must not throw.
+
+    Simpler Terms:
+        A team of threads that shares out a big job; whoever runs out of work
+        takes some from a busy teammate.
+ */
+class WorkStealingPool {
+private:
+    struct Range {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;  // One per worker, plus one for the caller
+    std::vector<std::thread> workers;
+
+    std::mutex job_mutex;                   // Serializes parallelFor calls
+    std::mutex sleep_mutex;                 // Guards generation/stopping for the condition variable
+    std::condition_variable wake;
+    std::size_t generation = 0;             // Incremented for every new job
+    bool stopping = false;
+
+    const std::function<void(std::size_t, std::size_t)>* body = nullptr;  // Current job
+    std::size_t grain = 1;                  // Ranges at or below this size are not split
+    std::atomic<std::size_t> remaining{0};  // Items of the current job not yet finished
+
+    void workerLoop(std::size_t index);
+    void runRanges(std::size_t index);
+    bool popLocal(std::size_t index, Range& range);
+    bool steal(std::size_t index, Range& range);
+
+public:
+    /*
+        Constructor & Destructor
+
+        Programmer's Note:
+            - threadCount is the total parallelism including the calling thread;
+              0 means std::thread::hardware_concurrency().
+            - The destructor stops and joins all workers.
+
+        Simpler Terms:
+            Starts the helper threads, and stops them when the pool goes away.
+     */
+    explicit WorkStealingPool(unsigned threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    [[nodiscard]] unsigned threadCount() const;    // Worker threads plus the calling thread
+
+    /*
+        Parallel For
+
+        Programmer's Note:
+            - Calls body(begin, end) on disjoint sub-ranges covering [0, count),
+              each at most 'grainSize' long, from any thread of the pool.
+
+        Simpler Terms:
+            Splits the numbers 0 to count-1 into pieces and handles the pieces in parallel.
+     */
+    void parallelFor(std::size_t count, std::size_t grainSize,
+                     const std::function<void(std::size_t, std::size_t)>& rangeBody);
+};
+
+#endif // WORK_STEALING_POOL_H
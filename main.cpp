@@ -17,16 +17,466 @@
 
         The program demonstrates class encapsulation, member functions,
         constructors/destructors, and file output operations.
+
+        Batch mode (no prompts, no INFO logging):
+            Lab13aMortgage --batch <input|-> [--output <file|->]
+                           [--input-format csv|binary] [--output-format csv|binary]
+                           [--precision fast|extended]
+
+        Binary schedule file to text (one loan, 0-based index):
+            Lab13aMortgage --schedule-to-text <schedule.bin> <loan-index> [output|-]
+
+        Quote server on a Unix domain socket (Linux; stop with Ctrl+C or SIGTERM):
+            Lab13aMortgage --serve <socket> [--max-batch N] [--stats-interval seconds]
+
+        Bulk loan-tape ingestion (validate a large CSV, write rejected records with reasons):
+            Lab13aMortgage --ingest <tape.csv> [--rejects <file>] [--threads N]
+
+        Schedule export for a loan file (text, CSV, NDJSON, columnar or binary schedule file):
+            Lab13aMortgage --export-schedules <loans.csv> [--output <file|->]
+                           [--format text|csv|ndjson|columnar|binary|binary-fixed]
+                           [--writer background|inline]
 */
 
 #include "Banner.h"
+#include "BatchPricer.h"
+#include "BinarySchedule.h"
+#include "LoanTape.h"
 #include "Mortgage.h"
+#include "QuoteServer.h"
+#include "ScheduleSink.h"
+#include <charconv>
+#include <csignal>
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <limits>
+#include <memory>
 #include <iomanip>
+#include <vector>
 using namespace std;
 
+/*
+    Function: parseBatchFormat
+
+    Programmer's Note:
+        - Converts a --input-format / --output-format value to a BatchFormat.
+        - Returns false for anything other than "csv" or "binary".
+
+    Simpler Terms:
+        Turns the word "csv" or "binary" into the matching file format.
+ */
+static bool parseBatchFormat(const string& name, BatchFormat& format) {
+    if (name == "csv") {
+        format = BatchFormat::Csv;
+        return true;
+    }
+    if (name == "binary") {
+        format = BatchFormat::Binary;
+        return true;
+    }
+    return false;
+}
+
+/*
+    Function: parseArgument
+
+    Programmer's Note:
+        - Parses a whole command-line value with std::from_chars (no exceptions, no
+          locale). Returns false for empty text, trailing characters, a leading sign
+          on an unsigned type, or a value out of range, leaving 'value' unchanged.
+
+    Simpler Terms:
+        Reads a number typed on the command line, and says so if it isn't one.
+ */
+template <typename T>
+static bool parseArgument(const string& text, T& value) {
+    T parsed{};
+    const char* last = text.data() + text.size();
+    const auto [end, error] = from_chars(text.data(), last, parsed);
+    if (error != errc() || end != last) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+/*
+    Function: runBatchMode
+
+    Programmer's Note:
+        - Non-interactive entry point selected with --batch.
+        - Reads loans from a file (or stdin when the name is "-"), prices them,
+          and writes the quotes to a file (or stdout by default).
+        - Prints nothing to stdout except the quotes themselves; problems go to stderr.
+        - --precision extended prices in the correctly rounded audit mode (slower).
+
+    Simpler Terms:
+        Prices a whole file of loans at once instead of asking questions one loan at a time.
+ */
+static int runBatchMode(int argc, char* argv[]) {
+    string inputName = "-";
+    string outputName = "-";
+    BatchFormat inputFormat = BatchFormat::Csv;
+    BatchFormat outputFormat = BatchFormat::Csv;
+    PaymentPrecision precision = PaymentPrecision::Fast;
+
+    // argv[1] is "--batch"; the optional input name follows it
+    int arg = 2;
+    if (arg < argc && string(argv[arg]).rfind("--", 0) != 0) {
+        inputName = argv[arg++];
+    }
+
+    for (; arg < argc; ++arg) {
+        const string option = argv[arg];
+        if (arg + 1 >= argc) {
+            cerr << "ERROR: missing value for " << option << "." << endl;
+            return 1;
+        }
+
+        const string value = argv[++arg];
+        if (option == "--output") {
+            outputName = value;
+        } else if (option == "--input-format" && parseBatchFormat(value, inputFormat)) {
+            continue;
+        } else if (option == "--output-format" && parseBatchFormat(value, outputFormat)) {
+            continue;
+        } else if (option == "--precision" && (value == "fast" || value == "extended")) {
+            precision = value == "extended" ? PaymentPrecision::Extended : PaymentPrecision::Fast;
+        } else {
+            cerr << "ERROR: unrecognized batch option " << option << " " << value << "." << endl;
+            return 1;
+        }
+    }
+
+    // Open the input and output files unless standard input/output was requested
+    ifstream inFile;
+    ofstream outFile;
+    if (inputName != "-") {
+        inFile.open(inputName, ios::binary);
+        if (!inFile) {
+            cerr << "ERROR: Could not open file " << inputName << " for reading." << endl;
+            return 1;
+        }
+    }
+    if (outputName != "-") {
+        outFile.open(outputName, ios::binary);
+        if (!outFile) {
+            cerr << "ERROR: Could not open file " << outputName << " for writing." << endl;
+            return 1;
+        }
+    }
+
+    // Standard streams are not mixed with C stdio here, so drop the synchronization cost
+    ios::sync_with_stdio(false);
+
+    istream& in = inputName == "-" ? cin : static_cast<istream&>(inFile);
+    ostream& out = outputName == "-" ? cout : static_cast<ostream&>(outFile);
+
+    const BatchStats stats = priceLoanStream(in, out, inputFormat, outputFormat, precision);
+    cerr << "INFO: priced " << stats.loans_priced << " loans ("
+         << stats.malformed_records << " malformed records, " << stats.invalid_records
+         << " invalid loans)." << endl;
+
+    return out ? 0 : 1;
+}
+
+/*
+    Function: runScheduleToText
+
+    Programmer's Note:
+        - Converts one loan of a binary schedule file (see BinarySchedule.h)
+          to the text layout of outputPaymentSchedule.
+        - Writes to standard output when no output file (or "-") is given.
+
+    Simpler Terms:
+        Turns one loan from a binary schedule file into the usual text table.
+ */
+static int runScheduleToText(int argc, char* argv[]) {
+    if (argc < 4) {
+        cerr << "ERROR: usage: --schedule-to-text <schedule.bin> <loan-index> [output|-]" << endl;
+        return 1;
+    }
+
+    const BinaryScheduleReader reader(argv[2]);
+    if (!reader.isOpen()) {
+        return 1;
+    }
+
+    size_t index = 0;
+    if (!parseArgument(argv[3], index)) {
+        cerr << "ERROR: usage: --schedule-to-text <schedule.bin> <loan-index> [output|-]" << endl;
+        return 1;
+    }
+    if (index >= reader.loanCount()) {
+        cerr << "ERROR: loan index " << index << " is out of range (file has "
+             << reader.loanCount() << " loans)." << endl;
+        return 1;
+    }
+
+    const string outputName = argc > 4 ? argv[4] : "-";
+    if (outputName == "-") {
+        writeScheduleText(reader, index, cout);
+        return cout ? 0 : 1;
+    }
+
+    ofstream outFile(outputName, ios::binary);
+    if (!outFile) {
+        cerr << "ERROR: Could not open file " << outputName << " for writing." << endl;
+        return 1;
+    }
+    writeScheduleText(reader, index, outFile);
+    return outFile ? 0 : 1;
+}
+
+/*
+    Function: runServeMode
+
+    Programmer's Note:
+        - Long-running quote server selected with --serve (see QuoteServer.h for the
+          request format). Runs until SIGINT or SIGTERM, then prints its totals.
+
+    Simpler Terms:
+        Keeps the calculator running so other programs can ask it for quotes.
+ */
+static QuoteServer* activeServer = nullptr;
+
+static void stopServer(int) {
+    if (activeServer != nullptr) {
+        activeServer->requestStop();
+    }
+}
+
+static int runServeMode(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "ERROR: usage: --serve <socket> [--max-batch N] [--stats-interval seconds]" << endl;
+        return 1;
+    }
+
+    QuoteServerConfig config;
+    config.socket_path = argv[2];
+    for (int arg = 3; arg < argc; ++arg) {
+        const string option = argv[arg];
+        if (arg + 1 >= argc) {
+            cerr << "ERROR: missing value for " << option << "." << endl;
+            return 1;
+        }
+
+        const string value = argv[++arg];
+        bool valid = false;
+        if (option == "--max-batch") {
+            valid = parseArgument(value, config.max_batch);
+        } else if (option == "--stats-interval") {
+            // The interval becomes a clock duration, so NaN and huge values are refused
+            valid = parseArgument(value, config.stats_interval_seconds)
+                 && config.stats_interval_seconds >= 0.0 && config.stats_interval_seconds <= 1e6;
+        } else {
+            cerr << "ERROR: unrecognized serve option " << option << " " << value << "." << endl;
+            return 1;
+        }
+
+        if (!valid) {
+            cerr << "ERROR: usage: --serve <socket> [--max-batch N] [--stats-interval seconds]" << endl;
+            return 1;
+        }
+    }
+
+    QuoteServer server(config);
+    if (!server.open()) {
+        return 1;
+    }
+
+    activeServer = &server;
+    signal(SIGINT, stopServer);
+    signal(SIGTERM, stopServer);
+    cerr << "INFO: serving quotes on " << config.socket_path << "." << endl;
+    const bool served = server.run();
+    activeServer = nullptr;
+    return served ? 0 : 1;
+}
+
+/*
+    Function: runIngestMode
+
+    Programmer's Note:
+        - Loads a loan tape with loadLoanTape (see LoanTape.h) on a pool of --threads
+          threads (default: all cores), then prices the loaded book once.
+        - Reports counts, throughput and each reject reason on cerr; rejected records go to
+          the --rejects file when one is given.
+
+    Simpler Terms:
+        Checks a big loan file, keeps the good loans, and says how many were bad and why.
+ */
+static int runIngestMode(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "ERROR: usage: --ingest <tape.csv> [--rejects <file>] [--threads N]" << endl;
+        return 1;
+    }
+
+    LoanTapeOptions options;
+    unsigned threads = 0;
+    for (int arg = 3; arg < argc; ++arg) {
+        const string option = argv[arg];
+        if (arg + 1 >= argc) {
+            cerr << "ERROR: missing value for " << option << "." << endl;
+            return 1;
+        }
+
+        const string value = argv[++arg];
+        if (option == "--rejects") {
+            options.reject_path = value;
+        } else if (option == "--threads") {
+            if (!parseArgument(value, threads)) {
+                cerr << "ERROR: usage: --ingest <tape.csv> [--rejects <file>] [--threads N]" << endl;
+                return 1;
+            }
+        } else {
+            cerr << "ERROR: unrecognized ingest option " << option << " " << value << "." << endl;
+            return 1;
+        }
+    }
+
+    WorkStealingPool pool(threads);
+    LoanBook book;
+    LoanTapeStats stats;
+    if (!loadLoanTape(argv[2], book, pool, stats, options)) {
+        return 1;
+    }
+
+    vector<double> payments(book.size());
+    book.computeMonthlyPayments(payments);
+    double monthlyTotal = 0.0;
+    for (double payment : payments) {
+        monthlyTotal += payment;
+    }
+
+    cerr << fixed << setprecision(2)
+         << "INFO: loaded " << stats.loans_loaded << " loans, rejected " << stats.loans_rejected
+         << " records (" << stats.lines << " lines, " << stats.bytes / 1.0e6 << " MB in "
+         << stats.seconds * 1000.0 << " ms, " << stats.bytes / 1.0e9 / max(stats.seconds, 1e-9)
+         << " GB/s on " << pool.threadCount() << " threads)." << endl;
+    for (size_t reason = 1; reason < LOAN_CHECK_COUNT; ++reason) {
+        if (stats.rejected_by_reason[reason] > 0) {
+            cerr << "INFO:   " << loanCheckName(static_cast<LoanCheck>(reason)) << ": "
+                 << stats.rejected_by_reason[reason] << endl;
+        }
+    }
+    cerr << "INFO: total monthly payments $" << monthlyTotal << "." << endl;
+    return 0;
+}
+
+/*
+    Function: runExportMode
+
+    Programmer's Note:
+        - Reads "amount,rate,years" lines (the batch CSV syntax; a header line is skipped),
+          keeps the loans checkLoan accepts, and exports their schedules with
+          exportSchedules through the sink for --format (default text).
+        - --format binary / binary-fixed writes a binary schedule file instead
+          (writeBinarySchedules, Float64 / FixedPoint encoding; see BinarySchedule.h), which
+          --schedule-to-text reads back. It is memory-mapped, so it needs a real --output file.
+        - The sink runs on a background writer thread unless --writer inline is given.
+        - Skipped records and the export totals are reported on cerr; a failed write
+          (disk full, closed pipe) gives an ERROR line and status 1 instead.
+
+    Simpler Terms:
+        Saves the payment plans of every loan in a file, in the format another program needs.
+ */
+static int runExportMode(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "ERROR: usage: --export-schedules <loans.csv> [--output <file|->]"
+                " [--format text|csv|ndjson|columnar|binary|binary-fixed] [--writer background|inline]" << endl;
+        return 1;
+    }
+
+    string outputName = "-";
+    ScheduleFormat format = ScheduleFormat::Text;
+    bool binary = false;
+    ScheduleEncoding encoding = ScheduleEncoding::Float64;
+    ScheduleExportOptions options;
+    for (int arg = 3; arg < argc; ++arg) {
+        const string option = argv[arg];
+        if (arg + 1 >= argc) {
+            cerr << "ERROR: missing value for " << option << "." << endl;
+            return 1;
+        }
+
+        const string value = argv[++arg];
+        if (option == "--output") {
+            outputName = value;
+        } else if (option == "--format" && parseScheduleFormat(value, format)) {
+            binary = false;
+        } else if (option == "--format" && (value == "binary" || value == "binary-fixed")) {
+            binary = true;
+            encoding = value == "binary" ? ScheduleEncoding::Float64 : ScheduleEncoding::FixedPoint;
+        } else if (option == "--writer" && (value == "background" || value == "inline")) {
+            options.background_writer = value == "background";
+        } else {
+            cerr << "ERROR: unrecognized export option " << option << " " << value << "." << endl;
+            return 1;
+        }
+    }
+
+    ifstream inFile(argv[2], ios::binary);
+    if (!inFile) {
+        cerr << "ERROR: Could not open file " << argv[2] << " for reading." << endl;
+        return 1;
+    }
+
+    vector<LoanRecord> loans;
+    size_t skipped = 0;
+    string line;
+    for (size_t lineNumber = 1; getline(inFile, line); ++lineNumber) {
+        const char* first = line.data();
+        const char* last = first + line.size();
+        LoanRecord record{};
+        if (parseLoanCsvLine(first, last, record) && checkLoan(record) == LoanCheck::Valid) {
+            loans.push_back(record);
+        } else if (!(lineNumber == 1 && looksLikeCsvHeader(first, last)) && first != last) {
+            ++skipped;
+        }
+    }
+
+    if (binary) {
+        if (outputName == "-") {
+            cerr << "ERROR: binary schedule files need an --output file." << endl;
+            return 1;
+        }
+        if (!writeBinarySchedules(outputName, loans, encoding)) {
+            return 1;
+        }
+        cerr << "INFO: wrote " << loans.size() << " loans to " << outputName << "; skipped "
+             << skipped << " records." << endl;
+        return 0;
+    }
+
+    ofstream outFile;
+    if (outputName != "-") {
+        outFile.open(outputName, ios::binary);
+        if (!outFile) {
+            cerr << "ERROR: Could not open file " << outputName << " for writing." << endl;
+            return 1;
+        }
+    }
+    ios::sync_with_stdio(false);
+    ostream& out = outputName == "-" ? cout : static_cast<ostream&>(outFile);
+
+    const unique_ptr<ScheduleSink> sink = makeScheduleSink(format, out);
+    const ScheduleExportStats stats = exportSchedules(loans, *sink, options);
+    out.flush();
+    if (!out) {
+        cerr << "ERROR: Could not write schedules to " << (outputName == "-" ? "standard output" : outputName)
+             << "." << endl;
+        return 1;
+    }
+
+    cerr << fixed << setprecision(2)
+         << "INFO: exported " << stats.loans << " loans (" << stats.rows << " rows, "
+         << stats.blocks << " blocks) in " << stats.seconds * 1000.0 << " ms; skipped "
+         << skipped << " records." << endl;
+    return 0;
+}
+
 /*
     Function: main
 
@@ -35,13 +485,38 @@ using namespace std;
         - Repeatedly prompts for loan details, calculates results, and offers
           the option to process additional loans.
         - Handles input clearing to prevent input stream issues.
+        - Hands off to runBatchMode when started with --batch,
+          to runScheduleToText when started with --schedule-to-text,
+          to runServeMode when started with --serve,
+          to runIngestMode when started with --ingest,
+          and to runExportMode when started with --export-schedules.
+        - Interactive input is checked with checkLoan (LoanTape.h): non-numeric input,
+          a non-positive amount or one above 1e12, a negative rate, or a term outside
+          1..100 years is reported
+          and the loan is asked for again; end of input ends the program.
 
     Simpler Terms:
         This is the main program that asks the user for loan info,
         shows the monthly payment and total payback,
         and asks if the user wants to process another loan.
  */
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--batch") {
+        return runBatchMode(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--schedule-to-text") {
+        return runScheduleToText(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--serve") {
+        return runServeMode(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--ingest") {
+        return runIngestMode(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--export-schedules") {
+        return runExportMode(argc, argv);
+    }
+
     char choice = 'y'; // User input to control whether to continue looping
 
     displayBanner("Mortgage Loan Calculator"); // Display program banner
@@ -64,6 +539,23 @@ int main() {
         cin >> years;
         loan.setTotalYearsToRepay(years); // Set total years for loan repayment
 
+        // Reject input that is not a number or not a sensible loan, then ask again
+        if (!cin) {
+            if (cin.eof()) {
+                break;
+            }
+            cerr << "ERROR: Invalid loan (" << loanCheckName(LoanCheck::Malformed)
+                 << "); please enter numbers only." << endl;
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            continue;
+        }
+        const LoanCheck check = checkLoan({ amount, rate, years, 0 });
+        if (check != LoanCheck::Valid) {
+            cerr << "ERROR: Invalid loan (" << loanCheckName(check) << "); please try again." << endl;
+            continue;
+        }
+
         cout << fixed << showpoint << setprecision(2); // Format monetary values with 2 decimals
 
         // Display the loan details and calculated payments